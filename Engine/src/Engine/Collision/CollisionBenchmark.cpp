@@ -0,0 +1,715 @@
+#include <enpch.hpp>
+#include "CollisionBenchmark.hpp"
+
+#include "Engine/Collision/CollisionWorld.hpp"
+
+#include <random>
+
+namespace rh {
+
+    using bench_clock = std::chrono::steady_clock;
+
+    static double ElapsedMicroseconds(bench_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count();
+    }
+
+    // Fill a square grid of unit cubes on the ground plane, with some height variation
+    static void BuildLevel(CollisionWorld& world, int numHulls, std::mt19937& rng) {
+        std::uniform_real_distribution<float> height(0.0f, 2.0f);
+
+        int side = (int)std::ceil(std::sqrt((float)numHulls));
+        for (int n = 0; n < numHulls; n++) {
+            float x = (float)(n % side) * 2.0f;
+            float z = (float)(n / side) * 2.0f;
+            world.CreateNewCubeHull(laml::Vec3(x, height(rng), z), 1.0f);
+        }
+    }
+
+    void RunCollisionBenchmark() {
+        const int levelSizes[] = { 100, 1000, 10000 };
+        const int numRays = 10000;
+        const int numCasts = 1000;
+
+        ENGINE_LOG_INFO("Collision benchmark: {0} raycasts, {1} shapecasts per level", numRays, numCasts);
+
+        for (int numHulls : levelSizes) {
+            std::mt19937 rng(1234);
+
+            CollisionWorld world;
+            BuildLevel(world, numHulls, rng);
+
+            float extent = std::ceil(std::sqrt((float)numHulls)) * 2.0f;
+            std::uniform_real_distribution<float> coord(0.0f, extent);
+            std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+
+            // short rays cast down onto the level, like ground checks
+            int hits = 0;
+            auto start = bench_clock::now();
+            for (int n = 0; n < numRays; n++) {
+                laml::Vec3 p(coord(rng), 5.0f, coord(rng));
+                laml::Vec3 q = p + laml::Vec3(offset(rng), -10.0f, offset(rng));
+                RaycastResult res = world.Raycast(p, q);
+                if (res.colliderID != 0)
+                    hits++;
+            }
+            double rayTime = ElapsedMicroseconds(start);
+
+            // a capsule swept through the level
+            UID_t capsule = world.CreateNewCapsule(laml::Vec3(0, 0, 0), 1.8f, 0.4f);
+            int contacts = 0;
+            world.Update(0.0);
+            start = bench_clock::now();
+            for (int n = 0; n < numCasts; n++) {
+                world.MoveHull(capsule, laml::Vec3(coord(rng), 2.5f, coord(rng)));
+                ShapecastResult_multi res = world.Shapecast_multi(capsule, laml::Vec3(offset(rng), -1.0f, offset(rng)));
+                contacts += res.numContacts;
+            }
+            double castTime = ElapsedMicroseconds(start);
+            world.Update(0.0);
+
+            const ShapecastStats& stats = world.GetShapecastStats();
+            ENGINE_LOG_INFO("  {0:>6} hulls (tree height {1:>2}): raycast {2:.3f} us [{3} hits], shapecast_multi {4:.3f} us [{5} contacts, {6} TOI solves, {7} skipped]",
+                numHulls, world.GetStaticTree().GetHeight(),
+                rayTime / numRays, hits, castTime / numCasts, contacts, stats.toiSolves, stats.toiSkipped);
+        }
+    }
+
+    // The per-face path CollisionWorld used before hulls cached their triangles
+    static int RaycastHullReference(CollisionHull& hull, const laml::Vec3& start, const laml::Vec3& d, float* out_t) {
+        int closest = -1;
+        laml::Scalar closest_t = 1.0f;
+
+        const auto& faces = hull.shape->faces;
+        for (int m = 0; m < faces.size(); m++) {
+            auto face = faces[m];
+            laml::Vec3 v0 = hull.GetVertWorldSpace(face.indices[0]);
+            laml::Vec3 v1 = hull.GetVertWorldSpace(face.indices[1]);
+            laml::Vec3 v2 = hull.GetVertWorldSpace(face.indices[2]);
+
+            laml::Vec3 normal = laml::normalize(laml::cross((v1 - v0), (v2 - v0)));
+
+            laml::Scalar t = laml::dot(v0 - start, normal) / laml::dot(d, normal);
+            if (t > closest_t || t < 0.0f)
+                continue;
+
+            laml::Vec3 Q = start + d * t;
+
+            laml::Vec3 norm = laml::cross(v1 - v0, v2 - v0);
+            float u = laml::dot(laml::cross(v1 - Q, v2 - Q), norm);
+            float v = laml::dot(laml::cross(v2 - Q, v0 - Q), norm);
+            float w = laml::dot(laml::cross(v0 - Q, v1 - Q), norm);
+
+            if (u >= 0.0f && v >= 0.0f && w >= 0.0f) {
+                closest = m;
+                closest_t = t;
+            }
+        }
+
+        *out_t = closest_t;
+        return closest;
+    }
+
+    void RunRayTriangleBenchmark() {
+        const int numTriangles[] = { 12, 64, 256 };
+        const int numRays = 100000;
+
+        ENGINE_LOG_INFO("Ray-triangle benchmark: {0} rays, {1}-wide kernel", numRays, RAY_TRIANGLE_WIDTH);
+
+        for (int count : numTriangles) {
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+
+            // triangle soup in a unit box
+            std::vector<laml::Vec3> vertices(count * 3);
+            std::vector<CollisionTriangle> faces(count);
+            for (int n = 0; n < count; n++) {
+                for (int k = 0; k < 3; k++) {
+                    vertices[n * 3 + k] = laml::Vec3(coord(rng), coord(rng), coord(rng));
+                }
+                faces[n] = CollisionTriangle(n * 3 + 0, n * 3 + 1, n * 3 + 2);
+            }
+            CollisionHull hull(std::make_shared<CollisionShape>(vertices, faces), laml::Vec3(0.5f, 0.25f, -0.5f));
+
+            std::vector<laml::Vec3> starts(numRays), dirs(numRays);
+            for (int n = 0; n < numRays; n++) {
+                starts[n] = laml::Vec3(coord(rng), coord(rng), coord(rng)) * 4.0f;
+                dirs[n] = hull.position - starts[n] + laml::Vec3(coord(rng), coord(rng), coord(rng));
+            }
+
+            int refHits = 0, scalarHits = 0, simdHits = 0, mismatches = 0, kernelMismatches = 0;
+            std::vector<int> refTri(numRays), scalarTri(numRays);
+            float t;
+
+            auto start = bench_clock::now();
+            for (int n = 0; n < numRays; n++) {
+                refTri[n] = RaycastHullReference(hull, starts[n], dirs[n], &t);
+                refHits += refTri[n] >= 0;
+            }
+            double refTime = ElapsedMicroseconds(start);
+
+            const TriangleSoA& tris = hull.GetWorldTriangles();
+
+            start = bench_clock::now();
+            for (int n = 0; n < numRays; n++) {
+                scalarTri[n] = RaycastTriangles_Scalar(tris, starts[n], dirs[n], 1.0f, &t);
+                scalarHits += scalarTri[n] >= 0;
+            }
+            double scalarTime = ElapsedMicroseconds(start);
+
+            start = bench_clock::now();
+            for (int n = 0; n < numRays; n++) {
+                int tri = RaycastTriangles(tris, starts[n], dirs[n], 1.0f, &t);
+                simdHits += tri >= 0;
+                mismatches += (tri != refTri[n]);
+                kernelMismatches += (tri != scalarTri[n]);
+            }
+            double simdTime = ElapsedMicroseconds(start);
+
+            ENGINE_LOG_INFO("  {0:>4} tris: reference {1:.3f} us, SoA scalar {2:.3f} us, SoA simd {3:.3f} us  [hits {4}/{5}/{6}, {7} differ from reference, {8} simd differ from scalar]",
+                count, refTime / numRays, scalarTime / numRays, simdTime / numRays,
+                refHits, scalarHits, simdHits, mismatches, kernelMismatches);
+        }
+
+        // the same triangle at several indices, in different lanes and blocks,
+        // is hit at exactly the same t. both kernels have to report the lowest index
+        TriangleSoA tris;
+        tris.Resize(24);
+        for (int n = 0; n < tris.count; n++) {
+            laml::Vec3 offset((float)n * 10.0f, 0.0f, 0.0f);
+            tris.Set(n, offset + laml::Vec3(-1, -1, 0), offset + laml::Vec3(1, -1, 0), offset + laml::Vec3(0, 1, 0));
+        }
+        const int copies[] = { 5, 13, 19, 6 };
+        for (int index : copies) {
+            tris.Set(index, laml::Vec3(-1, -1, 0), laml::Vec3(1, -1, 0), laml::Vec3(0, 1, 0));
+        }
+        laml::Vec3 start(0.0f, 0.0f, -1.0f), d(0.0f, 0.0f, 2.0f);
+        float scalar_t = 0.0f, simd_t = 0.0f;
+        int scalarTie = RaycastTriangles_Scalar(tris, start, d, 1.0f, &scalar_t);
+        int simdTie = RaycastTriangles(tris, start, d, 1.0f, &simd_t);
+        ENGINE_LOG_INFO("  tie of triangles 0, 5, 6, 13, 19: scalar picks {0}, simd picks {1}", scalarTie, simdTie);
+        ENGINE_LOG_ASSERT(scalarTie == 0 && simdTie == 0, "ray-triangle ties have to go to the lowest index");
+    }
+
+    static bool SameResult(const RaycastResult& a, const RaycastResult& b) {
+        return a.t == b.t && a.colliderID == b.colliderID &&
+            memcmp(&a.contactPoint, &b.contactPoint, sizeof(laml::Vec3)) == 0 &&
+            memcmp(&a.normal, &b.normal, sizeof(laml::Vec3)) == 0;
+    }
+
+    void RunRaycastBatchBenchmark() {
+        const int numHulls = 10000;
+        const int numRays = 50000;
+
+        std::mt19937 rng(1234);
+        CollisionWorld world;
+        BuildLevel(world, numHulls, rng);
+
+        float extent = std::ceil(std::sqrt((float)numHulls)) * 2.0f;
+        std::uniform_real_distribution<float> coord(0.0f, extent);
+        std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+
+        std::vector<Ray> rays(numRays);
+        for (auto& ray : rays) {
+            ray.start = laml::Vec3(coord(rng), 5.0f, coord(rng));
+            ray.end = ray.start + laml::Vec3(offset(rng), -10.0f, offset(rng));
+        }
+
+        std::vector<RaycastResult> expected(numRays);
+        auto start = bench_clock::now();
+        for (int n = 0; n < numRays; n++) {
+            expected[n] = world.Raycast(rays[n].start, rays[n].end);
+        }
+        double singleTime = ElapsedMicroseconds(start);
+
+        ENGINE_LOG_INFO("Raycast batch benchmark: {0} rays, {1} hulls", numRays, numHulls);
+        ENGINE_LOG_INFO("  one at a time: {0:.1f} rays/ms", numRays / (singleTime / 1000.0));
+
+        int maxThreads = (int)std::thread::hardware_concurrency();
+        if (maxThreads <= 0)
+            maxThreads = 1;
+
+        std::vector<RaycastResult> results(numRays);
+        for (int threads = 1; ; threads *= 2) {
+            if (threads > maxThreads)
+                threads = maxThreads;
+
+            world.SetNumWorkerThreads(threads);
+
+            start = bench_clock::now();
+            world.RaycastBatch(rays.data(), results.data(), rays.size());
+            double batchTime = ElapsedMicroseconds(start);
+
+            int mismatches = 0;
+            for (int n = 0; n < numRays; n++) {
+                mismatches += !SameResult(results[n], expected[n]);
+            }
+
+            ENGINE_LOG_INFO("  batch, {0:>2} threads: {1:.1f} rays/ms  [{2} differ from Raycast]",
+                threads, numRays / (batchTime / 1000.0), mismatches);
+
+            if (threads == maxThreads)
+                break;
+        }
+    }
+
+    // UV sphere, rings * segments + 2 vertices
+    static void BuildSphere(int rings, int segments, float radius,
+        std::vector<laml::Vec3>& vertices, std::vector<CollisionTriangle>& faces) {
+        const float pi = 3.14159265f;
+
+        vertices.clear();
+        faces.clear();
+
+        vertices.push_back(laml::Vec3(0, radius, 0));
+        for (int r = 0; r < rings; r++) {
+            float phi = pi * (float)(r + 1) / (float)(rings + 1);
+            for (int s = 0; s < segments; s++) {
+                float theta = 2.0f * pi * (float)s / (float)segments;
+                vertices.push_back(laml::Vec3(
+                    radius * std::sin(phi) * std::cos(theta),
+                    radius * std::cos(phi),
+                    radius * std::sin(phi) * std::sin(theta)));
+            }
+        }
+        vertices.push_back(laml::Vec3(0, -radius, 0));
+
+        u16 bottom = (u16)(vertices.size() - 1);
+        for (int s = 0; s < segments; s++) {
+            u16 next = (u16)((s + 1) % segments);
+            faces.push_back(CollisionTriangle(0, 1 + next, 1 + s));
+            faces.push_back(CollisionTriangle(bottom, 1 + (rings - 1) * segments + s, 1 + (rings - 1) * segments + next));
+        }
+        for (int r = 0; r < rings - 1; r++) {
+            for (int s = 0; s < segments; s++) {
+                u16 a = (u16)(1 + r * segments + s);
+                u16 b = (u16)(1 + r * segments + (s + 1) % segments);
+                u16 c = (u16)(a + segments);
+                u16 d = (u16)(b + segments);
+                faces.push_back(CollisionTriangle(a, b, c));
+                faces.push_back(CollisionTriangle(b, d, c));
+            }
+        }
+    }
+
+    void RunSupportBenchmark() {
+        const int sizes[] = { 8, 16, 32, 64 };
+        const int numQueries = 100000;
+
+        ENGINE_LOG_INFO("Support benchmark: {0} slowly rotating search directions", numQueries);
+
+        for (int size : sizes) {
+            std::vector<laml::Vec3> vertices;
+            std::vector<CollisionTriangle> faces;
+            BuildSphere(size, size, 1.0f, vertices, faces);
+
+            CollisionHull hull(std::make_shared<CollisionShape>(vertices, faces), laml::Vec3(0.0f, 0.0f, 0.0f));
+
+            // directions sweep around like they do between GJK iterations
+            std::vector<laml::Vec3> dirs(numQueries);
+            for (int n = 0; n < numQueries; n++) {
+                float a = (float)n * 0.01f;
+                dirs[n] = laml::Vec3(std::cos(a), std::sin(a * 0.37f), std::sin(a));
+            }
+
+            std::vector<int> brute(numQueries);
+            auto start = bench_clock::now();
+            for (int n = 0; n < numQueries; n++) {
+                brute[n] = hull.GetSupport(dirs[n]);
+            }
+            double bruteTime = ElapsedMicroseconds(start);
+
+            int mismatches = 0;
+            int last = 0;
+            start = bench_clock::now();
+            for (int n = 0; n < numQueries; n++) {
+                last = hull.GetSupport(dirs[n], last);
+                mismatches += laml::dot(vertices[last], dirs[n]) < laml::dot(vertices[brute[n]], dirs[n]);
+            }
+            double climbTime = ElapsedMicroseconds(start);
+
+            ENGINE_LOG_INFO("  {0:>4} verts: brute force {1:.4f} us, hill-climb {2:.4f} us  [{3} worse than brute force]",
+                vertices.size(), bruteTime / numQueries, climbTime / numQueries, mismatches);
+        }
+
+        // the same sphere as a triangle soup, every face with its own three vertices.
+        // hill-climbing would get stuck on the first triangle, so it has to fall back to the scan
+        {
+            std::vector<laml::Vec3> welded, soup;
+            std::vector<CollisionTriangle> faces, soupFaces;
+            BuildSphere(8, 8, 1.0f, welded, faces);
+            for (const auto& face : faces) {
+                u16 base = (u16)soup.size();
+                for (int k = 0; k < 3; k++) {
+                    soup.push_back(welded[face.indices[k]]);
+                }
+                soupFaces.push_back(CollisionTriangle(base, base + 1, base + 2));
+            }
+            CollisionShape shape(soup, soupFaces);
+
+            int mismatches = 0;
+            int last = 0;
+            for (int n = 0; n < numQueries; n++) {
+                float a = (float)n * 0.01f;
+                laml::Vec3 dir(std::cos(a), std::sin(a * 0.37f), std::sin(a));
+                last = shape.GetSupport(dir, last);
+                mismatches += laml::dot(soup[last], dir) < laml::dot(soup[shape.GetSupport(dir)], dir);
+            }
+            ENGINE_LOG_INFO("  {0:>4} verts, unwelded: adjacency {1}  [{2} worse than brute force]",
+                soup.size(), shape.HasAdjacency() ? "built" : "skipped", mismatches);
+        }
+
+        // whole time of impact queries against an imported-size hull
+        std::vector<laml::Vec3> vertices;
+        std::vector<CollisionTriangle> faces;
+        BuildSphere(32, 32, 2.0f, vertices, faces);
+
+        CollisionWorld world;
+        world.CreateNewConvexHull(laml::Vec3(0, 0, 0), vertices, faces);
+        UID_t capsule = world.CreateNewCapsule(laml::Vec3(0, 4, 0), 1.8f, 0.4f);
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+        int contacts = 0;
+        auto start = bench_clock::now();
+        for (int n = 0; n < 10000; n++) {
+            world.MoveHull(capsule, laml::Vec3(offset(rng), 4.0f, offset(rng)));
+            ShapecastResult res = world.Shapecast(capsule, laml::Vec3(offset(rng), -3.0f, offset(rng)));
+            contacts += res.TOI < 1.0f;
+        }
+        double castTime = ElapsedMicroseconds(start);
+
+        ENGINE_LOG_INFO("  shapecast vs {0} vertex hull: {1:.3f} us [{2} hits]", vertices.size(), castTime / 10000, contacts);
+    }
+
+    static double MeanIterations(const GJKCacheStats& stats) {
+        u64 calls = 0, total = 0;
+        for (int n = 0; n <= gjk_Output::e_maxSimplices; n++) {
+            calls += stats.iterations[n];
+            total += stats.iterations[n] * n;
+        }
+        return calls ? (double)total / (double)calls : 0.0;
+    }
+
+    // GJK iterations for one capsule/sphere pair stepped along a path, with the
+    // pair cache carried between calls (warm) and started over each call (cold)
+    static void CheckGJKWarmStart() {
+        std::vector<laml::Vec3> vertices;
+        std::vector<CollisionTriangle> faces;
+        BuildSphere(16, 16, 1.0f, vertices, faces);
+
+        CollisionWorld world;
+        UID_t sphere = world.CreateNewConvexHull(laml::Vec3(0, 0, 0), vertices, faces);
+        UID_t capsule = world.CreateNewCapsule(laml::Vec3(3, 0, 0), 1.8f, 0.4f);
+
+        gjk_Cache warm;
+        int coldIterations = 0, warmIterations = 0, mismatches = 0;
+        for (int step = 0; step < 200; step++) {
+            float a = (float)step * 0.02f;
+            world.MoveHull(capsule, laml::Vec3(3.0f * std::cos(a), 0.5f * std::sin(a * 0.5f), 3.0f * std::sin(a)));
+
+            gjk_Input input;
+            input.hull1 = world.m_dynamic.Get(capsule);
+            input.hull2 = world.m_static.Get(sphere);
+
+            gjk_Output coldOut, warmOut;
+            world.GJK(&coldOut, input);
+            input.cache = &warm;
+            world.GJK(&warmOut, input);
+
+            coldIterations += coldOut.iterations;
+            warmIterations += warmOut.iterations;
+            mismatches += std::abs(coldOut.distance - warmOut.distance) > 1.0e-3f;
+        }
+
+        // as if the shapes had changed: the cached simplex can't be used, only the axis
+        gjk_Cache stale = warm;
+        for (int i = 0; i < stale.count; i++) {
+            stale.index1[i] = 1 << 20;
+        }
+        gjk_Input input;
+        input.hull1 = world.m_dynamic.Get(capsule);
+        input.hull2 = world.m_static.Get(sphere);
+        gjk_Output coldOut, seededOut;
+        world.GJK(&coldOut, input);
+        input.cache = &stale;
+        world.GJK(&seededOut, input);
+        mismatches += std::abs(coldOut.distance - seededOut.distance) > 1.0e-3f;
+
+        ENGINE_LOG_INFO("  one pair over 200 steps: cold {0} GJK iterations, warm {1}, dropped simplex seeded from the axis {2} vs cold {3}  [{4} distances differ]",
+            coldIterations, warmIterations, seededOut.iterations, coldOut.iterations, mismatches);
+        ENGINE_LOG_ASSERT(warmIterations < coldIterations && seededOut.iterations <= coldOut.iterations && mismatches == 0,
+            "warm GJK has to take fewer iterations than cold, and find the same distance");
+    }
+
+    void RunGJKCacheBenchmark() {
+        const int numFrames = 2000;
+
+        std::mt19937 rng(1234);
+        CollisionWorld world;
+        BuildLevel(world, 400, rng);
+
+        ENGINE_LOG_INFO("GJK cache benchmark: capsule walking over 400 hulls for {0} frames", numFrames);
+
+        for (int pass = 0; pass < 2; pass++) {
+            bool cached = (pass == 1);
+
+            UID_t capsule = world.CreateNewCapsule(laml::Vec3(1, 2.5f, 1), 1.8f, 0.4f);
+            world.ClearGJKCache();
+            world.ResetGJKCacheStats();
+
+            laml::Vec3 position(1, 2.5f, 1);
+            auto start = bench_clock::now();
+            for (int frame = 0; frame < numFrames; frame++) {
+                if (!cached)
+                    world.ClearGJKCache();
+
+                // slow circle, like a player strafing around
+                float a = (float)frame * 0.01f;
+                laml::Vec3 vel(std::cos(a) * 0.05f, -0.3f, std::sin(a) * 0.05f);
+
+                world.MoveHull(capsule, position);
+                world.Shapecast_multi(capsule, vel);
+                position = position + laml::Vec3(vel.x, 0.0f, vel.z);
+            }
+            double time = ElapsedMicroseconds(start);
+
+            const GJKCacheStats& stats = world.GetGJKCacheStats();
+            ENGINE_LOG_INFO("  {0}: {1:.3f} us/frame, {2} hits, {3} misses, {4:.2f} mean GJK iterations",
+                cached ? "cached" : "cold  ", time / numFrames, stats.hits, stats.misses, MeanIterations(stats));
+
+            std::string histogram;
+            for (int n = 0; n <= gjk_Output::e_maxSimplices; n++) {
+                histogram += std::to_string(stats.iterations[n]) + " ";
+            }
+            ENGINE_LOG_INFO("    iterations histogram [0..{0}]: {1}", (int)gjk_Output::e_maxSimplices, histogram);
+
+            world.RemoveHull(capsule);
+        }
+
+        CheckGJKWarmStart();
+    }
+
+    // Walk numCharacters capsules around the level for numFrames steps, returns the time taken
+    static double SimulateCharacters(int numThreads, int numCharacters, int numFrames, std::vector<laml::Vec3>& out_positions) {
+        const float ts = 1.0f / 60.0f;
+
+        std::mt19937 rng(1234);
+        CollisionWorld world;
+        BuildLevel(world, 1000, rng);
+        world.SetNumWorkerThreads(numThreads);
+
+        // floor under the cubes so nobody falls out of the level
+        float extent = std::ceil(std::sqrt(1000.0f)) * 2.0f;
+        world.CreateNewCubeHull(laml::Vec3(extent * 0.5f, -1.0f, extent * 0.5f), extent + 4.0f, 1.0f, extent + 4.0f);
+        std::uniform_real_distribution<float> coord(0.0f, extent);
+        std::uniform_real_distribution<float> heading(0.0f, 6.2831853f);
+
+        std::vector<CharacterMotion> characters(numCharacters);
+        std::vector<float> headings(numCharacters);
+        for (int n = 0; n < numCharacters; n++) {
+            CharacterMotion& c = characters[n];
+            c.hullOffset = laml::Vec3(0.0f, 0.5f, 0.0f);
+            c.position = laml::Vec3(coord(rng), 4.0f, coord(rng));
+            c.floorUp = laml::Vec3(0.0f, 1.0f, 0.0f);
+            c.hullID = world.CreateNewCapsule(c.position + c.hullOffset, 1.8f, 0.4f);
+            headings[n] = heading(rng);
+        }
+
+        auto start = bench_clock::now();
+        for (int frame = 0; frame < numFrames; frame++) {
+            for (int n = 0; n < numCharacters; n++) {
+                CharacterMotion& c = characters[n];
+                float a = headings[n] + (float)frame * 0.02f;
+                laml::Vec3 walk(std::cos(a) * 3.0f, 0.0f, std::sin(a) * 3.0f);
+                if (c.grounded) {
+                    c.velocity = walk;
+                }
+                else {
+                    c.velocity = laml::Vec3(walk.x, c.velocity.y - 9.8f * ts, walk.z);
+                }
+            }
+
+            world.StepCharacters(characters.data(), characters.size(), ts);
+
+            // walk off ledges, like the player script's ground check
+            for (auto& c : characters) {
+                c.grounded = false;
+            }
+        }
+        double time = ElapsedMicroseconds(start);
+
+        out_positions.resize(numCharacters);
+        for (int n = 0; n < numCharacters; n++) {
+            out_positions[n] = characters[n].position;
+        }
+        return time;
+    }
+
+    void RunCharacterBenchmark() {
+        const int numCharacters = 256;
+        const int numFrames = 300;
+
+        ENGINE_LOG_INFO("Character benchmark: {0} capsules over 1000 hulls for {1} frames", numCharacters, numFrames);
+
+        // always check a few threads for determinism, even on small machines
+        int maxThreads = (int)std::thread::hardware_concurrency();
+        if (maxThreads < 4)
+            maxThreads = 4;
+
+        std::vector<laml::Vec3> expected, positions;
+        for (int threads = 1; ; threads *= 2) {
+            if (threads > maxThreads)
+                threads = maxThreads;
+
+            double time = SimulateCharacters(threads, numCharacters, numFrames, positions);
+
+            int mismatches = 0;
+            if (expected.empty()) {
+                expected = positions;
+            }
+            else {
+                for (int n = 0; n < numCharacters; n++) {
+                    mismatches += memcmp(&positions[n], &expected[n], sizeof(laml::Vec3)) != 0;
+                }
+            }
+
+            ENGINE_LOG_INFO("  {0:>2} threads: {1:.3f} us/frame  [{2} positions differ from 1 thread]",
+                threads, time / numFrames, mismatches);
+
+            if (threads == maxThreads)
+                break;
+        }
+    }
+
+    void RunFixedStepBenchmark() {
+        const int numCharacters = 64;
+        const int numFrames = 600;
+
+        // mostly 60-144 Hz, with a 250 ms hitch every 50 frames
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> jitter(1.0f / 144.0f, 1.0f / 60.0f);
+        std::vector<float> frameTimes(numFrames);
+        for (int frame = 0; frame < numFrames; frame++) {
+            frameTimes[frame] = (frame % 50 == 49) ? 0.25f : jitter(rng);
+        }
+
+        ENGINE_LOG_INFO("Fixed step benchmark: {0} characters, {1} frames with spikes", numCharacters, numFrames);
+
+        for (int pass = 0; pass < 2; pass++) {
+            bool fixed = (pass == 1);
+
+            CollisionWorld world;
+            world.CreateNewCubeHull(laml::Vec3(0.0f, -0.5f, 0.0f), 40.0f, 1.0f, 40.0f);
+
+            std::vector<CharacterMotion> characters(numCharacters);
+            for (int n = 0; n < numCharacters; n++) {
+                CharacterMotion& c = characters[n];
+                c.hullOffset = laml::Vec3(0.0f, 0.5f, 0.0f);
+                c.position = laml::Vec3((float)(n % 8) * 4.0f - 14.0f, 8.0f + (float)(n / 8), (float)(n / 8) * 4.0f - 14.0f);
+                c.floorUp = laml::Vec3(0.0f, 1.0f, 0.0f);
+                c.hullID = world.CreateNewCapsule(c.position + c.hullOffset, 1.8f, 0.4f);
+                if (fixed)
+                    world.AddCharacter(c);
+            }
+
+            double worst = 0.0, total = 0.0;
+            int maxSubsteps = 0;
+            for (int frame = 0; frame < numFrames; frame++) {
+                float dt = frameTimes[frame];
+
+                auto start = bench_clock::now();
+                if (fixed) {
+                    world.Update(dt);
+                    maxSubsteps = std::max(maxSubsteps, world.GetSubstepCount());
+                }
+                else {
+                    // what PlayerController did before: one step of the frame's dt
+                    for (auto& c : characters) {
+                        if (!c.grounded)
+                            c.velocity.y -= c.gravity * dt;
+                    }
+                    world.StepCharacters(characters.data(), characters.size(), dt);
+                }
+                double time = ElapsedMicroseconds(start);
+                total += time;
+                worst = std::max(worst, time);
+            }
+
+            int fellThrough = 0;
+            for (int n = 0; n < numCharacters; n++) {
+                const CharacterMotion* c = fixed ? world.GetCharacter(characters[n].hullID) : &characters[n];
+                fellThrough += c->position.y < -0.5f;
+            }
+
+            ENGINE_LOG_INFO("  {0}: {1:.1f} us/frame, worst {2:.1f} us, max {3} substeps  [{4} fell through the floor]",
+                fixed ? "fixed   " : "variable", total / numFrames, worst, maxSubsteps, fellThrough);
+        }
+    }
+
+    void RunSnapshotBenchmark() {
+        const int numHulls = 10000;
+        const int numCharacters = 64;
+        const int numRepeats = 1000;
+        const int numFrames = 120;
+
+        std::mt19937 rng(1234);
+        CollisionWorld world;
+        BuildLevel(world, numHulls, rng);
+
+        float extent = std::ceil(std::sqrt((float)numHulls)) * 2.0f;
+        std::uniform_real_distribution<float> coord(0.0f, extent);
+        for (int n = 0; n < numCharacters; n++) {
+            CharacterMotion c;
+            c.hullOffset = laml::Vec3(0.0f, 0.5f, 0.0f);
+            c.position = laml::Vec3(coord(rng), 4.0f, coord(rng));
+            c.floorUp = laml::Vec3(0.0f, 1.0f, 0.0f);
+            c.velocity = laml::Vec3(1.0f, 0.0f, 0.5f);
+            c.hullID = world.CreateNewCapsule(c.position + c.hullOffset, 1.8f, 0.4f);
+            world.AddCharacter(c);
+        }
+
+        ENGINE_LOG_INFO("Snapshot benchmark: {0} static hulls, {1} characters", numHulls, numCharacters);
+
+        CollisionSnapshot snapshot;
+        world.Snapshot(snapshot); // grow the buffers
+
+        auto start = bench_clock::now();
+        for (int n = 0; n < numRepeats; n++) {
+            world.Snapshot(snapshot);
+        }
+        double snapshotTime = ElapsedMicroseconds(start);
+
+        start = bench_clock::now();
+        for (int n = 0; n < numRepeats; n++) {
+            world.Restore(snapshot);
+        }
+        double restoreTime = ElapsedMicroseconds(start);
+
+        size_t bytes = (snapshot.staticTransforms.size() + snapshot.dynamicTransforms.size()) * sizeof(HullTransform) +
+            snapshot.characters.size() * sizeof(CharacterMotion);
+        ENGINE_LOG_INFO("  snapshot {0:.2f} us, restore {1:.2f} us  [{2} KB of transforms]",
+            snapshotTime / numRepeats, restoreTime / numRepeats, bytes / 1024);
+
+        // run forward, roll back, run the same frames again
+        std::vector<laml::Vec3> first(numCharacters);
+        for (int pass = 0; pass < 2; pass++) {
+            world.Restore(snapshot);
+            for (int frame = 0; frame < numFrames; frame++) {
+                world.Update(1.0 / 60.0);
+            }
+
+            int mismatches = 0;
+            for (int n = 0; n < numCharacters; n++) {
+                laml::Vec3 p = world.GetCharacter(snapshot.characters[n].hullID)->position;
+                if (pass == 0)
+                    first[n] = p;
+                else
+                    mismatches += memcmp(&p, &first[n], sizeof(laml::Vec3)) != 0;
+            }
+
+            if (pass == 1)
+                ENGINE_LOG_INFO("  replay of {0} frames after Restore: [{1} positions differ]", numFrames, mismatches);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef COLLISION_BENCHMARK_H
+#define COLLISION_BENCHMARK_H
+
+namespace rh {
+
+    /// Times CollisionWorld queries against levels of increasing size and
+    /// logs the per-query cost. Does not need a window or GL context.
+    void RunCollisionBenchmark();
+
+    /// Compares the SIMD ray-triangle kernel against the scalar paths
+    void RunRayTriangleBenchmark();
+
+    /// Raycast throughput of RaycastBatch as the worker count goes up
+    void RunRaycastBatchBenchmark();
+
+    /// Brute-force vs hill-climbing support queries on high-vertex hulls
+    void RunSupportBenchmark();
+
+    /// GJK iterations for a slowly walking capsule, with and without the pair cache,
+    /// and a check that a warm pair needs fewer iterations than a cold one
+    void RunGJKCacheBenchmark();
+
+    /// StepCharacters throughput as the worker count goes up, and a check that
+    /// every thread count ends with the same positions
+    void RunCharacterBenchmark();
+
+    /// Characters dropped on a floor under a jittery frame rate with spikes,
+    /// stepped once per frame vs through the fixed-timestep Update
+    void RunFixedStepBenchmark();
+
+    /// Snapshot/Restore cost at 10k hulls, and a rollback replay check
+    void RunSnapshotBenchmark();
+}
+
+#endif
@@ -3,13 +3,18 @@
 
 namespace rh {
 
-    CollisionHull::CollisionHull() :
-        m_hullID(getNextUID()),
-        m_radius(0.0f),
-        rotation(1.0f)
-    {}
+    CollisionShape::CollisionShape(const std::vector<laml::Vec3>& vertices, const std::vector<CollisionTriangle>& faces, float radius) :
+        vertices(vertices),
+        faces(faces),
+        radius(radius)
+    {
+        assert(!vertices.empty());
+        if (vertices.size() >= HILL_CLIMB_MIN_VERTS) {
+            BuildAdjacency();
+        }
+    }
 
-    int CollisionHull::GetSupport(laml::Vec3 search_dir) {
+    int CollisionShape::GetSupport(const laml::Vec3& search_dir) const {
         /* This ALL happens inside model space */
         laml::Scalar maxDist = laml::dot(vertices[0], search_dir);
         int maxIndex = 0;
@@ -27,60 +32,191 @@ namespace rh {
         return maxIndex;
     }
 
-    laml::Vec3 CollisionHull::GetVertWorldSpace(int index) {
-        laml::Vec3 local = vertices[index];
-        return laml::transform::transform_point(rotation, local) + position;
+    int CollisionShape::GetSupport(const laml::Vec3& search_dir, int start_vertex) const {
+        if (m_adjOffsets.empty() || vertices.size() < HILL_CLIMB_MIN_VERTS)
+            return GetSupport(search_dir);
+
+        if (start_vertex < 0 || start_vertex >= vertices.size())
+            start_vertex = 0;
+
+        // On a convex hull the first vertex with no better neighbour is the support point
+        int current = start_vertex;
+        laml::Scalar currentDist = laml::dot(vertices[current], search_dir);
+        for (int step = 0; step < vertices.size(); step++) {
+            int best = current;
+            laml::Scalar bestDist = currentDist;
+            for (u32 k = m_adjOffsets[current]; k < m_adjOffsets[current + 1]; k++) {
+                int n = m_adjacency[k];
+                laml::Scalar dist = laml::dot(vertices[n], search_dir);
+                if (dist > bestDist) {
+                    bestDist = dist;
+                    best = n;
+                }
+            }
+
+            if (best == current)
+                break;
+
+            current = best;
+            currentDist = bestDist;
+        }
+
+        return current;
+    }
+
+    void CollisionShape::BuildAdjacency() {
+        // every triangle edge, in both directions
+        std::vector<std::pair<u16, u16>> edges;
+        edges.reserve(faces.size() * 6);
+        for (const auto& face : faces) {
+            for (int k = 0; k < 3; k++) {
+                u16 a = face.indices[k];
+                u16 b = face.indices[(k + 1) % 3];
+                edges.push_back({ a, b });
+                edges.push_back({ b, a });
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        m_adjOffsets.assign(vertices.size() + 1, 0);
+        m_adjacency.resize(edges.size());
+        for (size_t n = 0; n < edges.size(); n++) {
+            m_adjOffsets[edges[n].first + 1]++;
+            m_adjacency[n] = edges[n].second;
+        }
+        for (size_t n = 0; n < vertices.size(); n++) {
+            m_adjOffsets[n + 1] += m_adjOffsets[n];
+        }
+
+        // Hill-climbing can stop at a local maximum on anything but one connected,
+        // welded hull: a vertex split along a seam only sees the neighbours on its
+        // side. Those shapes keep no adjacency and GetSupport scans every vertex.
+        if (!IsWeldedAndConnected()) {
+            ENGINE_LOG_WARN("Collision shape with {0} vertices is not welded and connected, hill-climbing disabled", vertices.size());
+            m_adjOffsets.clear();
+            m_adjacency.clear();
+        }
     }
 
-    void CollisionHull::bufferData() {
-        struct _vertex
-        {
-            laml::Vec3 Position;
+    bool CollisionShape::IsWeldedAndConnected() const {
+        // no two vertices at the same position
+        std::vector<u16> order(vertices.size());
+        for (size_t n = 0; n < order.size(); n++) {
+            order[n] = (u16)n;
+        }
+        auto less = [this](u16 a, u16 b) {
+            const laml::Vec3& va = vertices[a];
+            const laml::Vec3& vb = vertices[b];
+            if (va.x != vb.x) return va.x < vb.x;
+            if (va.y != vb.y) return va.y < vb.y;
+            return va.z < vb.z;
         };
+        std::sort(order.begin(), order.end(), less);
+        for (size_t n = 1; n < order.size(); n++) {
+            if (!less(order[n - 1], order[n]))
+                return false;
+        }
+
+        // every vertex reachable from vertex 0
+        std::vector<u8> visited(vertices.size(), 0);
+        std::vector<u16> stack;
+        stack.push_back(0);
+        visited[0] = 1;
+        size_t numVisited = 1;
+        while (!stack.empty()) {
+            u16 current = stack.back();
+            stack.pop_back();
+            for (u32 k = m_adjOffsets[current]; k < m_adjOffsets[current + 1]; k++) {
+                u16 n = m_adjacency[k];
+                if (!visited[n]) {
+                    visited[n] = 1;
+                    numVisited++;
+                    stack.push_back(n);
+                }
+            }
+        }
+        return numVisited == vertices.size();
+    }
+
+    CollisionHull::CollisionHull() :
+        m_hullID(0),
+        m_proxyID(NULL_NODE),
+        rotation(1.0f),
+        m_cachedRotation(1.0f),
+        m_cachedShape(nullptr),
+        m_aabbDirty(true),
+        m_trisDirty(true)
+    {}
+
+    CollisionHull::CollisionHull(const Ref<CollisionShape>& shape, const laml::Vec3& position) :
+        CollisionHull()
+    {
+        this->shape = shape;
+        this->position = position;
+    }
+
+    laml::Vec3 CollisionHull::GetVertWorldSpace(int index) const {
+        laml::Vec3 local = shape->vertices[index];
+        return laml::transform::transform_point(rotation, local) + position;
+    }
+
+    void CollisionHull::CheckTransform() {
+        bool moved = memcmp(&m_cachedPosition, &position, sizeof(laml::Vec3)) != 0 ||
+            memcmp(&m_cachedRotation, &rotation, sizeof(laml::Mat3)) != 0 ||
+            m_cachedShape != shape.get();
 
-        _vertex* data = reinterpret_cast<_vertex*>(vertices.data());
-        u16* _indices = reinterpret_cast<u16*>(faces.data());
-        u32* indices = (u32*)malloc(faces.size() * 3 * sizeof(u32));
-        for (int n = 0; n < faces.size() * 3; n++) {
-            indices[n] = _indices[n];
+        if (moved) {
+            m_cachedPosition = position;
+            m_cachedRotation = rotation;
+            m_cachedShape = shape.get();
+
+            m_aabbDirty = true;
+            m_trisDirty = true;
         }
+    }
+
+    const AABB& CollisionHull::GetWorldAABB() {
+        CheckTransform();
+
+        if (m_aabbDirty) {
+            laml::Vec3 v = GetVertWorldSpace(0);
+            AABB aabb(v, v);
+            for (int n = 1; n < shape->vertices.size(); n++) {
+                v = GetVertWorldSpace(n);
+                aabb.lowerBound = laml::Vec3(std::min(aabb.lowerBound.x, v.x), std::min(aabb.lowerBound.y, v.y), std::min(aabb.lowerBound.z, v.z));
+                aabb.upperBound = laml::Vec3(std::max(aabb.upperBound.x, v.x), std::max(aabb.upperBound.y, v.y), std::max(aabb.upperBound.z, v.z));
+            }
+
+            laml::Vec3 r(shape->radius, shape->radius, shape->radius);
+            aabb.lowerBound = aabb.lowerBound - r;
+            aabb.upperBound = aabb.upperBound + r;
 
-        auto vbo = rh::VertexBuffer::Create(data, vertices.size() * sizeof(_vertex));
-        vbo->SetLayout({
-            { rh::ShaderDataType::Float3, "a_Position" }
-            });
-        auto ebo = rh::IndexBuffer::Create(indices, faces.size() * 3);
-
-        wireframe = rh::VertexArray::Create();
-        wireframe->Bind();
-        wireframe->AddVertexBuffer(vbo);
-        wireframe->SetIndexBuffer(ebo);
-        wireframe->Unbind();
-
-        /*
-        glGenVertexArrays(1, &wireframeVAO);
-        glBindVertexArray(wireframeVAO);
-
-        GLuint vbo;
-        glGenBuffers(1, &vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, vertices.blockBytes, vertices.data, GL_STATIC_DRAW);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertices.m_elementSize, (void*)0);
-        glEnableVertexAttribArray(0);
-
-        GLuint ebo;
-        glGenBuffers(1, &ebo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, faces.blockBytes, faces.data, GL_STATIC_DRAW);
-
-        glEnableVertexAttribArray(0);
-        */
+            m_worldAABB = aabb;
+            m_aabbDirty = false;
+        }
+
+        return m_worldAABB;
     }
 
+    const TriangleSoA& CollisionHull::GetWorldTriangles() {
+        CheckTransform();
+
+        const auto& faces = shape->faces;
+        if (m_trisDirty || m_worldTris.count != (int)faces.size()) {
+            m_worldTris.Resize((int)faces.size());
+            for (int n = 0; n < faces.size(); n++) {
+                const auto& face = faces[n];
+                m_worldTris.Set(n,
+                    GetVertWorldSpace(face.indices[0]),
+                    GetVertWorldSpace(face.indices[1]),
+                    GetVertWorldSpace(face.indices[2]));
+            }
+
+            m_trisDirty = false;
+        }
 
-    UID_t CollisionHull::nextUID = 0;
-    UID_t CollisionHull::getNextUID() {
-        return ++nextUID; // starts at 1
+        return m_worldTris;
     }
 
 }
\ No newline at end of file
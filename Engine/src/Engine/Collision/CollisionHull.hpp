@@ -2,7 +2,11 @@
 #define COLLISION_HULL_H
 
 #include "Engine/Core/Base.hpp"
-#include "Engine/Renderer/VertexArray.hpp"
+#include "Engine/Collision/DynamicTree.hpp"
+#include "Engine/Collision/RayTriangle.hpp"
+
+// hulls smaller than this always use the brute-force support scan
+#define HILL_CLIMB_MIN_VERTS 32
 
 namespace rh {
     typedef u64 UID_t;
@@ -12,30 +16,80 @@ namespace rh {
         CollisionTriangle() : indices{ 0,0,0 } {}
         CollisionTriangle(u16 n1, u16 n2, u16 n3) : indices{ n1,n2,n3 } {}
     };
+    static_assert(sizeof(CollisionTriangle) == 3 * sizeof(u16), "Face lists get passed on as flat index arrays");
+
+    /// Local-space geometry of a hull. Immutable once built, and shared by every
+    /// hull that uses it, so copying a hull never copies vertices.
+    class CollisionShape {
+    public:
+        /// Builds vertex adjacency for hill-climbing if there are enough vertices
+        /// and the hull is welded and connected
+        CollisionShape(const std::vector<laml::Vec3>& vertices, const std::vector<CollisionTriangle>& faces, float radius = 0.0f);
+
+        int GetSupport(const laml::Vec3& search_dir) const;
+        /// Hill-climbs the vertex adjacency from start_vertex when it has been
+        /// built, otherwise scans every vertex. Only valid for convex hulls.
+        int GetSupport(const laml::Vec3& search_dir, int start_vertex) const;
+        bool HasAdjacency() const { return !m_adjOffsets.empty(); }
+
+        const std::vector<laml::Vec3> vertices;
+        const std::vector<CollisionTriangle> faces;
+        const float radius;
+
+    private:
+        void BuildAdjacency();
+        bool IsWeldedAndConnected() const;
+
+        // vertex n neighbours are m_adjacency[m_adjOffsets[n] .. m_adjOffsets[n+1]]
+        std::vector<u32> m_adjOffsets;
+        std::vector<u16> m_adjacency;
+    };
 
+    /// Placement of a hull, the only part of it that changes during a simulation
+    struct HullTransform {
+        laml::Vec3 position;
+        laml::Mat3 rotation;
+    };
+
+    /// One instance of a CollisionShape in a CollisionWorld
     class CollisionHull {
     public:
         CollisionHull();
+        CollisionHull(const Ref<CollisionShape>& shape, const laml::Vec3& position);
+
+        int GetSupport(const laml::Vec3& search_dir) const { return shape->GetSupport(search_dir); }
+        int GetSupport(const laml::Vec3& search_dir, int start_vertex) const { return shape->GetSupport(search_dir, start_vertex); }
+        laml::Vec3 GetVertWorldSpace(int index) const;
+        int GetNumVertices() const { return (int)shape->vertices.size(); }
+        float GetRadius() const { return shape->radius; }
 
-        int GetSupport(laml::Vec3 search_dir);
-        laml::Vec3 GetVertWorldSpace(int index);
+        /// World-space bounds of the hull, including the shape radius.
+        /// Cached, only rebuilt when the transform or shape change
+        const AABB& GetWorldAABB();
+
+        /// World-space triangles, only rebuilt when the transform or shape change
+        const TriangleSoA& GetWorldTriangles();
 
         laml::Vec3 position;
         laml::Mat3 rotation;
-        rh::Ref<rh::VertexArray> wireframe; // for visualizing
+        Ref<CollisionShape> shape;
+
+        UID_t m_hullID; // handle into the owning CollisionWorld, 0 until added
+        int m_proxyID; // node in the CollisionWorld broadphase
 
-        void bufferData();
+    private:
+        // Marks the world-space caches dirty if the hull moved since they were built
+        void CheckTransform();
 
-        std::vector<laml::Vec3> vertices;
-        std::vector<CollisionTriangle> faces;
-        float m_radius;
+        laml::Vec3 m_cachedPosition;
+        laml::Mat3 m_cachedRotation;
+        const CollisionShape* m_cachedShape;
 
-        const UID_t m_hullID;
+        AABB m_worldAABB;
+        bool m_aabbDirty;
 
-    private:
-        /// Get the next globally unique ID
-        static UID_t getNextUID();
-        static UID_t nextUID;
+        TriangleSoA m_worldTris;
+        bool m_trisDirty;
     };
 }
 
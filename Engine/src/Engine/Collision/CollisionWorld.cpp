@@ -3,12 +3,154 @@
 
 namespace rh {
 
-    CollisionWorld::CollisionWorld() {
+#define STATIC_HULL_TAG 1
+#define DYNAMIC_HULL_TAG 2
 
-    }
+    CollisionWorld::CollisionWorld() :
+        m_static(STATIC_HULL_TAG),
+        m_dynamic(DYNAMIC_HULL_TAG)
+    {}
 
     void CollisionWorld::Update(double dt) {
+        m_lastFrameStats = m_frameStats;
+        m_frameStats = ShapecastStats();
+
+        for (auto& character : m_characters) {
+            character.hitFloor = false;
+        }
+
+        // after a long frame, drop time instead of trying to catch up all of it
+        m_accumulator += dt;
+        double maxAccumulated = (double)m_fixedTimestep * m_maxSubsteps;
+        if (m_accumulator > maxAccumulated) {
+            m_accumulator = maxAccumulated;
+        }
+
+        m_lastSubsteps = 0;
+        while (m_accumulator >= m_fixedTimestep) {
+            StepSimulation(m_fixedTimestep);
+            m_accumulator -= m_fixedTimestep;
+            m_lastSubsteps++;
+        }
+    }
+
+    void CollisionWorld::SetFixedTimestep(float timestep, int maxSubsteps) {
+        assert(timestep > 0.0f && maxSubsteps > 0);
+        m_fixedTimestep = timestep;
+        m_maxSubsteps = maxSubsteps;
+        m_accumulator = 0.0;
+    }
+
+    void CollisionWorld::StepSimulation(float ts) {
+        for (auto& character : m_characters) {
+            character.previousPosition = character.position;
+
+            if (character.grounded) {
+                // Raycast down to see if there is anything beneath us
+                RaycastResult rc = Raycast(character.position + character.hullOffset, laml::Vec3(0.0f, -1.0f, 0.0f), character.groundProbe);
+
+                if (rc.colliderID == 0) {
+                    // no ground beneath me
+                    character.grounded = false;
+                    character.floorUp = laml::Vec3(0.0f, 1.0f, 0.0f);
+                    character.floorID = 0;
+                }
+                else {
+                    character.floorID = rc.colliderID;
+                }
+            }
+            else {
+                character.velocity.y -= character.gravity * ts;
+            }
+        }
+
+        StepCharacters(m_characters.data(), m_characters.size(), ts);
+    }
 
+    void CollisionWorld::AddCharacter(const CharacterMotion& character) {
+        assert(GetCharacter(character.hullID) == nullptr);
+        m_characters.push_back(character);
+        m_characters.back().previousPosition = character.position;
+    }
+
+    CharacterMotion* CollisionWorld::GetCharacter(UID_t hullID) {
+        for (auto& character : m_characters) {
+            if (character.hullID == hullID)
+                return &character;
+        }
+        return nullptr;
+    }
+
+    bool CollisionWorld::RemoveCharacter(UID_t hullID) {
+        for (size_t n = 0; n < m_characters.size(); n++) {
+            if (m_characters[n].hullID == hullID) {
+                // keep the rest in order, StepCharacters applies moves in array order
+                m_characters.erase(m_characters.begin() + n);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    laml::Vec3 CollisionWorld::GetInterpolatedPosition(UID_t hullID) {
+        CharacterMotion* character = GetCharacter(hullID);
+        if (character == nullptr)
+            return laml::Vec3(0.0f, 0.0f, 0.0f);
+
+        float alpha = GetInterpolationAlpha();
+        return character->previousPosition * (1.0f - alpha) + character->position * alpha;
+    }
+
+    static void GatherTransforms(const SlotMap<CollisionHull>& hulls, std::vector<HullTransform>& transforms) {
+        transforms.resize(hulls.size());
+        for (size_t n = 0; n < hulls.size(); n++) {
+            transforms[n].position = hulls[n].position;
+            transforms[n].rotation = hulls[n].rotation;
+        }
+    }
+
+    void CollisionWorld::Snapshot(CollisionSnapshot& snapshot) const {
+        snapshot.layoutVersion = m_layoutVersion;
+        GatherTransforms(m_static, snapshot.staticTransforms);
+        GatherTransforms(m_dynamic, snapshot.dynamicTransforms);
+        snapshot.characters = m_characters;
+        snapshot.accumulator = m_accumulator;
+    }
+
+    CollisionSnapshot CollisionWorld::Snapshot() const {
+        CollisionSnapshot snapshot;
+        Snapshot(snapshot);
+        return snapshot;
+    }
+
+    bool CollisionWorld::Restore(const CollisionSnapshot& snapshot) {
+        if (snapshot.layoutVersion != m_layoutVersion)
+            return false;
+        assert(snapshot.staticTransforms.size() == m_static.size());
+        assert(snapshot.dynamicTransforms.size() == m_dynamic.size());
+
+        // static hulls rarely move, only refit the ones that did
+        for (size_t n = 0; n < m_static.size(); n++) {
+            CollisionHull& hull = m_static[n];
+            const HullTransform& transform = snapshot.staticTransforms[n];
+            if (memcmp(&hull.position, &transform.position, sizeof(laml::Vec3)) != 0 ||
+                memcmp(&hull.rotation, &transform.rotation, sizeof(laml::Mat3)) != 0) {
+                MoveHull(hull.m_hullID, transform.position, transform.rotation);
+            }
+        }
+
+        for (size_t n = 0; n < m_dynamic.size(); n++) {
+            m_dynamic[n].position = snapshot.dynamicTransforms[n].position;
+            m_dynamic[n].rotation = snapshot.dynamicTransforms[n].rotation;
+        }
+
+        m_characters = snapshot.characters;
+        // cached simplices from the abandoned frames would warm start the replay
+        // differently, so start it cold. Keeps the tables, not their contents
+        for (auto& table : m_pairCache)
+            table.second.clear();
+        m_accumulator = snapshot.accumulator;
+        return true;
     }
 
     RaycastResult CollisionWorld::Raycast(laml::Vec3 start, laml::Vec3 direction, laml::Scalar distance) {
@@ -29,66 +171,14 @@ namespace rh {
         res.contactPoint = end;
         res.normal = laml::Vec3(0, 0, 0);
 
-        for (int n = 0; n < m_static.size(); n++) {
-            // Loop through every hull in the scene
-            auto hull = &m_static[n];
-
-            // only select the ones that close
-            laml::Vec3 toHull = hull->position - start;
-            if (laml::dot(toHull, d) < 0)
-                continue;
-
-            // loop through all the triangles in the hull
-            for (int m = 0; m < hull->faces.size(); m++) {
-                auto face = hull->faces[m];
-                laml::Vec3 v0 = hull->GetVertWorldSpace(face.indices[0]);
-                laml::Vec3 v1 = hull->GetVertWorldSpace(face.indices[1]);
-                laml::Vec3 v2 = hull->GetVertWorldSpace(face.indices[2]);
-
-                laml::Vec3 normal = laml::normalize(laml::cross((v1 - v0),(v2 - v0)));
-
-                laml::Scalar t = laml::dot(v0 - start,normal) / laml::dot(d,normal);
-                if (t > 1.0f || t < 0.0f) {
-                    // ray doesn't intersect the plane with t of [0,1]
-                    continue;
-                }
-
-                if (t > closest_t) {
-                    // there is a guaranteed intersect that is closer
-                    continue;
-                }
+        // Only test the hulls whose bounds the ray passes through
+        m_staticTree.RayCast(start, end, [&](int proxyId, float maxFraction) -> float {
+            auto hull = m_static.Get(m_staticTree.GetUserData(proxyId));
+            RaycastHull(hull, start, d, res);
 
-                laml::Vec3 Q = start + d * t; // point on the triangle's plane
-
-                // Compute signed triangle area.
-                laml::Vec3 norm = laml::cross(v1 - v0,v2 - v0);
-                laml::Vec3 n0   = laml::cross(v1 - Q,v2 - Q);
-                laml::Vec3 n1   = laml::cross(v2 - Q,v0 - Q);
-                laml::Vec3 n2   = laml::cross(v0 - Q,v1 - Q);
-
-                // Compute triangle barycentric coordinates (pre-division).
-                float u = laml::dot(n0,norm);
-                float v = laml::dot(n1,norm);
-                float w = laml::dot(n2,norm);
-                //float s = 1.0f / (u + v + w);
-                //u *= s;
-                //v *= s;
-                //w *= s;
-
-                if ((u >= 0.0f && v >= 0.0f && w >= 0.0f)) {
-                    // The ray intersects the triangle
-                    if (t < closest_t) {
-                        // this is the new closest t value
-                        res.t = t;
-                        res.colliderID = hull->m_hullID;
-                        res.contactPoint = Q;
-                        res.normal = normal;
-
-                        closest_t = t;
-                    }
-                }
-            }
-        }
+            // clip the ray to the closest hit so far
+            return res.t < maxFraction ? res.t : maxFraction;
+        });
 
         return res;
     }
@@ -107,197 +197,331 @@ namespace rh {
         res.normal = laml::Vec3(0, 0, 0);
 
         auto hull = this->getHullFromID(target);
-
-        // only select the ones that close
-        laml::Vec3 toHull = hull->position - start;
-        if (laml::dot(toHull,d) < 0)
+        if (hull == nullptr)
             return res;
 
-        // loop through all the triangles in the hull
-        for (int m = 0; m < hull->faces.size(); m++) {
-            auto face = hull->faces[m];
-            laml::Vec3 v0 = hull->GetVertWorldSpace(face.indices[0]);
-            laml::Vec3 v1 = hull->GetVertWorldSpace(face.indices[1]);
-            laml::Vec3 v2 = hull->GetVertWorldSpace(face.indices[2]);
+        RaycastHull(hull, start, d, res);
 
-            laml::Vec3 normal = laml::normalize(laml::cross(v1 - v0, v2 - v0));
+        return res;
+    }
 
-            laml::Scalar t = laml::dot(v0 - start,normal) / laml::dot(d,normal);
-            if (t > 1.0f || t < 0.0f) {
-                // ray doesn't intersect the plane with t of [0,1]
-                continue;
-            }
+    // Spread the lower 10 bits of x out to every third bit
+    static u32 ExpandBits(u32 x) {
+        x &= 0x000003FF;
+        x = (x | (x << 16)) & 0x030000FF;
+        x = (x | (x << 8))  & 0x0300F00F;
+        x = (x | (x << 4))  & 0x030C30C3;
+        x = (x | (x << 2))  & 0x09249249;
+        return x;
+    }
 
-            if (t > closest_t) {
-                // there is a guaranteed intersect that is closer
-                continue;
-            }
+    void CollisionWorld::RaycastBatch(const Ray* rays, RaycastResult* results, size_t count) {
+        if (count == 0)
+            return;
 
-            laml::Vec3 Q = start + d * t; // point on the triangle's plane
-
-            // Compute signed triangle area.
-            laml::Vec3 norm = laml::cross(v1 - v0,v2 - v0);
-            laml::Vec3 n0 = laml::cross(v1 - Q,v2 - Q);
-            laml::Vec3 n1 = laml::cross(v2 - Q,v0 - Q);
-            laml::Vec3 n2 = laml::cross(v0 - Q,v1 - Q);
-
-            // Compute triangle barycentric coordinates (pre-division).
-            float u = laml::dot(n0,norm);
-            float v = laml::dot(n1,norm);
-            float w = laml::dot(n2,norm);
-
-            if ((u >= 0.0f && v >= 0.0f && w >= 0.0f)) {
-                // The ray intersects the triangle
-                if (t < closest_t) {
-                    // this is the new closest t value
-                    res.t = t;
-                    res.colliderID = hull->m_hullID;
-                    res.contactPoint = Q;
-                    res.normal = normal;
-
-                    closest_t = t;
-                }
+        // Triangle caches are rebuilt lazily, do it here so the workers only read them
+        for (auto& hull : m_static) {
+            hull.GetWorldTriangles();
+        }
+
+        // Sort by direction octant, then by the Morton code of the start point,
+        // so neighbouring rays walk the same tree nodes and hulls.
+        laml::Vec3 lower = rays[0].start, upper = rays[0].start;
+        for (size_t n = 1; n < count; n++) {
+            const laml::Vec3& p = rays[n].start;
+            lower = laml::Vec3(std::min(lower.x, p.x), std::min(lower.y, p.y), std::min(lower.z, p.z));
+            upper = laml::Vec3(std::max(upper.x, p.x), std::max(upper.y, p.y), std::max(upper.z, p.z));
+        }
+        laml::Vec3 extent = upper - lower;
+        laml::Vec3 scale(
+            extent.x > 0.0f ? 1023.0f / extent.x : 0.0f,
+            extent.y > 0.0f ? 1023.0f / extent.y : 0.0f,
+            extent.z > 0.0f ? 1023.0f / extent.z : 0.0f);
+
+        // sort key in the upper 32 bits, ray index in the lower 32.
+        // key = [octant 3 bits][morton 29 bits]: the 30 bit morton code drops its lowest (z) bit
+        const int keyMortonBits = 29;
+        static_assert(3 + keyMortonBits <= 32, "octant and morton code have to fit in 32 bits");
+
+        m_batchOrder.resize(count);
+        for (size_t n = 0; n < count; n++) {
+            laml::Vec3 p = rays[n].start - lower;
+            laml::Vec3 d = rays[n].end - rays[n].start;
+
+            u32 morton = (ExpandBits((u32)(p.x * scale.x)) << 2) |
+                         (ExpandBits((u32)(p.y * scale.y)) << 1) |
+                          ExpandBits((u32)(p.z * scale.z));
+            u32 octant = (d.x < 0.0f ? 4 : 0) | (d.y < 0.0f ? 2 : 0) | (d.z < 0.0f ? 1 : 0);
+
+            u32 key = (octant << keyMortonBits) | (morton >> (30 - keyMortonBits));
+            m_batchOrder[n] = ((u64)key << 32) | (u64)n;
+        }
+        std::sort(m_batchOrder.begin(), m_batchOrder.end());
+
+        // each result only depends on its own ray, so the order can't change them
+        const u64* order = m_batchOrder.data();
+        GetWorkerPool().ParallelFor(count, 32, [&](size_t begin, size_t end) {
+            for (size_t n = begin; n < end; n++) {
+                u32 index = (u32)(order[n] & 0xFFFFFFFF);
+                results[index] = Raycast(rays[index].start, rays[index].end);
             }
+        });
+    }
+
+    void CollisionWorld::SetNumWorkerThreads(int numThreads) {
+        m_workers = std::make_shared<WorkerPool>(numThreads);
+    }
+
+    int CollisionWorld::GetNumWorkerThreads() {
+        return GetWorkerPool().GetNumThreads();
+    }
+
+    WorkerPool& CollisionWorld::GetWorkerPool() {
+        if (!m_workers) {
+            m_workers = std::make_shared<WorkerPool>();
         }
+        return *m_workers;
+    }
 
-        return res;
+    void CollisionWorld::RaycastHull(CollisionHull* hull, const laml::Vec3& start, const laml::Vec3& d, RaycastResult& res) {
+        laml::Scalar closest_t = res.t;
+
+        // only select the ones that close
+        laml::Vec3 toHull = hull->position - start;
+        if (laml::dot(toHull, d) < 0)
+            return;
+
+        const TriangleSoA& tris = hull->GetWorldTriangles();
+
+        float t;
+        int tri = RaycastTriangles(tris, start, d, closest_t < 1.0f ? closest_t : 1.0f, &t);
+        if (tri >= 0 && t < closest_t) {
+            // this is the new closest t value
+            res.t = t;
+            res.colliderID = hull->m_hullID;
+            res.contactPoint = start + d * t;
+            res.normal = laml::Vec3(tris.nx[tri], tris.ny[tri], tris.nz[tri]);
+        }
     }
 
     UID_t CollisionWorld::CreateNewCubeHull(laml::Vec3 position, laml::Scalar size) {
-        CollisionHull hull;
-
-        laml::Scalar halfSize = size / 2.0f;
-
-        // Box hull
-        hull.vertices.resize(8);
-        hull.vertices[0] = laml::Vec3(-halfSize, -halfSize, -halfSize);
-        hull.vertices[1] = laml::Vec3(-halfSize, -halfSize, halfSize);
-        hull.vertices[2] = laml::Vec3(halfSize, -halfSize, halfSize);
-        hull.vertices[3] = laml::Vec3(halfSize, -halfSize, -halfSize);
-
-        hull.vertices[4] = laml::Vec3(-halfSize, halfSize, -halfSize);
-        hull.vertices[5] = laml::Vec3(-halfSize, halfSize, halfSize);
-        hull.vertices[6] = laml::Vec3(halfSize, halfSize, halfSize);
-        hull.vertices[7] = laml::Vec3(halfSize, halfSize, -halfSize);
-
-        hull.faces.resize(12);
-        hull.faces[0] = CollisionTriangle(0, 1, 4);
-        hull.faces[1] = CollisionTriangle(4, 1, 5);
-        hull.faces[2] = CollisionTriangle(1, 2, 6);
-        hull.faces[3] = CollisionTriangle(1, 6, 5);
-        hull.faces[4] = CollisionTriangle(2, 3, 7);
-        hull.faces[5] = CollisionTriangle(2, 7, 6);
-
-        hull.faces[6] =  CollisionTriangle(3, 0, 4);
-        hull.faces[7] =  CollisionTriangle(3, 4, 7);
-        hull.faces[8] =  CollisionTriangle(0, 2, 1);
-        hull.faces[9] =  CollisionTriangle(0, 3, 2);
-        hull.faces[10] = CollisionTriangle(4, 5, 7);
-        hull.faces[11] = CollisionTriangle(7, 5, 6);
-
-        hull.bufferData();
-        hull.position = position;
-        m_static.push_back(hull);
-
-        return hull.m_hullID;
+        return CreateNewCubeHull(position, size, size, size);
     }
 
     UID_t CollisionWorld::CreateNewCubeHull(
         laml::Vec3 position, laml::Scalar xSize, laml::Scalar ySize, laml::Scalar zSize) {
-        CollisionHull hull;
-
-        laml::Scalar halfx = xSize / 2.0f;
-        laml::Scalar halfy = ySize / 2.0f;
-        laml::Scalar halfz = zSize / 2.0f;
-
-        // Box hull
-        hull.vertices.resize(8);
-        hull.vertices[0] = laml::Vec3(-halfx, -halfy, -halfz);
-        hull.vertices[1] = laml::Vec3(-halfx, -halfy, halfz);
-        hull.vertices[2] = laml::Vec3(halfx, -halfy, halfz);
-        hull.vertices[3] = laml::Vec3(halfx, -halfy, -halfz);
-
-        hull.vertices[4] = laml::Vec3(-halfx, halfy, -halfz);
-        hull.vertices[5] = laml::Vec3(-halfx, halfy, halfz);
-        hull.vertices[6] = laml::Vec3(halfx, halfy, halfz);
-        hull.vertices[7] = laml::Vec3(halfx, halfy, -halfz);
-
-        hull.faces.resize(12);
-        hull.faces[0] = CollisionTriangle(0, 1, 4);
-        hull.faces[1] = CollisionTriangle(4, 1, 5);
-        hull.faces[2] = CollisionTriangle(1, 2, 6);
-        hull.faces[3] = CollisionTriangle(1, 6, 5);
-        hull.faces[4] = CollisionTriangle(2, 3, 7);
-        hull.faces[5] = CollisionTriangle(2, 7, 6);
-
-        hull.faces[6] =  CollisionTriangle(3, 0, 4);
-        hull.faces[7] =  CollisionTriangle(3, 4, 7);
-        hull.faces[8] =  CollisionTriangle(0, 2, 1);
-        hull.faces[9] =  CollisionTriangle(0, 3, 2);
-        hull.faces[10] = CollisionTriangle(4, 5, 7);
-        hull.faces[11] = CollisionTriangle(7, 5, 6);
-
-        hull.bufferData();
-        hull.position = position;
-        m_static.push_back(hull);
-
-        return hull.m_hullID;
+        // boxes of the same size share one shape
+        Ref<CollisionShape>& shape = m_boxShapes[std::make_tuple(xSize, ySize, zSize)];
+        if (!shape) {
+            laml::Scalar halfx = xSize / 2.0f;
+            laml::Scalar halfy = ySize / 2.0f;
+            laml::Scalar halfz = zSize / 2.0f;
+
+            // Box hull
+            std::vector<laml::Vec3> vertices(8);
+            vertices[0] = laml::Vec3(-halfx, -halfy, -halfz);
+            vertices[1] = laml::Vec3(-halfx, -halfy, halfz);
+            vertices[2] = laml::Vec3(halfx, -halfy, halfz);
+            vertices[3] = laml::Vec3(halfx, -halfy, -halfz);
+
+            vertices[4] = laml::Vec3(-halfx, halfy, -halfz);
+            vertices[5] = laml::Vec3(-halfx, halfy, halfz);
+            vertices[6] = laml::Vec3(halfx, halfy, halfz);
+            vertices[7] = laml::Vec3(halfx, halfy, -halfz);
+
+            std::vector<CollisionTriangle> faces(12);
+            faces[0] = CollisionTriangle(0, 1, 4);
+            faces[1] = CollisionTriangle(4, 1, 5);
+            faces[2] = CollisionTriangle(1, 2, 6);
+            faces[3] = CollisionTriangle(1, 6, 5);
+            faces[4] = CollisionTriangle(2, 3, 7);
+            faces[5] = CollisionTriangle(2, 7, 6);
+
+            faces[6] =  CollisionTriangle(3, 0, 4);
+            faces[7] =  CollisionTriangle(3, 4, 7);
+            faces[8] =  CollisionTriangle(0, 2, 1);
+            faces[9] =  CollisionTriangle(0, 3, 2);
+            faces[10] = CollisionTriangle(4, 5, 7);
+            faces[11] = CollisionTriangle(7, 5, 6);
+
+            shape = std::make_shared<CollisionShape>(vertices, faces);
+        }
+
+        CollisionHull hull(shape, position);
+        return AddStaticHull(hull);
     }
 
     UID_t CollisionWorld::CreateNewCapsule(laml::Vec3 position, laml::Scalar height, laml::Scalar radius) {
-        CollisionHull hull;
+        Ref<CollisionShape>& shape = m_capsuleShapes[std::make_pair(height, radius)];
+        if (!shape) {
+            // Capsule Hull
+            std::vector<laml::Vec3> vertices(3);
+            vertices[0] = laml::Vec3(0, 0, 0);
+            vertices[1] = laml::Vec3(0, height / 2, 0); // to allow it to render more easily
+            vertices[2] = laml::Vec3(0, height, 0);
+
+            std::vector<CollisionTriangle> faces(1);
+            faces[0] = CollisionTriangle(0, 1, 2);
+
+            shape = std::make_shared<CollisionShape>(vertices, faces, radius);
+        }
+
+        CollisionHull hull(shape, position);
+        UID_t id = m_dynamic.Insert(hull);
+        m_dynamic.Get(id)->m_hullID = id;
+        m_layoutVersion++;
+        return id;
+    }
 
-        // Capsule Hull
-        hull.vertices.resize(3);
-        hull.vertices[0] = laml::Vec3(0, 0, 0);
-        hull.vertices[1] = laml::Vec3(0, height / 2, 0); // to allow it to render more easily
-        hull.vertices[2] = laml::Vec3(0, height, 0);
+    UID_t CollisionWorld::CreateNewConvexHull(laml::Vec3 position, const std::vector<laml::Vec3>& vertices, const std::vector<CollisionTriangle>& faces) {
+        return CreateNewConvexHull(position, std::make_shared<CollisionShape>(vertices, faces));
+    }
 
-        hull.faces.resize(1);
-        hull.faces[0] = CollisionTriangle(0, 1, 2);
+    UID_t CollisionWorld::CreateNewConvexHull(laml::Vec3 position, const Ref<CollisionShape>& shape) {
+        CollisionHull hull(shape, position);
+        return AddStaticHull(hull);
+    }
 
-        hull.bufferData();
-        hull.position = position;
-        hull.m_radius = radius;
-        m_dynamic.push_back(hull);
+    UID_t CollisionWorld::AddStaticHull(CollisionHull& hull) {
+        UID_t id = m_static.Insert(hull);
 
-        return hull.m_hullID;
+        CollisionHull* added = m_static.Get(id);
+        added->m_hullID = id;
+        added->m_proxyID = m_staticTree.CreateProxy(added->GetWorldAABB(), id);
+        m_layoutVersion++;
+        return id;
     }
 
     CollisionHull* CollisionWorld::getHullFromID(UID_t id) {
-        for (int n = 0; n < m_static.size(); n++) {
-            auto hull = &m_static[n];
-            if (hull->m_hullID == id)
-                return hull;
-        }
-        for (int n = 0; n < m_dynamic.size(); n++) {
-            auto hull = &m_dynamic[n];
-            if (hull->m_hullID == id)
-                return hull;
+        switch (SlotMap<CollisionHull>::GetTag(id)) {
+            case STATIC_HULL_TAG:  return m_static.Get(id);
+            case DYNAMIC_HULL_TAG: return m_dynamic.Get(id);
         }
+
         return nullptr;
     }
 
+    bool CollisionWorld::RemoveHull(UID_t id) {
+        CollisionHull* hull = getHullFromID(id);
+        if (hull == nullptr)
+            return false;
+
+        if (hull->m_proxyID != NULL_NODE) {
+            m_staticTree.DestroyProxy(hull->m_proxyID);
+        }
+        RemoveCharacter(id);
+        m_layoutVersion++;
+
+        if (SlotMap<CollisionHull>::GetTag(id) == DYNAMIC_HULL_TAG) {
+            m_pairCache.erase(id);
+        }
+        else {
+            for (auto& table : m_pairCache)
+                table.second.erase(id);
+        }
+
+        switch (SlotMap<CollisionHull>::GetTag(id)) {
+            case STATIC_HULL_TAG:  return m_static.Remove(id);
+            case DYNAMIC_HULL_TAG: return m_dynamic.Remove(id);
+        }
+
+        return false;
+    }
+
+    void CollisionWorld::MoveHull(UID_t id, const laml::Vec3& position) {
+        CollisionHull* hull = getHullFromID(id);
+        if (hull == nullptr)
+            return;
+
+        MoveHull(id, position, hull->rotation);
+    }
+
+    void CollisionWorld::MoveHull(UID_t id, const laml::Vec3& position, const laml::Mat3& rotation) {
+        CollisionHull* hull = getHullFromID(id);
+        if (hull == nullptr)
+            return;
+
+        laml::Vec3 displacement = position - hull->position;
+        hull->position = position;
+        hull->rotation = rotation;
+
+        if (hull->m_proxyID != NULL_NODE) {
+            m_staticTree.MoveProxy(hull->m_proxyID, hull->GetWorldAABB(), displacement);
+        }
+    }
+
     ShapecastResult_multi CollisionWorld::Shapecast_multi(UID_t id, laml::Vec3 vel) {
-        ShapecastResult_multi res;
-        res.lowestTOI = 1;
-        res.numContacts = 0;
-        res.planes[0].TOI = 1e10;
         CollisionHull* hull1 = this->getHullFromID(id);
         if (hull1 == nullptr) {
+            ShapecastResult_multi res;
+            res.lowestTOI = 1;
+            res.numContacts = 0;
+            res.planes[0].TOI = 1e10;
             return res;
         }
 
-        for (int n = 0; n < m_static.size(); n++) {
-            CollisionHull* hull2 = &m_static[n];
+        ShapecastContext ctx = BeginShapecast(id);
+        ShapecastResult_multi res = Shapecast_multi(hull1, vel, ctx);
+        EndShapecast(ctx);
+        return res;
+    }
+
+    ShapecastResult CollisionWorld::Shapecast(UID_t id, laml::Vec3 vel) {
+        CollisionHull* hull1 = this->getHullFromID(id);
+        if (hull1 == nullptr) {
+            ShapecastResult res;
+            res.TOI = 1e10;
+            res.colliderID = 0;
+            return res;
+        }
+
+        ShapecastContext ctx = BeginShapecast(id);
+        ShapecastResult res = Shapecast(hull1, vel, ctx);
+        EndShapecast(ctx);
+        return res;
+    }
+
+    CollisionWorld::ShapecastContext CollisionWorld::BeginShapecast(UID_t id) {
+        ShapecastContext ctx;
+        ctx.pairCache = &m_pairCache[id];
+        return ctx;
+    }
+
+    void CollisionWorld::EndShapecast(const ShapecastContext& ctx) {
+        m_frameStats.toiSolves  += ctx.stats.toiSolves;
+        m_frameStats.toiSkipped += ctx.stats.toiSkipped;
+
+        m_gjkStats.hits   += ctx.gjkStats.hits;
+        m_gjkStats.misses += ctx.gjkStats.misses;
+        for (int n = 0; n <= gjk_Output::e_maxSimplices; n++)
+            m_gjkStats.iterations[n] += ctx.gjkStats.iterations[n];
+    }
+
+    ShapecastResult_multi CollisionWorld::Shapecast_multi(CollisionHull* hull1, const laml::Vec3& vel, ShapecastContext& ctx) {
+        ShapecastResult_multi res;
+        res.lowestTOI = 1;
+        res.numContacts = 0;
+        res.planes[0].TOI = 1e10;
+
+        // Only hulls that overlap the swept volume can be hit
+        AABB sweep = GetSweptAABB(hull1, vel);
+        m_staticTree.Query(sweep, [&](int proxyId) -> bool {
+            CollisionHull* hull2 = m_static.Get(m_staticTree.GetUserData(proxyId));
             if (hull1->m_hullID == hull2->m_hullID)
-                continue; // don't check against itself
+                return true; // don't check against itself
+
+            if (!SweptOverlap(hull1, vel, hull2)) {
+                ctx.stats.toiSkipped++;
+                return true;
+            }
+            ctx.stats.toiSolves++;
 
             int iters;
             ContactPlane plane;
             plane.colliderID = hull2->m_hullID;
             plane.TOI = TimeOfImpact(hull1, vel, hull2, laml::Vec3(),
-                &plane.contact_normal, &plane.contact_point, &iters);
+                &plane.contact_normal, &plane.contact_point, &iters,
+                GetPairCache(ctx, hull2->m_hullID), &ctx.gjkStats);
             bool placed = false;
             if (plane.TOI < 1) {
                 if (res.numContacts == 0) {
@@ -308,7 +532,8 @@ namespace rh {
                         if (plane.TOI < res.planes[n].TOI) {
                             // shift entire list back once
                             for (int m = res.numContacts - 1; m >= n; m--) {
-                                res.planes[m + 1] = res.planes[m];
+                                if (m + 1 < MAX_CONTACTS)
+                                    res.planes[m + 1] = res.planes[m];
                             }
 
                             // insert element at position n
@@ -318,7 +543,7 @@ namespace rh {
                         }
                     }
 
-                    if (!placed) {
+                    if (!placed && res.numContacts < MAX_CONTACTS) {
                         res.planes[res.numContacts] = plane;
                     }
                 }
@@ -328,30 +553,35 @@ namespace rh {
                     res.numContacts = MAX_CONTACTS;
                 }
             }
-        }
+            return true;
+        });
 
         return res;
     }
 
 
-    ShapecastResult CollisionWorld::Shapecast(UID_t id, laml::Vec3 vel) {
+    ShapecastResult CollisionWorld::Shapecast(CollisionHull* hull1, const laml::Vec3& vel, ShapecastContext& ctx) {
         ShapecastResult res;
         res.TOI = 1e10;
         res.colliderID = 0;
-        CollisionHull* hull1 = this->getHullFromID(id);
-        if (hull1 == nullptr) {
-            return res;
-        }
 
-        for (int n = 0; n < m_static.size(); n++) {
-            CollisionHull* hull2 = &m_static[n];
+        AABB sweep = GetSweptAABB(hull1, vel);
+        m_staticTree.Query(sweep, [&](int proxyId) -> bool {
+            CollisionHull* hull2 = m_static.Get(m_staticTree.GetUserData(proxyId));
             if (hull1->m_hullID == hull2->m_hullID)
-                continue; // don't check against itself
+                return true; // don't check against itself
+
+            if (!SweptOverlap(hull1, vel, hull2)) {
+                ctx.stats.toiSkipped++;
+                return true;
+            }
+            ctx.stats.toiSolves++;
 
             int iters;
             laml::Vec3 contact_normal, contact_point;
             float TOI = TimeOfImpact(hull1, vel, hull2, laml::Vec3(),
-                &contact_normal, &contact_point, &iters);
+                &contact_normal, &contact_point, &iters,
+                GetPairCache(ctx, hull2->m_hullID), &ctx.gjkStats);
 
             if (TOI < res.TOI) {
                 // This is a lower time of impact
@@ -361,21 +591,159 @@ namespace rh {
                 res.contact_point = contact_point;
                 res.iters = iters;
             }
-        }
+            return true;
+        });
 
         return res;
     }
 
 
+    void CollisionWorld::StepCharacters(CharacterMotion* characters, size_t count, float ts) {
+        if (count == 0)
+            return;
+
+        // Hull caches are rebuilt lazily and the pair tables are created on first
+        // use, do both here so the workers only read shared state
+        for (auto& hull : m_static) {
+            hull.GetWorldAABB();
+        }
+        m_characterContexts.resize(count);
+        for (size_t n = 0; n < count; n++) {
+            UID_t id = characters[n].hullID;
+            m_characterContexts[n] = m_dynamic.Contains(id) ? BeginShapecast(id) : ShapecastContext();
+        }
+
+        // each character only writes to itself, its own hull and its own context
+        GetWorkerPool().ParallelFor(count, 4, [&](size_t begin, size_t end) {
+            for (size_t n = begin; n < end; n++) {
+                ResolveCharacter(characters[n], ts, m_characterContexts[n]);
+            }
+        });
+
+        // apply in a fixed order so the tree ends up the same every run
+        for (size_t n = 0; n < count; n++) {
+            const CharacterMotion& character = characters[n];
+            MoveHull(character.hullID, character.position + character.hullOffset);
+            EndShapecast(m_characterContexts[n]);
+        }
+    }
+
+    void CollisionWorld::ResolveCharacter(CharacterMotion& character, float ts, ShapecastContext& ctx) {
+        using namespace laml;
+
+        character.iterations = 0;
+
+        CollisionHull* hull = m_dynamic.Get(character.hullID);
+        if (hull == nullptr) {
+            // Just use normal movement.
+            character.position = character.position + character.velocity * ts;
+            character.ghostPosition = character.position;
+            return;
+        }
+
+        Vec3& position = character.position;
+        Vec3& velocity = character.velocity;
+        ShapecastResult_multi res = Shapecast_multi(hull, velocity, ctx);
+
+        if (res.numContacts) {
+            Vec3 p_target = position + velocity * ts;
+            Vec3 p = p_target;
+            Vec3 p_start = position;
+            character.ghostPosition = position + (velocity*res.planes[0].TOI);
+
+            int iterations;
+            for (iterations = 0; iterations < 8; iterations++) {
+                float errorAcc = 0;
+                for (int n = 0; n < res.numContacts; n++) {
+                    auto plane = &res.planes[n];
+
+                    if (plane->TOI < ts) {
+                        Vec3 contactPoint = plane->contact_point;
+                        Vec3 contactNormal = plane->contact_normal;
+
+                        Vec3 p_t;
+                        if (n > 0) {
+                            p_t = p_start + velocity * (plane->TOI - res.planes[n - 1].TOI);
+                        }
+                        else {
+                            p_t = p_start + velocity * plane->TOI;
+                        }
+                        Vec3 body2contact = contactPoint - p_t;
+
+                        float s = dot((p + body2contact) - contactPoint, contactNormal);
+                        if (s < 0) {
+                            errorAcc -= s;
+
+                            p = p - (s - 1.0e-3f)*contactNormal;
+
+                            if (acos(dot(contactNormal, Vec3(0.0f, 1.0f, 0.0f))) < (character.floorAngleLimit * constants::deg2rad)) {
+                                character.grounded = true;
+                                velocity.y = 0;
+
+                                // this isn't the normal of the surface, 
+                                // so it might not be ideal for the floor normal
+                                character.floorUp = plane->contact_normal;
+                                character.floorID = plane->colliderID;
+                                character.hitFloor = true;
+                            }
+                        }
+                    }
+                }
+                float eps = 1e-9;
+                if (errorAcc < eps) {
+                    // We went through en entire iteration without moving 
+                    // the object, we can stop iterating now.
+                    break;
+                }
+                p_start = p;
+            }
+
+            character.iterations = iterations;
+            position = p;
+        }
+        else {
+            position = position + velocity * ts;
+            character.ghostPosition = position;
+        }
+    }
+
+    AABB CollisionWorld::GetSweptAABB(CollisionHull* hull, const laml::Vec3& vel) {
+        // bounds of the hull over the whole motion [0,1]
+        AABB start = hull->GetWorldAABB();
+        AABB end(start.lowerBound + vel, start.upperBound + vel);
+
+        AABB sweep;
+        sweep.Combine(start, end);
+        return sweep;
+    }
+
+    bool CollisionWorld::SweptOverlap(CollisionHull* hull, const laml::Vec3& vel, CollisionHull* target) {
+        const AABB& moving = hull->GetWorldAABB();
+        const AABB& bounds = target->GetWorldAABB();
+
+        // Grow the target by the moving box (plus the TOI feather radius),
+        // then the moving box's center sweeping through it is the same test.
+        laml::Vec3 extents = moving.GetExtents() + laml::Vec3(2.0e-3f, 2.0e-3f, 2.0e-3f);
+        AABB grown(bounds.lowerBound - extents, bounds.upperBound + extents);
+
+        float t;
+        return grown.IntersectsSegment(moving.GetCenter(), vel, 1.0f, &t);
+    }
+
     laml::Scalar CollisionWorld::TimeOfImpact(CollisionHull* hull1, laml::Vec3 vel1, CollisionHull* hull2, laml::Vec3 vel2,
-        laml::Vec3* out_normal, laml::Vec3* out_contact_point, int* out_iterations) {
+        laml::Vec3* out_normal, laml::Vec3* out_contact_point, int* out_iterations, gjk_Cache* cache, GJKCacheStats* stats) {
         assert(hull1 && hull2);
 
+        // without a persistent cache, still carry the simplex between steps
+        gjk_Cache local;
+        if (cache == nullptr)
+            cache = &local;
+
         float t = 0;
         laml::Vec3 a, b, n;
 
         float feather_radius = 1.0e-3f;
-        float d = StepGJK(t, hull1, vel1, hull2, vel2, &a, &b, feather_radius); //closest distance b/w hulls
+        float d = StepGJK(t, hull1, vel1, hull2, vel2, &a, &b, feather_radius, cache, stats); //closest distance b/w hulls
         laml::Vec3 v = vel2 - vel1;
 
         int iter = 0;
@@ -383,7 +751,7 @@ namespace rh {
         while (d > eps && t < 1) {
             ++iter;
             laml::Vec3 d_vec = laml::normalize(b - a);
-            float velocity_bound = abs(laml::dot(d_vec,v)); //should prob just check if positive
+            float velocity_bound = std::abs(laml::dot(d_vec,v)); //should prob just check if positive
             if (!velocity_bound) return 1; // moving perpendicular
 
             float delta = d / velocity_bound; // how far (in t units) hulls will move together.
@@ -393,10 +761,10 @@ namespace rh {
             if (t0 == t1) break;
             t = t1;
 
-            d = StepGJK(t, hull1, vel1, hull2, vel2, &a, &b, feather_radius);
+            d = StepGJK(t, hull1, vel1, hull2, vel2, &a, &b, feather_radius, cache, stats);
         }
 
-        d = StepGJK(t, hull1, vel1, hull2, vel2, &a, &b, 0);
+        d = StepGJK(t, hull1, vel1, hull2, vel2, &a, &b, 0, cache, stats);
         n = laml::normalize(a - b);
         t = t >= 1 ? 1 : t;
 
@@ -419,34 +787,28 @@ namespace rh {
         CollisionHull* hull1, laml::Vec3 vel1,
         CollisionHull* hull2, laml::Vec3 vel2,
         laml::Vec3* point1, laml::Vec3* point2,
-        float feather_radius) {
-
-        laml::Vec3 hull1Pos = hull1->position; //save for later
-        laml::Vec3 hull2Pos = hull2->position;
-        float radius = hull1->m_radius;
-
-        hull1->position = hull1->position + (vel1 * t); // move the object 't' along their velocities
-        hull2->position = hull2->position + (vel2 * t);
-
-        hull1->m_radius += feather_radius;
+        float feather_radius,
+        gjk_Cache* cache, GJKCacheStats* stats) {
 
         gjk_Input in;
         gjk_Output out;
 
         in.hull1 = hull1;
         in.hull2 = hull2;
+        in.cache = cache;
+
+        // move the object 't' along their velocities, without touching the hulls
+        in.offset1 = vel1 * t;
+        in.offset2 = vel2 * t;
+        in.feather_radius = feather_radius;
 
         GJK(&out, in);
         *point1 = out.point1;
         *point2 = out.point2;
 
-        if (out.m_hit) {
-            bool stopper = true;
-        }
-
-        hull1->position = hull1Pos; // reset to actual values
-        hull2->position = hull2Pos;
-        hull1->m_radius = radius;
+        if (stats == nullptr)
+            stats = &m_gjkStats;
+        stats->iterations[out.iterations]++;
 
         return out.distance;
     }
@@ -941,20 +1303,16 @@ namespace rh {
         CollisionHull* polygon1 = input.hull1;
         CollisionHull* polygon2 = input.hull2;
 
-        // Initialize the simplex.
+        // Initialize the simplex, from the cached one if there is one.
         Simplex simplex;
-        simplex.m_vertexA.index1 = 0;
-        simplex.m_vertexA.index2 = 0;
-        simplex.m_vertexA.point1 = polygon1->GetVertWorldSpace(0);
-        simplex.m_vertexA.point2 = polygon2->GetVertWorldSpace(0);
-        simplex.m_vertexA.point = simplex.m_vertexA.point2 - simplex.m_vertexA.point1;
-        simplex.m_vertexA.u = 1.0f;
-        simplex.m_vertexA.index1 = 0;
-        simplex.m_vertexA.index2 = 0;
-        simplex.m_count = 1;
+        ReadCache(&simplex, input);
         simplex.m_distance = 1e10; // large num
         simplex.m_hit = false;
 
+        // support searches hill-climb from the last support vertex
+        int last1 = simplex.m_vertexA.index1;
+        int last2 = simplex.m_vertexA.index2;
+
         // Begin recording the simplices for visualization.
         output->simplexCount = 0;
         output->m_hit = false;
@@ -1040,10 +1398,12 @@ namespace rh {
 
             // Compute a tentative new simplex vertex using support points.
             simplexVertex* vertex = vertices + simplex.m_count;
-            vertex->index1 = polygon1->GetSupport(laml::transform::transform_point(laml::transpose(polygon1->rotation), -d));
-            vertex->point1 = polygon1->GetVertWorldSpace(vertex->index1);
-            vertex->index2 = polygon2->GetSupport(laml::transform::transform_point(laml::transpose(polygon2->rotation), d));
-            vertex->point2 = polygon2->GetVertWorldSpace(vertex->index2);
+            vertex->index1 = polygon1->GetSupport(laml::transform::transform_point(laml::transpose(polygon1->rotation), -d), last1);
+            vertex->point1 = polygon1->GetVertWorldSpace(vertex->index1) + input.offset1;
+            vertex->index2 = polygon2->GetSupport(laml::transform::transform_point(laml::transpose(polygon2->rotation), d), last2);
+            vertex->point2 = polygon2->GetVertWorldSpace(vertex->index2) + input.offset2;
+            last1 = vertex->index1;
+            last2 = vertex->index2;
             vertex->point = vertex->point2 - vertex->point1;
 
             // Iteration count is equated to the number of support point calls.
@@ -1072,11 +1432,118 @@ namespace rh {
         }
 
         // Prepare output.
-        simplex.GetWitnessPoints(&output->point1, &output->point2, polygon1->m_radius, polygon2->m_radius);
+        simplex.GetWitnessPoints(&output->point1, &output->point2, polygon1->GetRadius() + input.feather_radius, polygon2->GetRadius());
         output->distance = laml::length(output->point1 - output->point2);
         output->iterations = iter;
         output->m_term = term;
         output->m_hit = simplex.m_hit;
+
+        if (input.cache) {
+            WriteCache(simplex, input.cache, output->point1, output->point2);
+        }
+    }
+
+    void CollisionWorld::ReadCache(Simplex* simplex, const gjk_Input& input) {
+        simplexVertex* vertices = &simplex->m_vertexA;
+        const gjk_Cache* cache = input.cache;
+        CollisionHull* hull1 = input.hull1;
+        CollisionHull* hull2 = input.hull2;
+
+        int count = cache ? cache->count : 0;
+        for (int i = 0; i < count; i++) {
+            if (cache->index1[i] >= hull1->GetNumVertices() || cache->index2[i] >= hull2->GetNumVertices()) {
+                count = 0; // hull has changed shape
+                break;
+            }
+
+            simplexVertex* v = vertices + i;
+            v->index1 = cache->index1[i];
+            v->index2 = cache->index2[i];
+            v->point1 = hull1->GetVertWorldSpace(v->index1) + input.offset1;
+            v->point2 = hull2->GetVertWorldSpace(v->index2) + input.offset2;
+            v->point = v->point2 - v->point1;
+            v->u = 1.0f / (float)count;
+        }
+
+        // The hulls have moved since the cache was written, so the old simplex
+        // can have collapsed. The solvers divide by its size.
+        if (count > 1) {
+            const float eps = 1.0e-6f;
+            laml::Vec3 A = vertices[0].point;
+            bool degenerate = false;
+            switch (count) {
+            case 2: degenerate = laml::length_sq(vertices[1].point - A) < eps; break;
+            case 3: degenerate = laml::length_sq(laml::cross(vertices[1].point - A, vertices[2].point - A)) < eps; break;
+            case 4: degenerate = std::abs(laml::dot(laml::cross(vertices[1].point - A, vertices[2].point - A), vertices[3].point - A)) < eps; break;
+            }
+            if (degenerate)
+                count = 1;
+        }
+
+        if (cache && cache->hasAxis && count < cache->count) {
+            // The cached simplex had to be dropped or collapsed, but the pair was
+            // separated along cache->axis last time: start from the support points
+            // along it instead of an arbitrary vertex. Same directions as a GJK
+            // iteration searching along -axis
+            simplexVertex* v = &simplex->m_vertexA;
+            int hint1 = count ? v->index1 : 0;
+            int hint2 = count ? v->index2 : 0;
+            v->index1 = hull1->GetSupport(laml::transform::transform_point(laml::transpose(hull1->rotation), cache->axis), hint1);
+            v->index2 = hull2->GetSupport(laml::transform::transform_point(laml::transpose(hull2->rotation), -cache->axis), hint2);
+            v->point1 = hull1->GetVertWorldSpace(v->index1) + input.offset1;
+            v->point2 = hull2->GetVertWorldSpace(v->index2) + input.offset2;
+            v->point = v->point2 - v->point1;
+            count = 1;
+        }
+        if (count == 0) {
+            // cold start
+            simplex->m_vertexA.index1 = 0;
+            simplex->m_vertexA.index2 = 0;
+            simplex->m_vertexA.point1 = hull1->GetVertWorldSpace(0) + input.offset1;
+            simplex->m_vertexA.point2 = hull2->GetVertWorldSpace(0) + input.offset2;
+            simplex->m_vertexA.point = simplex->m_vertexA.point2 - simplex->m_vertexA.point1;
+            count = 1;
+        }
+        if (count == 1) {
+            simplex->m_vertexA.u = 1.0f;
+        }
+
+        simplex->m_count = count;
+    }
+
+    void CollisionWorld::WriteCache(const Simplex& simplex, gjk_Cache* cache, const laml::Vec3& point1, const laml::Vec3& point2) {
+        const simplexVertex* vertices = &simplex.m_vertexA;
+
+        cache->count = simplex.m_count;
+        for (int i = 0; i < simplex.m_count; i++) {
+            cache->index1[i] = vertices[i].index1;
+            cache->index2[i] = vertices[i].index2;
+        }
+
+        // no separating axis once the hulls overlap
+        laml::Vec3 axis = point2 - point1;
+        cache->hasAxis = !simplex.m_hit && laml::length_sq(axis) > 0.0f;
+        if (cache->hasAxis) {
+            cache->axis = laml::normalize(axis);
+        }
+    }
+
+    gjk_Cache* CollisionWorld::GetPairCache(ShapecastContext& ctx, UID_t staticID) {
+        PairCacheTable& table = *ctx.pairCache;
+
+        auto it = table.find(staticID);
+        if (it != table.end()) {
+            ctx.gjkStats.hits++;
+            return &it->second;
+        }
+
+        ctx.gjkStats.misses++;
+
+        // pairs are never evicted one at a time, just start over if the table gets big
+        if (table.size() >= GJK_CACHE_MAX_PAIRS) {
+            table.clear();
+        }
+        return &table[staticID];
     }
 
 }
\ No newline at end of file
@@ -3,9 +3,19 @@
 
 #include "Engine/Core/Base.hpp"
 #include "Engine/Collision/CollisionHull.hpp"
+#include "Engine/Collision/SlotMap.hpp"
+#include "Engine/Core/WorkerPool.hpp"
+
+#include <map>
+#include <tuple>
 
 namespace rh {
 
+    struct Ray {
+        laml::Vec3 start;
+        laml::Vec3 end;
+    };
+
     struct RaycastResult {
         f32 t;
         UID_t colliderID;
@@ -43,6 +53,7 @@ namespace rh {
 #define MAX_POINTS 10
 #define MAX_FACES 10
 #define MAX_INCREASING_ITS 2
+#define GJK_CACHE_MAX_PAIRS 4096
 
     struct simplexVertex {
         laml::Vec3 point1;
@@ -90,34 +101,138 @@ namespace rh {
 
         TermCode m_term;
     };
+    /// Final simplex of a GJK call, by vertex index, used to seed the next
+    /// call on the same pair of hulls.
+    struct gjk_Cache {
+        int count = 0; // 0 = cold start
+        int index1[4];
+        int index2[4];
+        laml::Vec3 axis; // last separating axis, hull1 -> hull2. seeds the first search direction
+        bool hasAxis = false;
+    };
+    // cached simplices of one dynamic hull, keyed by static hull
+    typedef std::unordered_map<UID_t, gjk_Cache> PairCacheTable;
     struct gjk_Input {
         CollisionHull* hull1;
         CollisionHull* hull2;
+
+        // read on entry, written on exit. Can be null
+        gjk_Cache* cache = nullptr;
+
+        // hulls are tested as if moved by these, and hull1 inflated by feather_radius
+        laml::Vec3 offset1 = laml::Vec3(0.0f, 0.0f, 0.0f);
+        laml::Vec3 offset2 = laml::Vec3(0.0f, 0.0f, 0.0f);
+        float feather_radius = 0.0f;
+    };
+
+    struct ShapecastStats {
+        u32 toiSolves = 0;  // TimeOfImpact calls that ran
+        u32 toiSkipped = 0; // broadphase candidates rejected by the swept AABB test
+    };
+
+    struct GJKCacheStats {
+        u64 hits = 0;   // TOI queries that found a cached simplex for their pair
+        u64 misses = 0;
+
+        // histogram of gjk_Output::iterations
+        u64 iterations[gjk_Output::e_maxSimplices + 1] = {};
+    };
+
+    /// One character for CollisionWorld::StepCharacters. Fields marked in/out
+    /// carry state from one step to the next.
+    struct CharacterMotion {
+        UID_t hullID = 0;
+        laml::Vec3 hullOffset;      // hull sits at position + hullOffset
+        float floorAngleLimit = 35; // degrees, steeper contacts are walls
+        float groundProbe = 0.6f;   // ground check ray length, down from the hull
+        float gravity = 9.8f;
+
+        laml::Vec3 position;        // in/out
+        laml::Vec3 velocity;        // in/out, y is zeroed on landing
+        bool grounded = false;      // in/out
+        laml::Vec3 floorUp;         // in/out
+        UID_t floorID = 0;          // in/out
+
+        laml::Vec3 previousPosition;// out, position before the last fixed step
+        laml::Vec3 ghostPosition;   // out, position at the first time of impact
+        bool hitFloor = false;      // out, touched a walkable surface, cleared by Update
+        int iterations = 0;         // out, contact resolve iterations
+    };
+
+    /// Everything CollisionWorld::Update changes. Hull transforms are stored in
+    /// slot order, so a snapshot only restores into the world it came from, and
+    /// only while no hulls have been created or removed since. The GJK pair
+    /// cache is only a warm start, so it is not saved; Restore clears it.
+    struct CollisionSnapshot {
+        u64 layoutVersion = 0;
+        std::vector<HullTransform> staticTransforms;
+        std::vector<HullTransform> dynamicTransforms;
+        std::vector<CharacterMotion> characters;
+        double accumulator = 0.0;
     };
 
     class CollisionWorld {
     public:
         CollisionWorld();
 
+        /// Advance the simulation by dt in fixed steps. Leftover time is carried
+        /// to the next call, and anything past maxSubsteps steps is dropped.
         void Update(double dt);
+        void SetFixedTimestep(float timestep, int maxSubsteps);
+        float GetFixedTimestep() const { return m_fixedTimestep; }
+        /// Fixed steps taken by the last Update
+        int GetSubstepCount() const { return m_lastSubsteps; }
+        /// How far between the last two fixed steps the current time is, [0,1)
+        float GetInterpolationAlpha() const { return (float)(m_accumulator / m_fixedTimestep); }
+
+        /// Characters added here are stepped by Update, keyed by hullID.
+        /// Pointers from GetCharacter are valid until the next add/remove.
+        void AddCharacter(const CharacterMotion& character);
+        CharacterMotion* GetCharacter(UID_t hullID);
+        bool RemoveCharacter(UID_t hullID);
+        /// Character position blended between the last two fixed steps, for rendering
+        laml::Vec3 GetInterpolatedPosition(UID_t hullID);
+
+        /// Copy the simulation state out. Reuses the buffers in snapshot, so
+        /// taking one every frame doesn't allocate once they have grown.
+        void Snapshot(CollisionSnapshot& snapshot) const;
+        CollisionSnapshot Snapshot() const;
+        /// Put the world back to a snapshot. Fails (and changes nothing) if
+        /// hulls were created or removed after it was taken.
+        bool Restore(const CollisionSnapshot& snapshot);
 
         RaycastResult Raycast(laml::Vec3 start, laml::Vec3 end);
         RaycastResult Raycast(laml::Vec3 start, laml::Vec3 direction, laml::Scalar distance);
 
         RaycastResult Raycast(UID_t target, laml::Vec3 start, laml::Vec3 end);
 
+        /// results[n] is exactly what Raycast(rays[n].start, rays[n].end) returns.
+        /// Rays are sorted spatially and split across the worker pool.
+        void RaycastBatch(const Ray* rays, RaycastResult* results, size_t count);
+
+        /// 0 uses every hardware thread, 1 runs batches on the calling thread
+        void SetNumWorkerThreads(int numThreads);
+        int GetNumWorkerThreads();
+
         ShapecastResult_multi Shapecast_multi(UID_t id, laml::Vec3 vel);
         ShapecastResult Shapecast(UID_t id, laml::Vec3 vel);
 
+        /// Sweep and resolve count characters against the static hulls for one
+        /// step of length ts. Shapecasts run on the worker pool, then the hulls
+        /// are moved in array order, so results don't depend on thread count.
+        /// Characters are not tested against each other.
+        void StepCharacters(CharacterMotion* characters, size_t count, float ts);
+
         laml::Scalar TimeOfImpact(CollisionHull* hull1, laml::Vec3 vel1,
             CollisionHull* hull2, laml::Vec3 vel2,
             laml::Vec3* out_normal, laml::Vec3* out_contact_point,
-            int* out_iterations);
+            int* out_iterations, gjk_Cache* cache = nullptr, GJKCacheStats* stats = nullptr);
         laml::Scalar StepGJK(float t,
             CollisionHull* hull1, laml::Vec3 vel1,
             CollisionHull* hull2, laml::Vec3 vel2,
             laml::Vec3* point1, laml::Vec3* point2,
-            float feather_radius);
+            float feather_radius,
+            gjk_Cache* cache = nullptr, GJKCacheStats* stats = nullptr);
 
         UID_t CreateNewCubeHull(
             laml::Vec3 position, laml::Scalar size);
@@ -125,14 +240,92 @@ namespace rh {
             laml::Vec3 position, laml::Scalar xSize, laml::Scalar ySize, laml::Scalar zSize);
         UID_t CreateNewCapsule(
             laml::Vec3 position, laml::Scalar height, laml::Scalar radius);
+        /// Static convex hull from an imported mesh. Adjacency is built for
+        /// hill-climbing support queries if the hull is large enough to benefit.
+        UID_t CreateNewConvexHull(
+            laml::Vec3 position, const std::vector<laml::Vec3>& vertices, const std::vector<CollisionTriangle>& faces);
+        /// Another instance of an existing shape, the geometry is not copied
+        UID_t CreateNewConvexHull(
+            laml::Vec3 position, const Ref<CollisionShape>& shape);
+        /// O(1), returns nullptr if the hull has been removed.
+        /// The pointer is only valid until the next hull is created or removed.
         CollisionHull* getHullFromID(UID_t id);
+        bool RemoveHull(UID_t id);
+
+        /// Move a hull and refit its broadphase proxy (if it has one)
+        void MoveHull(UID_t id, const laml::Vec3& position);
+        void MoveHull(UID_t id, const laml::Vec3& position, const laml::Mat3& rotation);
+
+        const DynamicTree& GetStaticTree() const { return m_staticTree; }
+
+        /// Counts for the last full frame (between the last two calls to Update)
+        const ShapecastStats& GetShapecastStats() const { return m_lastFrameStats; }
+
+        const GJKCacheStats& GetGJKCacheStats() const { return m_gjkStats; }
+        void ResetGJKCacheStats() { m_gjkStats = GJKCacheStats(); }
+        void ClearGJKCache() { m_pairCache.clear(); }
 
         /* GJK algorithm */
         void GJK(gjk_Output* output, gjk_Input& input);
 
         //private:
-        std::vector<CollisionHull> m_static;
-        std::vector<CollisionHull> m_dynamic;
+        SlotMap<CollisionHull> m_static;
+        SlotMap<CollisionHull> m_dynamic;
+
+    private:
+        UID_t AddStaticHull(CollisionHull& hull);
+        AABB GetSweptAABB(CollisionHull* hull, const laml::Vec3& vel);
+        /// Can hull moving by vel touch target at all? Checked before running TOI.
+        bool SweptOverlap(CollisionHull* hull, const laml::Vec3& vel, CollisionHull* target);
+        void RaycastHull(CollisionHull* hull, const laml::Vec3& start, const laml::Vec3& d, RaycastResult& res);
+        WorkerPool& GetWorkerPool();
+
+        // broadphase over m_static, user data is the hull handle
+        DynamicTree m_staticTree;
+
+        /// Everything a shapecast writes to besides its result. Each worker
+        /// gets its own, they are merged back on the main thread.
+        struct ShapecastContext {
+            PairCacheTable* pairCache = nullptr;
+            ShapecastStats stats;
+            GJKCacheStats gjkStats;
+        };
+        ShapecastContext BeginShapecast(UID_t id);
+        void EndShapecast(const ShapecastContext& ctx);
+
+        ShapecastResult_multi Shapecast_multi(CollisionHull* hull1, const laml::Vec3& vel, ShapecastContext& ctx);
+        ShapecastResult Shapecast(CollisionHull* hull1, const laml::Vec3& vel, ShapecastContext& ctx);
+        void ResolveCharacter(CharacterMotion& character, float ts, ShapecastContext& ctx);
+        void StepSimulation(float ts);
+
+        /// Cached simplex for a (dynamic, static) pair, created on first use
+        gjk_Cache* GetPairCache(ShapecastContext& ctx, UID_t staticID);
+        void ReadCache(Simplex* simplex, const gjk_Input& input);
+        void WriteCache(const Simplex& simplex, gjk_Cache* cache, const laml::Vec3& point1, const laml::Vec3& point2);
+
+        std::unordered_map<UID_t, PairCacheTable> m_pairCache; // keyed by dynamic hull
+        GJKCacheStats m_gjkStats;
+
+        ShapecastStats m_frameStats;
+        ShapecastStats m_lastFrameStats;
+
+        std::vector<ShapecastContext> m_characterContexts;
+
+        std::vector<CharacterMotion> m_characters;
+
+        // shared shapes for the built-in primitives, keyed by size
+        std::map<std::tuple<float, float, float>, Ref<CollisionShape>> m_boxShapes;
+        std::map<std::pair<float, float>, Ref<CollisionShape>> m_capsuleShapes;
+
+        // bumped whenever a hull is created or removed
+        u64 m_layoutVersion = 0;
+        double m_accumulator = 0.0;
+        float m_fixedTimestep = 1.0f / 60.0f;
+        int m_maxSubsteps = 8;
+        int m_lastSubsteps = 0;
+
+        Ref<WorkerPool> m_workers; // created on first batch
+        std::vector<u64> m_batchOrder; // sort key << 32 | ray index
     };
 }
 
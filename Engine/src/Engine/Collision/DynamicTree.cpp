@@ -0,0 +1,503 @@
+// Dynamic AABB tree adapted from Box2D's b2DynamicTree (3D bounds, engine types).
+//
+// MIT License
+//
+// Copyright (c) 2019 Erin Catto
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <enpch.hpp>
+#include "Engine/Collision/DynamicTree.hpp"
+
+namespace rh {
+
+    void AABB::Combine(const AABB& a, const AABB& b) {
+        lowerBound = laml::Vec3(
+            std::min(a.lowerBound.x, b.lowerBound.x),
+            std::min(a.lowerBound.y, b.lowerBound.y),
+            std::min(a.lowerBound.z, b.lowerBound.z));
+        upperBound = laml::Vec3(
+            std::max(a.upperBound.x, b.upperBound.x),
+            std::max(a.upperBound.y, b.upperBound.y),
+            std::max(a.upperBound.z, b.upperBound.z));
+    }
+
+    bool AABB::Contains(const AABB& other) const {
+        return lowerBound.x <= other.lowerBound.x &&
+               lowerBound.y <= other.lowerBound.y &&
+               lowerBound.z <= other.lowerBound.z &&
+               other.upperBound.x <= upperBound.x &&
+               other.upperBound.y <= upperBound.y &&
+               other.upperBound.z <= upperBound.z;
+    }
+
+    bool AABB::Overlaps(const AABB& other) const {
+        if (other.lowerBound.x > upperBound.x || lowerBound.x > other.upperBound.x)
+            return false;
+        if (other.lowerBound.y > upperBound.y || lowerBound.y > other.upperBound.y)
+            return false;
+        if (other.lowerBound.z > upperBound.z || lowerBound.z > other.upperBound.z)
+            return false;
+        return true;
+    }
+
+    bool AABB::IntersectsSegment(const laml::Vec3& start, const laml::Vec3& d, float maxFraction, float* t_enter) const {
+        float tmin = 0.0f;
+        float tmax = maxFraction;
+
+        for (int i = 0; i < 3; i++) {
+            float p = (&start.x)[i];
+            float dir = (&d.x)[i];
+            float lo = (&lowerBound.x)[i];
+            float hi = (&upperBound.x)[i];
+
+            if (std::abs(dir) < 1.0e-9f) {
+                // parallel to this slab, must start inside it
+                if (p < lo || p > hi)
+                    return false;
+            }
+            else {
+                float inv_d = 1.0f / dir;
+                float t1 = (lo - p) * inv_d;
+                float t2 = (hi - p) * inv_d;
+                if (t1 > t2)
+                    std::swap(t1, t2);
+
+                tmin = std::max(tmin, t1);
+                tmax = std::min(tmax, t2);
+                if (tmin > tmax)
+                    return false;
+            }
+        }
+
+        *t_enter = tmin;
+        return true;
+    }
+
+    DynamicTree::DynamicTree() {
+        m_root = NULL_NODE;
+        m_nodeCount = 0;
+        m_proxyCount = 0;
+        m_freeList = NULL_NODE;
+    }
+
+    void DynamicTree::Clear() {
+        m_nodes.clear();
+        m_root = NULL_NODE;
+        m_nodeCount = 0;
+        m_proxyCount = 0;
+        m_freeList = NULL_NODE;
+    }
+
+    int DynamicTree::AllocateNode() {
+        if (m_freeList == NULL_NODE) {
+            // grow the node pool, and thread the new nodes onto the free list
+            int oldCapacity = (int)m_nodes.size();
+            int newCapacity = oldCapacity == 0 ? 16 : oldCapacity * 2;
+            m_nodes.resize(newCapacity);
+            for (int i = oldCapacity; i < newCapacity - 1; ++i) {
+                m_nodes[i].next = i + 1;
+                m_nodes[i].height = -1;
+            }
+            m_nodes[newCapacity - 1].next = NULL_NODE;
+            m_nodes[newCapacity - 1].height = -1;
+            m_freeList = oldCapacity;
+        }
+
+        int nodeId = m_freeList;
+        m_freeList = m_nodes[nodeId].next;
+        m_nodes[nodeId].parent = NULL_NODE;
+        m_nodes[nodeId].child1 = NULL_NODE;
+        m_nodes[nodeId].child2 = NULL_NODE;
+        m_nodes[nodeId].height = 0;
+        m_nodes[nodeId].userData = 0;
+        ++m_nodeCount;
+        return nodeId;
+    }
+
+    void DynamicTree::FreeNode(int nodeId) {
+        assert(0 <= nodeId && nodeId < (int)m_nodes.size());
+        assert(0 < m_nodeCount);
+        m_nodes[nodeId].next = m_freeList;
+        m_nodes[nodeId].height = -1;
+        m_freeList = nodeId;
+        --m_nodeCount;
+    }
+
+    int DynamicTree::CreateProxy(const AABB& aabb, u64 userData) {
+        int proxyId = AllocateNode();
+
+        // fatten the aabb
+        laml::Vec3 r(AABB_EXTENSION, AABB_EXTENSION, AABB_EXTENSION);
+        m_nodes[proxyId].aabb.lowerBound = aabb.lowerBound - r;
+        m_nodes[proxyId].aabb.upperBound = aabb.upperBound + r;
+        m_nodes[proxyId].userData = userData;
+        m_nodes[proxyId].height = 0;
+
+        InsertLeaf(proxyId);
+        ++m_proxyCount;
+
+        return proxyId;
+    }
+
+    void DynamicTree::DestroyProxy(int proxyId) {
+        assert(0 <= proxyId && proxyId < (int)m_nodes.size());
+        assert(m_nodes[proxyId].IsLeaf());
+
+        RemoveLeaf(proxyId);
+        FreeNode(proxyId);
+        --m_proxyCount;
+    }
+
+    bool DynamicTree::MoveProxy(int proxyId, const AABB& aabb, const laml::Vec3& displacement) {
+        assert(0 <= proxyId && proxyId < (int)m_nodes.size());
+        assert(m_nodes[proxyId].IsLeaf());
+
+        // extend the AABB
+        laml::Vec3 r(AABB_EXTENSION, AABB_EXTENSION, AABB_EXTENSION);
+        AABB fatAABB;
+        fatAABB.lowerBound = aabb.lowerBound - r;
+        fatAABB.upperBound = aabb.upperBound + r;
+
+        // predict AABB movement
+        laml::Vec3 d = displacement * AABB_MULTIPLIER;
+        for (int i = 0; i < 3; i++) {
+            if ((&d.x)[i] < 0.0f)
+                (&fatAABB.lowerBound.x)[i] += (&d.x)[i];
+            else
+                (&fatAABB.upperBound.x)[i] += (&d.x)[i];
+        }
+
+        const AABB& treeAABB = m_nodes[proxyId].aabb;
+        if (treeAABB.Contains(aabb)) {
+            // The tree AABB still contains the object, but it might be too large.
+            // Perhaps the object was moving fast but has since gone to sleep.
+            AABB hugeAABB;
+            hugeAABB.lowerBound = fatAABB.lowerBound - r * 4.0f;
+            hugeAABB.upperBound = fatAABB.upperBound + r * 4.0f;
+
+            if (hugeAABB.Contains(treeAABB)) {
+                // The tree AABB contains the object AABB and it is not too large.
+                // No tree update needed.
+                return false;
+            }
+            // Otherwise the tree AABB is huge and needs to be shrunk
+        }
+
+        RemoveLeaf(proxyId);
+        m_nodes[proxyId].aabb = fatAABB;
+        InsertLeaf(proxyId);
+
+        return true;
+    }
+
+    void DynamicTree::InsertLeaf(int leaf) {
+        if (m_root == NULL_NODE) {
+            m_root = leaf;
+            m_nodes[m_root].parent = NULL_NODE;
+            return;
+        }
+
+        // Find the best sibling for this node
+        AABB leafAABB = m_nodes[leaf].aabb;
+        int index = m_root;
+        while (m_nodes[index].IsLeaf() == false) {
+            int child1 = m_nodes[index].child1;
+            int child2 = m_nodes[index].child2;
+
+            float area = m_nodes[index].aabb.GetSurfaceArea();
+
+            AABB combinedAABB;
+            combinedAABB.Combine(m_nodes[index].aabb, leafAABB);
+            float combinedArea = combinedAABB.GetSurfaceArea();
+
+            // Cost of creating a new parent for this node and the new leaf
+            float cost = 2.0f * combinedArea;
+
+            // Minimum cost of pushing the leaf further down the tree
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            // Cost of descending into child1
+            float cost1;
+            {
+                AABB aabb;
+                aabb.Combine(leafAABB, m_nodes[child1].aabb);
+                if (m_nodes[child1].IsLeaf()) {
+                    cost1 = aabb.GetSurfaceArea() + inheritanceCost;
+                }
+                else {
+                    float oldArea = m_nodes[child1].aabb.GetSurfaceArea();
+                    float newArea = aabb.GetSurfaceArea();
+                    cost1 = (newArea - oldArea) + inheritanceCost;
+                }
+            }
+
+            // Cost of descending into child2
+            float cost2;
+            {
+                AABB aabb;
+                aabb.Combine(leafAABB, m_nodes[child2].aabb);
+                if (m_nodes[child2].IsLeaf()) {
+                    cost2 = aabb.GetSurfaceArea() + inheritanceCost;
+                }
+                else {
+                    float oldArea = m_nodes[child2].aabb.GetSurfaceArea();
+                    float newArea = aabb.GetSurfaceArea();
+                    cost2 = (newArea - oldArea) + inheritanceCost;
+                }
+            }
+
+            // Descend according to the minimum cost.
+            if (cost < cost1 && cost < cost2) {
+                break;
+            }
+
+            if (cost1 < cost2) {
+                index = child1;
+            }
+            else {
+                index = child2;
+            }
+        }
+
+        int sibling = index;
+
+        // Create a new parent.
+        int oldParent = m_nodes[sibling].parent;
+        int newParent = AllocateNode();
+        m_nodes[newParent].parent = oldParent;
+        m_nodes[newParent].userData = 0;
+        m_nodes[newParent].aabb.Combine(leafAABB, m_nodes[sibling].aabb);
+        m_nodes[newParent].height = m_nodes[sibling].height + 1;
+
+        if (oldParent != NULL_NODE) {
+            // The sibling was not the root.
+            if (m_nodes[oldParent].child1 == sibling) {
+                m_nodes[oldParent].child1 = newParent;
+            }
+            else {
+                m_nodes[oldParent].child2 = newParent;
+            }
+        }
+        else {
+            // The sibling was the root.
+            m_root = newParent;
+        }
+
+        m_nodes[newParent].child1 = sibling;
+        m_nodes[newParent].child2 = leaf;
+        m_nodes[sibling].parent = newParent;
+        m_nodes[leaf].parent = newParent;
+
+        // Walk back up the tree fixing heights and AABBs
+        index = m_nodes[leaf].parent;
+        while (index != NULL_NODE) {
+            index = Balance(index);
+
+            int child1 = m_nodes[index].child1;
+            int child2 = m_nodes[index].child2;
+
+            assert(child1 != NULL_NODE);
+            assert(child2 != NULL_NODE);
+
+            m_nodes[index].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+            m_nodes[index].aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+
+            index = m_nodes[index].parent;
+        }
+    }
+
+    void DynamicTree::RemoveLeaf(int leaf) {
+        if (leaf == m_root) {
+            m_root = NULL_NODE;
+            return;
+        }
+
+        int parent = m_nodes[leaf].parent;
+        int grandParent = m_nodes[parent].parent;
+        int sibling;
+        if (m_nodes[parent].child1 == leaf) {
+            sibling = m_nodes[parent].child2;
+        }
+        else {
+            sibling = m_nodes[parent].child1;
+        }
+
+        if (grandParent != NULL_NODE) {
+            // Destroy parent and connect sibling to grandParent.
+            if (m_nodes[grandParent].child1 == parent) {
+                m_nodes[grandParent].child1 = sibling;
+            }
+            else {
+                m_nodes[grandParent].child2 = sibling;
+            }
+            m_nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+
+            // Adjust ancestor bounds.
+            int index = grandParent;
+            while (index != NULL_NODE) {
+                index = Balance(index);
+
+                int child1 = m_nodes[index].child1;
+                int child2 = m_nodes[index].child2;
+
+                m_nodes[index].aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+                m_nodes[index].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+
+                index = m_nodes[index].parent;
+            }
+        }
+        else {
+            m_root = sibling;
+            m_nodes[sibling].parent = NULL_NODE;
+            FreeNode(parent);
+        }
+    }
+
+    // Perform a left or right rotation if node A is imbalanced.
+    // Returns the new root index.
+    int DynamicTree::Balance(int iA) {
+        assert(iA != NULL_NODE);
+
+        TreeNode* A = &m_nodes[iA];
+        if (A->IsLeaf() || A->height < 2) {
+            return iA;
+        }
+
+        int iB = A->child1;
+        int iC = A->child2;
+        TreeNode* B = &m_nodes[iB];
+        TreeNode* C = &m_nodes[iC];
+
+        int balance = C->height - B->height;
+
+        // Rotate C up
+        if (balance > 1) {
+            int iF = C->child1;
+            int iG = C->child2;
+            TreeNode* F = &m_nodes[iF];
+            TreeNode* G = &m_nodes[iG];
+
+            // Swap A and C
+            C->child1 = iA;
+            C->parent = A->parent;
+            A->parent = iC;
+
+            // A's old parent should point to C
+            if (C->parent != NULL_NODE) {
+                if (m_nodes[C->parent].child1 == iA) {
+                    m_nodes[C->parent].child1 = iC;
+                }
+                else {
+                    assert(m_nodes[C->parent].child2 == iA);
+                    m_nodes[C->parent].child2 = iC;
+                }
+            }
+            else {
+                m_root = iC;
+            }
+
+            // Rotate
+            if (F->height > G->height) {
+                C->child2 = iF;
+                A->child2 = iG;
+                G->parent = iA;
+                A->aabb.Combine(B->aabb, G->aabb);
+                C->aabb.Combine(A->aabb, F->aabb);
+
+                A->height = 1 + std::max(B->height, G->height);
+                C->height = 1 + std::max(A->height, F->height);
+            }
+            else {
+                C->child2 = iG;
+                A->child2 = iF;
+                F->parent = iA;
+                A->aabb.Combine(B->aabb, F->aabb);
+                C->aabb.Combine(A->aabb, G->aabb);
+
+                A->height = 1 + std::max(B->height, F->height);
+                C->height = 1 + std::max(A->height, G->height);
+            }
+
+            return iC;
+        }
+
+        // Rotate B up
+        if (balance < -1) {
+            int iD = B->child1;
+            int iE = B->child2;
+            TreeNode* D = &m_nodes[iD];
+            TreeNode* E = &m_nodes[iE];
+
+            // Swap A and B
+            B->child1 = iA;
+            B->parent = A->parent;
+            A->parent = iB;
+
+            // A's old parent should point to B
+            if (B->parent != NULL_NODE) {
+                if (m_nodes[B->parent].child1 == iA) {
+                    m_nodes[B->parent].child1 = iB;
+                }
+                else {
+                    assert(m_nodes[B->parent].child2 == iA);
+                    m_nodes[B->parent].child2 = iB;
+                }
+            }
+            else {
+                m_root = iB;
+            }
+
+            // Rotate
+            if (D->height > E->height) {
+                B->child2 = iD;
+                A->child1 = iE;
+                E->parent = iA;
+                A->aabb.Combine(C->aabb, E->aabb);
+                B->aabb.Combine(A->aabb, D->aabb);
+
+                A->height = 1 + std::max(C->height, E->height);
+                B->height = 1 + std::max(A->height, D->height);
+            }
+            else {
+                B->child2 = iE;
+                A->child1 = iD;
+                D->parent = iA;
+                A->aabb.Combine(C->aabb, D->aabb);
+                B->aabb.Combine(A->aabb, E->aabb);
+
+                A->height = 1 + std::max(C->height, D->height);
+                B->height = 1 + std::max(A->height, E->height);
+            }
+
+            return iB;
+        }
+
+        return iA;
+    }
+
+    int DynamicTree::GetHeight() const {
+        if (m_root == NULL_NODE) {
+            return 0;
+        }
+
+        return m_nodes[m_root].height;
+    }
+}
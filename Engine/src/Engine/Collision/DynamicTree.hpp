@@ -0,0 +1,243 @@
+// Dynamic AABB tree adapted from Box2D's b2DynamicTree (3D bounds, engine types).
+//
+// MIT License
+//
+// Copyright (c) 2019 Erin Catto
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DYNAMIC_TREE_H
+#define DYNAMIC_TREE_H
+
+#include "Engine/Core/Base.hpp"
+
+namespace rh {
+
+#define NULL_NODE (-1)
+#define AABB_EXTENSION 0.1f
+#define AABB_MULTIPLIER 2.0f
+
+    /// Axis-aligned bounding box in world space
+    struct AABB {
+        laml::Vec3 lowerBound;
+        laml::Vec3 upperBound;
+
+        AABB() {}
+        AABB(const laml::Vec3& lower, const laml::Vec3& upper) : lowerBound(lower), upperBound(upper) {}
+
+        laml::Vec3 GetCenter() const { return (lowerBound + upperBound) * 0.5f; }
+        laml::Vec3 GetExtents() const { return (upperBound - lowerBound) * 0.5f; }
+
+        /// Surface area, used as the insertion cost metric
+        float GetSurfaceArea() const {
+            laml::Vec3 d = upperBound - lowerBound;
+            return 2.0f * (d.x*d.y + d.y*d.z + d.z*d.x);
+        }
+
+        void Combine(const AABB& a, const AABB& b);
+        bool Contains(const AABB& other) const;
+        bool Overlaps(const AABB& other) const;
+
+        /// Slab test of the segment start + t*d against this box. On a hit
+        /// *t_enter holds the entry parameter (clamped to 0).
+        bool IntersectsSegment(const laml::Vec3& start, const laml::Vec3& d, float maxFraction, float* t_enter) const;
+    };
+
+    struct TreeNode {
+        bool IsLeaf() const { return child1 == NULL_NODE; }
+
+        AABB aabb;
+        u64 userData;
+
+        union {
+            int parent;
+            int next;
+        };
+
+        int child1;
+        int child2;
+
+        // leaf = 0, free node = -1
+        int height;
+    };
+
+    /// Fixed-size stack that spills to the heap, used for tree traversal
+    template<typename T, int N>
+    class GrowableStack {
+    public:
+        GrowableStack() : m_stack(m_array), m_count(0), m_capacity(N) {}
+        ~GrowableStack() {
+            if (m_stack != m_array) {
+                free(m_stack);
+            }
+        }
+
+        void Push(const T& element) {
+            if (m_count == m_capacity) {
+                T* old = m_stack;
+                m_capacity *= 2;
+                m_stack = (T*)malloc(m_capacity * sizeof(T));
+                memcpy(m_stack, old, m_count * sizeof(T));
+                if (old != m_array) {
+                    free(old);
+                }
+            }
+            m_stack[m_count++] = element;
+        }
+
+        T Pop() {
+            return m_stack[--m_count];
+        }
+
+        int GetCount() const { return m_count; }
+
+    private:
+        T* m_stack;
+        T m_array[N];
+        int m_count;
+        int m_capacity;
+    };
+
+    /// A dynamic AABB tree broad-phase. Leaves hold fattened AABBs so that
+    /// small motions do not require the tree to be updated. Internal nodes
+    /// are kept balanced with tree rotations, so queries walk O(log n) nodes.
+    class DynamicTree {
+    public:
+        DynamicTree();
+
+        /// Insert a proxy into the tree, returns the proxy ID
+        int CreateProxy(const AABB& aabb, u64 userData);
+        void DestroyProxy(int proxyId);
+
+        /// Refit a proxy. Only reinserts if the new AABB has left the fat AABB.
+        /// Returns true if the proxy was reinserted.
+        bool MoveProxy(int proxyId, const AABB& aabb, const laml::Vec3& displacement);
+
+        u64 GetUserData(int proxyId) const;
+        const AABB& GetFatAABB(int proxyId) const;
+
+        /// Calls callback(proxyId) for every proxy overlapping aabb.
+        /// Return false from the callback to stop the query.
+        template<typename T>
+        void Query(const AABB& aabb, T callback) const;
+
+        /// Calls callback(proxyId, maxFraction) for every proxy whose AABB the
+        /// segment start -> end touches. The callback returns the new max
+        /// fraction: 0 terminates the query, values < maxFraction clip the ray.
+        template<typename T>
+        void RayCast(const laml::Vec3& start, const laml::Vec3& end, T callback) const;
+
+        void Clear();
+
+        int GetHeight() const;
+        int GetProxyCount() const { return m_proxyCount; }
+        int GetNodeCount() const { return m_nodeCount; }
+
+    private:
+        int AllocateNode();
+        void FreeNode(int node);
+
+        void InsertLeaf(int leaf);
+        void RemoveLeaf(int leaf);
+
+        int Balance(int index);
+
+        std::vector<TreeNode> m_nodes;
+        int m_root;
+        int m_nodeCount;
+        int m_proxyCount;
+        int m_freeList;
+    };
+
+    inline u64 DynamicTree::GetUserData(int proxyId) const {
+        assert(0 <= proxyId && proxyId < (int)m_nodes.size());
+        return m_nodes[proxyId].userData;
+    }
+
+    inline const AABB& DynamicTree::GetFatAABB(int proxyId) const {
+        assert(0 <= proxyId && proxyId < (int)m_nodes.size());
+        return m_nodes[proxyId].aabb;
+    }
+
+    template<typename T>
+    inline void DynamicTree::Query(const AABB& aabb, T callback) const {
+        if (m_root == NULL_NODE)
+            return;
+
+        GrowableStack<int, 256> stack;
+        stack.Push(m_root);
+
+        while (stack.GetCount() > 0) {
+            int nodeId = stack.Pop();
+            const TreeNode* node = &m_nodes[nodeId];
+
+            if (node->aabb.Overlaps(aabb)) {
+                if (node->IsLeaf()) {
+                    bool proceed = callback(nodeId);
+                    if (!proceed)
+                        return;
+                }
+                else {
+                    stack.Push(node->child1);
+                    stack.Push(node->child2);
+                }
+            }
+        }
+    }
+
+    template<typename T>
+    inline void DynamicTree::RayCast(const laml::Vec3& start, const laml::Vec3& end, T callback) const {
+        if (m_root == NULL_NODE)
+            return;
+
+        laml::Vec3 d = end - start;
+        float maxFraction = 1.0f;
+
+        GrowableStack<int, 256> stack;
+        stack.Push(m_root);
+
+        while (stack.GetCount() > 0) {
+            int nodeId = stack.Pop();
+            const TreeNode* node = &m_nodes[nodeId];
+
+            float t_enter;
+            if (!node->aabb.IntersectsSegment(start, d, maxFraction, &t_enter))
+                continue;
+
+            if (node->IsLeaf()) {
+                float value = callback(nodeId, maxFraction);
+                if (value == 0.0f) {
+                    // the client has terminated the ray cast
+                    return;
+                }
+
+                if (value > 0.0f && value < maxFraction) {
+                    // clip the ray to the new closest hit
+                    maxFraction = value;
+                }
+            }
+            else {
+                stack.Push(node->child1);
+                stack.Push(node->child2);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,259 @@
+#include <enpch.hpp>
+#include "Engine/Collision/RayTriangle.hpp"
+
+#if defined(RAY_TRIANGLE_AVX)
+#include <immintrin.h>
+#elif defined(RAY_TRIANGLE_SSE)
+#include <emmintrin.h>
+#endif
+
+namespace rh {
+
+    // determinants smaller than this are edge-on to the ray
+#define RAY_TRIANGLE_EPSILON 1e-8f
+
+    void TriangleSoA::Resize(int numTriangles) {
+        count = numTriangles;
+
+        // pad with zeroed triangles, which have a zero determinant
+        size_t padded = (size_t)((numTriangles + 7) & ~7);
+        std::vector<f32>* arrays[] = { &v0x, &v0y, &v0z, &e1x, &e1y, &e1z, &e2x, &e2y, &e2z, &nx, &ny, &nz };
+        for (auto a : arrays) {
+            a->assign(padded, 0.0f);
+        }
+    }
+
+    void TriangleSoA::Set(int index, const laml::Vec3& v0, const laml::Vec3& v1, const laml::Vec3& v2) {
+        laml::Vec3 e1 = v1 - v0;
+        laml::Vec3 e2 = v2 - v0;
+        laml::Vec3 n = laml::normalize(laml::cross(e1, e2));
+
+        v0x[index] = v0.x; v0y[index] = v0.y; v0z[index] = v0.z;
+        e1x[index] = e1.x; e1y[index] = e1.y; e1z[index] = e1.z;
+        e2x[index] = e2.x; e2y[index] = e2.y; e2z[index] = e2.z;
+        nx[index]  = n.x;  ny[index]  = n.y;  nz[index]  = n.z;
+    }
+
+    int RaycastTriangles_Scalar(const TriangleSoA& tris, const laml::Vec3& start, const laml::Vec3& d, f32 maxT, f32* out_t) {
+        int closest = -1;
+        f32 closest_t = maxT;
+
+        // Moller-Trumbore
+        for (int n = 0; n < tris.count; n++) {
+            laml::Vec3 e1(tris.e1x[n], tris.e1y[n], tris.e1z[n]);
+            laml::Vec3 e2(tris.e2x[n], tris.e2y[n], tris.e2z[n]);
+
+            laml::Vec3 p = laml::cross(d, e2);
+            f32 det = laml::dot(e1, p);
+            if (std::abs(det) < RAY_TRIANGLE_EPSILON)
+                continue;
+            f32 inv_det = 1.0f / det;
+
+            laml::Vec3 s = start - laml::Vec3(tris.v0x[n], tris.v0y[n], tris.v0z[n]);
+            f32 u = laml::dot(s, p) * inv_det;
+            if (u < 0.0f || u > 1.0f)
+                continue;
+
+            laml::Vec3 q = laml::cross(s, e1);
+            f32 v = laml::dot(d, q) * inv_det;
+            if (v < 0.0f || u + v > 1.0f)
+                continue;
+
+            // equal t keeps the earlier triangle, same as the wide kernels
+            f32 t = laml::dot(e2, q) * inv_det;
+            if (t < 0.0f || t > closest_t || (closest >= 0 && t == closest_t))
+                continue;
+
+            closest = n;
+            closest_t = t;
+        }
+
+        if (closest >= 0)
+            *out_t = closest_t;
+        return closest;
+    }
+
+#if defined(RAY_TRIANGLE_AVX)
+
+    int RaycastTriangles(const TriangleSoA& tris, const laml::Vec3& start, const laml::Vec3& d, f32 maxT, f32* out_t) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one  = _mm256_set1_ps(1.0f);
+        const __m256 eps  = _mm256_set1_ps(RAY_TRIANGLE_EPSILON);
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+
+        const __m256 dx = _mm256_set1_ps(d.x), dy = _mm256_set1_ps(d.y), dz = _mm256_set1_ps(d.z);
+        const __m256 ox = _mm256_set1_ps(start.x), oy = _mm256_set1_ps(start.y), oz = _mm256_set1_ps(start.z);
+
+        __m256 best_t = _mm256_set1_ps(maxT);
+        __m256 best_i = _mm256_set1_ps(-1.0f);
+        __m256 index  = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256 step = _mm256_set1_ps(8.0f);
+
+        for (int n = 0; n < tris.count; n += 8) {
+            __m256 e1x = _mm256_loadu_ps(&tris.e1x[n]), e1y = _mm256_loadu_ps(&tris.e1y[n]), e1z = _mm256_loadu_ps(&tris.e1z[n]);
+            __m256 e2x = _mm256_loadu_ps(&tris.e2x[n]), e2y = _mm256_loadu_ps(&tris.e2y[n]), e2z = _mm256_loadu_ps(&tris.e2z[n]);
+
+            // p = d x e2
+            __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+            __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+            __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+
+            __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+            __m256 mask = _mm256_cmp_ps(_mm256_andnot_ps(sign, det), eps, _CMP_GE_OQ);
+            __m256 inv_det = _mm256_div_ps(one, det);
+
+            // s = start - v0
+            __m256 sx = _mm256_sub_ps(ox, _mm256_loadu_ps(&tris.v0x[n]));
+            __m256 sy = _mm256_sub_ps(oy, _mm256_loadu_ps(&tris.v0y[n]));
+            __m256 sz = _mm256_sub_ps(oz, _mm256_loadu_ps(&tris.v0z[n]));
+
+            __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), inv_det);
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(u, one, _CMP_LE_OQ));
+
+            // q = s x e1
+            __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+            __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+            __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+
+            __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), inv_det);
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+
+            __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), inv_det);
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+
+            // a lane only sees increasing indices, so a tie keeps what it already has.
+            // maxT itself is still a hit while the lane is empty
+            __m256 empty = _mm256_cmp_ps(best_i, zero, _CMP_LT_OQ);
+            __m256 closer = _mm256_or_ps(_mm256_cmp_ps(t, best_t, _CMP_LT_OQ),
+                                         _mm256_and_ps(empty, _mm256_cmp_ps(t, best_t, _CMP_LE_OQ)));
+            mask = _mm256_and_ps(mask, closer);
+
+            best_t = _mm256_blendv_ps(best_t, t, mask);
+            best_i = _mm256_blendv_ps(best_i, index, mask);
+            index = _mm256_add_ps(index, step);
+        }
+
+        alignas(32) f32 lane_t[8];
+        alignas(32) f32 lane_i[8];
+        _mm256_store_ps(lane_t, best_t);
+        _mm256_store_ps(lane_i, best_i);
+
+        int closest = -1;
+        f32 closest_t = maxT;
+        for (int n = 0; n < 8; n++) {
+            if (lane_i[n] < 0.0f)
+                continue;
+
+            // ties across lanes go to the lowest triangle index, like the scalar path
+            int lane_tri = (int)lane_i[n];
+            if (closest < 0 || lane_t[n] < closest_t || (lane_t[n] == closest_t && lane_tri < closest)) {
+                closest = lane_tri;
+                closest_t = lane_t[n];
+            }
+        }
+
+        if (closest >= 0)
+            *out_t = closest_t;
+        return closest;
+    }
+
+#elif defined(RAY_TRIANGLE_SSE)
+
+    // SSE2 has no blendv
+    static inline __m128 Select(__m128 a, __m128 b, __m128 mask) {
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+    }
+
+    int RaycastTriangles(const TriangleSoA& tris, const laml::Vec3& start, const laml::Vec3& d, f32 maxT, f32* out_t) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one  = _mm_set1_ps(1.0f);
+        const __m128 eps  = _mm_set1_ps(RAY_TRIANGLE_EPSILON);
+        const __m128 sign = _mm_set1_ps(-0.0f);
+
+        const __m128 dx = _mm_set1_ps(d.x), dy = _mm_set1_ps(d.y), dz = _mm_set1_ps(d.z);
+        const __m128 ox = _mm_set1_ps(start.x), oy = _mm_set1_ps(start.y), oz = _mm_set1_ps(start.z);
+
+        __m128 best_t = _mm_set1_ps(maxT);
+        __m128 best_i = _mm_set1_ps(-1.0f);
+        __m128 index  = _mm_setr_ps(0, 1, 2, 3);
+        const __m128 step = _mm_set1_ps(4.0f);
+
+        for (int n = 0; n < tris.count; n += 4) {
+            __m128 e1x = _mm_loadu_ps(&tris.e1x[n]), e1y = _mm_loadu_ps(&tris.e1y[n]), e1z = _mm_loadu_ps(&tris.e1z[n]);
+            __m128 e2x = _mm_loadu_ps(&tris.e2x[n]), e2y = _mm_loadu_ps(&tris.e2y[n]), e2z = _mm_loadu_ps(&tris.e2z[n]);
+
+            // p = d x e2
+            __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+            __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            __m128 mask = _mm_cmpge_ps(_mm_andnot_ps(sign, det), eps);
+            __m128 inv_det = _mm_div_ps(one, det);
+
+            // s = start - v0
+            __m128 sx = _mm_sub_ps(ox, _mm_loadu_ps(&tris.v0x[n]));
+            __m128 sy = _mm_sub_ps(oy, _mm_loadu_ps(&tris.v0y[n]));
+            __m128 sz = _mm_sub_ps(oz, _mm_loadu_ps(&tris.v0z[n]));
+
+            __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv_det);
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+            mask = _mm_and_ps(mask, _mm_cmple_ps(u, one));
+
+            // q = s x e1
+            __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+            __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv_det);
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+            mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+
+            __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv_det);
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(t, zero));
+
+            // a lane only sees increasing indices, so a tie keeps what it already has.
+            // maxT itself is still a hit while the lane is empty
+            __m128 empty = _mm_cmplt_ps(best_i, zero);
+            __m128 closer = _mm_or_ps(_mm_cmplt_ps(t, best_t), _mm_and_ps(empty, _mm_cmple_ps(t, best_t)));
+            mask = _mm_and_ps(mask, closer);
+
+            best_t = Select(best_t, t, mask);
+            best_i = Select(best_i, index, mask);
+            index = _mm_add_ps(index, step);
+        }
+
+        alignas(16) f32 lane_t[4];
+        alignas(16) f32 lane_i[4];
+        _mm_store_ps(lane_t, best_t);
+        _mm_store_ps(lane_i, best_i);
+
+        int closest = -1;
+        f32 closest_t = maxT;
+        for (int n = 0; n < 4; n++) {
+            if (lane_i[n] < 0.0f)
+                continue;
+
+            // ties across lanes go to the lowest triangle index, like the scalar path
+            int lane_tri = (int)lane_i[n];
+            if (closest < 0 || lane_t[n] < closest_t || (lane_t[n] == closest_t && lane_tri < closest)) {
+                closest = lane_tri;
+                closest_t = lane_t[n];
+            }
+        }
+
+        if (closest >= 0)
+            *out_t = closest_t;
+        return closest;
+    }
+
+#else
+
+    int RaycastTriangles(const TriangleSoA& tris, const laml::Vec3& start, const laml::Vec3& d, f32 maxT, f32* out_t) {
+        return RaycastTriangles_Scalar(tris, start, d, maxT, out_t);
+    }
+
+#endif
+}
@@ -0,0 +1,47 @@
+#ifndef RAY_TRIANGLE_H
+#define RAY_TRIANGLE_H
+
+#include "Engine/Core/Base.hpp"
+
+// Pick the widest kernel the compiler is allowed to emit
+#if defined(__AVX__)
+    #define RAY_TRIANGLE_AVX 1
+    #define RAY_TRIANGLE_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define RAY_TRIANGLE_SSE 1
+    #define RAY_TRIANGLE_WIDTH 4
+#else
+    #define RAY_TRIANGLE_WIDTH 1
+#endif
+
+namespace rh {
+
+    /// World-space triangles of a hull in SoA layout, so the ray kernel can
+    /// load one component of several triangles at a time. Arrays are padded
+    /// to a multiple of 8 with degenerate triangles that can never be hit.
+    struct TriangleSoA {
+        // first vertex, and the two edges leaving it
+        std::vector<f32> v0x, v0y, v0z;
+        std::vector<f32> e1x, e1y, e1z;
+        std::vector<f32> e2x, e2y, e2z;
+
+        // unit face normal, cross(e1, e2)
+        std::vector<f32> nx, ny, nz;
+
+        int count = 0;
+
+        void Resize(int numTriangles);
+        void Set(int index, const laml::Vec3& v0, const laml::Vec3& v1, const laml::Vec3& v2);
+    };
+
+    /// Closest triangle hit by the segment start + t*d with t in [0, maxT].
+    /// Returns the triangle index, or -1 on a miss. Triangles are two-sided.
+    /// When several triangles are hit at the same t the lowest index wins,
+    /// whichever kernel is compiled in.
+    int RaycastTriangles(const TriangleSoA& tris, const laml::Vec3& start, const laml::Vec3& d, f32 maxT, f32* out_t);
+
+    /// Reference one-triangle-at-a-time version of RaycastTriangles
+    int RaycastTriangles_Scalar(const TriangleSoA& tris, const laml::Vec3& start, const laml::Vec3& d, f32 maxT, f32* out_t);
+}
+
+#endif
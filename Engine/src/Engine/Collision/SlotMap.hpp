@@ -0,0 +1,143 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include "Engine/Core/Base.hpp"
+
+namespace rh {
+
+    /// Generational handle table. Elements are packed in a dense array for
+    /// iteration, handles go through a slot table so lookups are O(1) and a
+    /// handle to a removed element never resolves to whatever reuses its slot.
+    ///
+    /// Handle layout: [tag : 8][generation : 24][slot index : 32]
+    /// The generation starts at 1, so 0 is never a valid handle.
+    ///
+    /// Pointers returned by Get() are invalidated by Insert() and Remove(),
+    /// hold on to the handle instead.
+    template<typename T>
+    class SlotMap {
+    public:
+        typedef u64 Handle;
+
+        SlotMap(u8 tag = 0) : m_tag(tag), m_freeList(NULL_SLOT) {}
+
+        Handle Insert(const T& element) {
+            u32 slotIndex;
+            if (m_freeList != NULL_SLOT) {
+                slotIndex = m_freeList;
+                m_freeList = m_slots[slotIndex].denseIndex;
+            }
+            else {
+                slotIndex = (u32)m_slots.size();
+                m_slots.push_back({ 0, 1 });
+            }
+
+            Slot& slot = m_slots[slotIndex];
+            slot.denseIndex = (u32)m_dense.size();
+
+            Handle handle = MakeHandle(slotIndex, slot.generation);
+            m_dense.push_back(element);
+            m_handles.push_back(handle);
+
+            return handle;
+        }
+
+        /// Returns false if the handle was stale
+        bool Remove(Handle handle) {
+            if (!Contains(handle))
+                return false;
+
+            Slot& slot = m_slots[GetSlotIndex(handle)];
+            u32 denseIndex = slot.denseIndex;
+            u32 lastIndex = (u32)m_dense.size() - 1;
+
+            // swap the last element into the hole
+            if (denseIndex != lastIndex) {
+                m_dense[denseIndex] = std::move(m_dense[lastIndex]);
+                m_handles[denseIndex] = m_handles[lastIndex];
+                m_slots[GetSlotIndex(m_handles[denseIndex])].denseIndex = denseIndex;
+            }
+            m_dense.pop_back();
+            m_handles.pop_back();
+
+            // bump the generation so old handles go stale, wrap past 0
+            slot.generation = (slot.generation + 1) & GENERATION_MASK;
+            if (slot.generation == 0)
+                slot.generation = 1;
+
+            slot.denseIndex = m_freeList;
+            m_freeList = GetSlotIndex(handle);
+
+            return true;
+        }
+
+        bool Contains(Handle handle) const {
+            if (GetTag(handle) != m_tag)
+                return false;
+
+            u32 slotIndex = GetSlotIndex(handle);
+            if (slotIndex >= m_slots.size())
+                return false;
+
+            return m_slots[slotIndex].generation == GetGeneration(handle);
+        }
+
+        /// Returns nullptr if the handle is stale
+        T* Get(Handle handle) {
+            if (!Contains(handle))
+                return nullptr;
+            return &m_dense[m_slots[GetSlotIndex(handle)].denseIndex];
+        }
+        const T* Get(Handle handle) const {
+            if (!Contains(handle))
+                return nullptr;
+            return &m_dense[m_slots[GetSlotIndex(handle)].denseIndex];
+        }
+
+        /// Handle of the element at a dense index
+        Handle GetHandle(size_t index) const { return m_handles[index]; }
+
+        void Clear() {
+            m_dense.clear();
+            m_handles.clear();
+            m_slots.clear();
+            m_freeList = NULL_SLOT;
+        }
+
+        size_t size() const { return m_dense.size(); }
+        bool empty() const { return m_dense.empty(); }
+
+        T& operator[](size_t index) { return m_dense[index]; }
+        const T& operator[](size_t index) const { return m_dense[index]; }
+
+        typename std::vector<T>::iterator begin() { return m_dense.begin(); }
+        typename std::vector<T>::iterator end() { return m_dense.end(); }
+        typename std::vector<T>::const_iterator begin() const { return m_dense.begin(); }
+        typename std::vector<T>::const_iterator end() const { return m_dense.end(); }
+
+        static u8 GetTag(Handle handle) { return (u8)(handle >> 56); }
+
+    private:
+        static const u32 NULL_SLOT = 0xFFFFFFFF;
+        static const u32 GENERATION_MASK = 0x00FFFFFF;
+
+        struct Slot {
+            u32 denseIndex; // next free slot when on the free list
+            u32 generation;
+        };
+
+        Handle MakeHandle(u32 slotIndex, u32 generation) const {
+            return ((u64)m_tag << 56) | ((u64)(generation & GENERATION_MASK) << 32) | (u64)slotIndex;
+        }
+        static u32 GetSlotIndex(Handle handle) { return (u32)(handle & 0xFFFFFFFF); }
+        static u32 GetGeneration(Handle handle) { return (u32)((handle >> 32) & GENERATION_MASK); }
+
+        std::vector<T> m_dense;
+        std::vector<Handle> m_handles;
+        std::vector<Slot> m_slots;
+        u8 m_tag;
+        u32 m_freeList;
+    };
+}
+
+#endif
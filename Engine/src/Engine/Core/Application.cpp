@@ -96,6 +96,10 @@ namespace rh {
                 /* Run all engine layer updates */
                 if (m_CurrentScene) {
                     m_CurrentScene->OnUpdate(timestep);
+                    Renderer::FlushDebugLines();
+                    SpriteRenderer::Flush(SPRITE_LAYER_BACKGROUND);
+                    TextRenderer::Flush();
+                    SpriteRenderer::Flush(SPRITE_LAYER_OVERLAY);
 
                     m_GuiLayer->Begin();
                     m_CurrentScene->OnGuiRender();
@@ -28,10 +28,15 @@ namespace rh {
         u64 s_totalMemoryAllocated = 0;
         u64 s_totalMemoryFreed = 0;
         u64 s_numAllocations = 0;
+        u64 s_peakMemory = 0;
 
         void Alloc(size_t sz) {
             s_totalMemoryAllocated += sz;
             s_numAllocations++;
+
+            u64 inUse = s_totalMemoryAllocated - s_totalMemoryFreed;
+            if (inUse > s_peakMemory)
+                s_peakMemory = inUse;
         }
 
         void Free(size_t sz) {
@@ -42,6 +47,26 @@ namespace rh {
             ENGINE_LOG_INFO("{0} Allocations, {1}/{2} bytes freed.", s_numAllocations, s_totalMemoryFreed, s_totalMemoryAllocated);
         }
 
+        u64 GetNumAllocations() {
+            return s_numAllocations;
+        }
+
+        u64 GetBytesAllocated() {
+            return s_totalMemoryAllocated;
+        }
+
+        u64 GetBytesFreed() {
+            return s_totalMemoryFreed;
+        }
+
+        u64 GetPeakBytes() {
+            return s_peakMemory;
+        }
+
+        void ResetPeakBytes() {
+            s_peakMemory = s_totalMemoryAllocated - s_totalMemoryFreed;
+        }
+
     }
 
 }
\ No newline at end of file
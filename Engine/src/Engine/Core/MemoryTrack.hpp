@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Engine/Core/DataTypes.hpp"
+
 #define TRACK_NEW_AND_DELETE 0
 
 namespace rh {
@@ -9,5 +11,14 @@ namespace rh {
         void Free(size_t sz);
 
         void PrintMemoryUsage();
+
+        // running totals, only counted when TRACK_NEW_AND_DELETE is on
+        u64 GetNumAllocations();
+        u64 GetBytesAllocated();
+        u64 GetBytesFreed();
+
+        // most bytes alive at once since the last ResetPeakBytes
+        u64 GetPeakBytes();
+        void ResetPeakBytes();
     };
 }
\ No newline at end of file
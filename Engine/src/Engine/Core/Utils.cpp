@@ -13,10 +13,6 @@ namespace rh {
         return hash;
     }
 
-    stringID operator"" _sid(const char* input, size_t s) {
-        return hash_djb2((unsigned char*)input);
-    }
-
     char* StripComments(char* inputBuf, size_t inputBufSize, size_t& newBufSize) {
         bool erasing = false;
 
@@ -9,8 +9,19 @@ namespace rh {
     /// Convert character string to Unsigned 32-bit Hash
     u32 hash_djb2(unsigned char* str);
 
-    /// Convert character string to Unsigned 32-bit Hash
-    stringID operator"" _sid(const char* input, size_t s);
+    /// Same hash as hash_djb2, usable at compile time
+    constexpr u32 hash_djb2(const char* str, size_t length) {
+        u32 hash = 5381;
+        for (size_t n = 0; n < length; n++) {
+            hash = ((hash << 5) + hash) + (unsigned char)str[n]; /* hash * 33 + c */
+        }
+        return hash;
+    }
+
+    /// Convert character string to Unsigned 32-bit Hash, at compile time
+    constexpr stringID operator"" _sid(const char* input, size_t s) {
+        return hash_djb2(input, s);
+    }
 
 
     /// Strip string of all line comments (#) as well as block comments (/* */)
@@ -0,0 +1,100 @@
+#include <enpch.hpp>
+#include "Engine/Core/WorkerPool.hpp"
+
+namespace rh {
+
+    WorkerPool::WorkerPool(int numThreads) :
+        m_func(nullptr),
+        m_count(0),
+        m_chunkSize(1),
+        m_next(0),
+        m_generation(0),
+        m_busyWorkers(0),
+        m_quit(false)
+    {
+        if (numThreads <= 0) {
+            numThreads = (int)std::thread::hardware_concurrency();
+            if (numThreads <= 0)
+                numThreads = 1;
+        }
+
+        for (int n = 0; n < numThreads - 1; n++) {
+            m_workers.emplace_back(&WorkerPool::WorkerLoop, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+        m_wake.notify_all();
+
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void WorkerPool::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& func) {
+        if (count == 0)
+            return;
+        if (chunkSize == 0)
+            chunkSize = 1;
+
+        // not worth waking anyone up
+        if (m_workers.empty() || count <= chunkSize) {
+            func(0, count);
+            return;
+        }
+
+        std::lock_guard<std::mutex> submit(m_submitMutex);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_func = &func;
+            m_count = count;
+            m_chunkSize = chunkSize;
+            m_next = 0;
+            m_busyWorkers = (int)m_workers.size();
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        RunChunks();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+        m_func = nullptr;
+    }
+
+    void WorkerPool::WorkerLoop() {
+        u64 seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_quit || m_generation != seen; });
+                if (m_quit)
+                    return;
+                seen = m_generation;
+            }
+
+            RunChunks();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_busyWorkers--;
+            }
+            m_done.notify_one();
+        }
+    }
+
+    void WorkerPool::RunChunks() {
+        while (true) {
+            size_t begin = m_next.fetch_add(m_chunkSize);
+            if (begin >= m_count)
+                return;
+
+            size_t end = std::min(begin + m_chunkSize, m_count);
+            (*m_func)(begin, end);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "Engine/Core/Base.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace rh {
+
+    /// Fixed set of worker threads for data-parallel loops. The calling
+    /// thread works on the loop too, so a pool of N threads has N-1 workers.
+    class WorkerPool {
+    public:
+        /// numThreads = 0 uses every hardware thread
+        WorkerPool(int numThreads = 0);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        /// Calls func(begin, end) over [0, count) in chunks of chunkSize, spread
+        /// across the pool. Blocks until every chunk is done.
+        void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& func);
+
+        int GetNumThreads() const { return (int)m_workers.size() + 1; }
+
+    private:
+        void WorkerLoop();
+        void RunChunks();
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        std::mutex m_submitMutex; // one ParallelFor at a time
+
+        // current job
+        const std::function<void(size_t, size_t)>* m_func;
+        size_t m_count;
+        size_t m_chunkSize;
+        std::atomic<size_t> m_next;
+
+        u64 m_generation;
+        int m_busyWorkers;
+        bool m_quit;
+    };
+}
+
+#endif
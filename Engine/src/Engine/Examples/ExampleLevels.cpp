@@ -378,20 +378,21 @@ namespace rh {
         }
 
         // Ramps at various angles
-        laml::Mat3& rot = cWorld.getHullFromID(cWorld.CreateNewCubeHull(laml::Vec3(5, 0, -5), 10, 1, 3))->rotation;
+        laml::Mat3 rot;
         laml::transform::create_transform_rotation(rot, 0.0f, 10.0f, 0.0f);
+        cWorld.MoveHull(cWorld.CreateNewCubeHull(laml::Vec3(5, 0, -5), 10, 1, 3), laml::Vec3(5, 0, -5), rot);
 
-        rot = cWorld.getHullFromID(cWorld.CreateNewCubeHull(laml::Vec3(5, 1, -2), 10, 1, 3))->rotation;
         laml::transform::create_transform_rotation(rot, 0.0f, 20.0f, 0.0f);
+        cWorld.MoveHull(cWorld.CreateNewCubeHull(laml::Vec3(5, 1, -2), 10, 1, 3), laml::Vec3(5, 1, -2), rot);
 
-        rot = cWorld.getHullFromID(cWorld.CreateNewCubeHull(laml::Vec3(5, 2, 1), 10, 1, 3))->rotation;
         laml::transform::create_transform_rotation(rot, 0.0f, 30.0f, 0.0f);
+        cWorld.MoveHull(cWorld.CreateNewCubeHull(laml::Vec3(5, 2, 1), 10, 1, 3), laml::Vec3(5, 2, 1), rot);
 
-        rot = cWorld.getHullFromID(cWorld.CreateNewCubeHull(laml::Vec3(5, 3, 4), 10, 1, 3))->rotation;
         laml::transform::create_transform_rotation(rot, 0.0f, 40.0f, 0.0f);
+        cWorld.MoveHull(cWorld.CreateNewCubeHull(laml::Vec3(5, 3, 4), 10, 1, 3), laml::Vec3(5, 3, 4), rot);
 
-        rot = cWorld.getHullFromID(cWorld.CreateNewCubeHull(laml::Vec3(5, 3.5, 7), 10, 1, 3))->rotation;
         laml::transform::create_transform_rotation(rot, 0.0f, 50.0f, 0.0f);
+        cWorld.MoveHull(cWorld.CreateNewCubeHull(laml::Vec3(5, 3.5, 7), 10, 1, 3), laml::Vec3(5, 3.5, 7), rot);
 
         // Sound stuff
         {
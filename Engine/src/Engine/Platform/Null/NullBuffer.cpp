@@ -0,0 +1,40 @@
+#include <enpch.hpp>
+#include "NullBuffer.hpp"
+
+#include "NullRendererAPI.hpp"
+
+namespace rh {
+
+    /* Vertex Buffer *************************************************************/
+    NullVertexBuffer::NullVertexBuffer(void* vertices, u32 size) : m_Size(size) {
+        NullRendererAPI::GetStats().bufferBytesUploaded += size;
+    }
+
+    NullVertexBuffer::NullVertexBuffer(u32 size) : m_Size(size) {
+    }
+
+    void NullVertexBuffer::SetData(const void* data, u32 size) {
+        if (size > m_Size)
+            m_Size = size;
+        NullRendererAPI::GetStats().bufferBytesUploaded += size;
+    }
+
+    /* Index Buffer **************************************************************/
+    NullIndexBuffer::NullIndexBuffer(void* indices, u32 count) : m_Count(count) {
+        NullRendererAPI::GetStats().bufferBytesUploaded += count * sizeof(u32);
+    }
+
+    /* Uniform Buffer ************************************************************/
+    NullUniformBuffer::NullUniformBuffer(u32 size) : m_Size(size) {
+    }
+
+    void NullUniformBuffer::SetData(const void* data, u32 size, u32 offset) {
+        ENGINE_LOG_ASSERT(offset + size <= m_Size, "Uniform buffer write out of range");
+        NullRendererAPI::GetStats().bufferBytesUploaded += size;
+    }
+
+    void NullUniformBuffer::BindRange(u32 binding, u32 offset, u32 size) const {
+        ENGINE_LOG_ASSERT(offset % QueryOffsetAlignment() == 0, "Uniform buffer range is not aligned");
+        NullRendererAPI::GetStats().bufferRangeBinds++;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Engine/Renderer/Buffer.hpp"
+
+namespace rh {
+
+    /* Vertex Buffer *************************************************************/
+    class NullVertexBuffer : public VertexBuffer {
+    public:
+        NullVertexBuffer(void* vertices, u32 size);
+        NullVertexBuffer(u32 size);
+        virtual ~NullVertexBuffer() {}
+
+        virtual void Bind() const override {}
+        virtual void Unbind() const override {}
+
+        virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+        virtual const BufferLayout& GetLayout() const override { return m_Layout; }
+
+        virtual void SetData(const void* data, u32 size) override;
+
+    private:
+        u32 m_Size;
+        BufferLayout m_Layout;
+    };
+
+    /* Index Buffer **************************************************************/
+    class NullIndexBuffer : public IndexBuffer {
+    public:
+        NullIndexBuffer(void* indices, u32 count);
+        virtual ~NullIndexBuffer() {}
+
+        virtual void Bind() const override {}
+        virtual void Unbind() const override {}
+        virtual u32 GetCount() const override { return m_Count; }
+
+    private:
+        u32 m_Count;
+    };
+
+    /* Uniform Buffer ************************************************************/
+    class NullUniformBuffer : public UniformBuffer {
+    public:
+        NullUniformBuffer(u32 size);
+        virtual ~NullUniformBuffer() {}
+
+        virtual void SetData(const void* data, u32 size, u32 offset = 0) override;
+        virtual void BindRange(u32 binding, u32 offset, u32 size) const override;
+
+        virtual u32 GetSize() const override { return m_Size; }
+
+        /// Most desktop drivers report 256, so ring layouts come out the same as on GL
+        static u32 QueryOffsetAlignment() { return 256; }
+
+    private:
+        u32 m_Size;
+    };
+
+}
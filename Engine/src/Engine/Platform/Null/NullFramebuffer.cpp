@@ -0,0 +1,36 @@
+#include <enpch.hpp>
+#include "NullFramebuffer.hpp"
+
+#include "NullRendererAPI.hpp"
+
+namespace rh {
+
+    NullFramebuffer::NullFramebuffer(const FramebufferSpecification& spec) 
+        : m_Specification(spec) {
+    }
+
+    void NullFramebuffer::Resize(u32 width, u32 height) {
+        m_Specification.Width = width;
+        m_Specification.Height = height;
+    }
+
+    void NullFramebuffer::Bind() const {
+        // binding also sets the viewport, same as OpenGLFramebuffer
+        NullRendererAPI::GetStats().framebufferBinds++;
+        NullRendererAPI::GetStats().stateChanges++;
+    }
+
+    void NullFramebuffer::Unbind() const {
+        NullRendererAPI::GetStats().framebufferBinds++;
+    }
+
+    void NullFramebuffer::ClearBuffers() const {
+        NullRendererAPI::GetStats().clears++;
+    }
+
+    void NullFramebuffer::BindTexture(u32 attachmentIndex, u32 slot) const {
+        ENGINE_LOG_ASSERT(m_Specification.SwapChainTarget || attachmentIndex < m_Specification.Attachments.Attachments.size(), 
+            "Framebuffer attachment out of range");
+        NullRendererAPI::GetStats().textureBinds++;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Engine/Renderer/Framebuffer.hpp"
+
+namespace rh {
+
+    class NullFramebuffer : public Framebuffer {
+    public:
+        NullFramebuffer(const FramebufferSpecification& spec);
+        virtual ~NullFramebuffer() {}
+
+        virtual void Resize(u32 width, u32 height) override;
+
+        virtual void Bind() const override;
+        virtual void Unbind() const override;
+
+        virtual void ClearBuffers() const override;
+        virtual void BindTexture(u32 attachmentIndex = 0, u32 slot = 0) const override;
+
+        virtual u32 GetWidth() const override { return m_Specification.Width; }
+        virtual u32 GetHeight() const override { return m_Specification.Height; }
+
+        virtual u32 GetID() const override { return 0; }
+        virtual u32 GetColorAttachmentID(int index = 0) const override { return 0; };
+        virtual u32 GetDepthAttachmentID(int index = 0) const override { return 0; }
+
+        virtual const FramebufferSpecification& GetSpecification() const override { return m_Specification; }
+
+    private:
+        FramebufferSpecification m_Specification;
+    };
+
+}
@@ -0,0 +1,84 @@
+#include <enpch.hpp>
+#include "NullRendererAPI.hpp"
+
+namespace rh {
+
+    NullRendererStats NullRendererAPI::s_Stats = {};
+
+    void NullRendererAPI::ResetStats() {
+        s_Stats = {};
+    }
+
+    void NullRendererAPI::SetClearColor(const laml::Vec4& color) {
+        s_Stats.stateChanges++;
+    }
+
+    void NullRendererAPI::Clear() {
+        s_Stats.clears++;
+    }
+
+    void NullRendererAPI::Init() {
+        ENGINE_LOG_WARN("Using the null renderer, nothing will be drawn");
+        ResetStats();
+    }
+
+    void NullRendererAPI::Shutdown() {
+    }
+
+    void NullRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, bool depth_test) {
+        s_Stats.drawCalls++;
+        s_Stats.elements += vertexArray->GetIndexBuffer()->GetCount();
+        if (!depth_test)
+            s_Stats.stateChanges += 2;
+    }
+
+    void NullRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, bool depth_test) {
+        s_Stats.drawCalls++;
+        s_Stats.elements += vertexArray->GetIndexBuffer()->GetCount();
+        if (!depth_test)
+            s_Stats.stateChanges += 2;
+    }
+
+    void NullRendererAPI::DrawLineArray(u32 startVertex, u32 vertexCount) {
+        s_Stats.drawCalls++;
+        s_Stats.elements += vertexCount;
+    }
+
+    void NullRendererAPI::DrawSubIndexed_points(u32 startIndex, u32 startVertex, u32 count) {
+        s_Stats.drawCalls++;
+        s_Stats.elements += count;
+    }
+
+    void NullRendererAPI::DrawSubIndexed(u32 startIndex, u32 startVertex, u32 count) {
+        s_Stats.drawCalls++;
+        s_Stats.elements += count;
+    }
+
+    void NullRendererAPI::DrawSubIndexedInstanced(u32 startIndex, u32 startVertex, u32 count, u32 instanceCount) {
+        s_Stats.drawCalls++;
+        s_Stats.instancedDrawCalls++;
+        s_Stats.instances += instanceCount;
+        s_Stats.elements += (u64)count * instanceCount;
+    }
+
+    void NullRendererAPI::SetViewport(u32 x, u32 y, u32 width, u32 height) {
+        s_Stats.stateChanges++;
+    }
+
+    void NullRendererAPI::SetCullFace(int face) {
+        ENGINE_LOG_ASSERT(face >= -1 && face <= 1, "Not a valid face cull option");
+        s_Stats.stateChanges++;
+    }
+
+    void NullRendererAPI::SetDepthTest(bool enabled) {
+        s_Stats.stateChanges++;
+    }
+
+    void NullRendererAPI::SetWireframe(bool enabled) {
+        s_Stats.stateChanges++;
+    }
+
+    u32 NullRendererAPI::GetMaxTextureSlots() {
+        return 16; // the minimum GL guarantees, so batching matches the weakest real device
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Engine/Renderer/RendererAPI.hpp"
+
+namespace rh {
+
+    /// Work the null backend was asked to do since the last ResetStats()
+    struct NullRendererStats {
+        u64 drawCalls;
+        u64 instancedDrawCalls;
+        u64 instances;
+        u64 elements;           // indices/vertices submitted by draws
+        u64 stateChanges;       // clear color, viewport, culling, depth test, wireframe
+        u64 clears;
+        u64 shaderBinds;
+        u64 vertexArrayBinds;
+        u64 framebufferBinds;
+        u64 textureBinds;
+        u64 bufferRangeBinds;   // uniform buffer ranges attached to a binding point
+        u64 uniformSets;        // single uniform values, material uniforms included
+        u64 bufferBytesUploaded;
+        u64 textureBytesUploaded;
+    };
+
+    /// Backend that records what it is asked to do instead of talking to a GPU.
+    /// Select it with RenderCommand::SetAPI(RendererAPI::API::Null) before Renderer::Init
+    /// to build and measure frames on machines without a graphics context.
+    class NullRendererAPI : public RendererAPI {
+    public:
+        virtual void SetClearColor(const laml::Vec4& color) override;
+        virtual void Clear() override;
+
+        virtual void Init() override;
+        virtual void Shutdown() override;
+
+        virtual void DrawLines(const Ref<VertexArray>& vertexArray, bool depth_test) override;
+        virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, bool depth_test) override;
+        virtual void DrawLineArray(u32 startVertex, u32 vertexCount) override;
+        virtual void DrawSubIndexed_points(u32 startIndex, u32 startVertex, u32 count) override;
+        virtual void DrawSubIndexed(u32 startIndex, u32 startVertex, u32 count) override;
+        virtual void DrawSubIndexedInstanced(u32 startIndex, u32 startVertex, u32 count, u32 instanceCount) override;
+        virtual void SetViewport(u32 x, u32 y, u32 width, u32 height) override;
+
+        virtual void SetCullFace(int face) override;
+        virtual void SetDepthTest(bool enabled) override;
+        virtual void SetWireframe(bool enabled) override;
+
+        virtual u32 GetMaxTextureSlots() override;
+
+        /// Counters shared by every null resource
+        static NullRendererStats& GetStats() { return s_Stats; }
+        static void ResetStats();
+
+    private:
+        static NullRendererStats s_Stats;
+    };
+}
@@ -0,0 +1,63 @@
+#include <enpch.hpp>
+#include "NullShader.hpp"
+
+#include "NullRendererAPI.hpp"
+
+namespace rh {
+
+    NullShader::NullShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc)
+        : GLSLShader(name, vertexSrc, fragmentSrc) {
+        Reflect();
+    }
+
+    NullShader::NullShader(const std::string& path) 
+        : GLSLShader(path) {
+        Reflect();
+    }
+
+    void NullShader::Reload() {
+        ReadSource(m_filepath);
+        Reflect();
+    }
+
+    void NullShader::Bind() const {
+        NullRendererAPI::GetStats().shaderBinds++;
+    }
+
+    void NullShader::SetFloat(const std::string &name, f32 value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetInt(const std::string &name, s32 value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetVec2(const std::string &name, const laml::Vec2& value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetVec3(const std::string &name, const laml::Vec3& value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetVec4(const std::string &name, const laml::Vec4& value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetMat4(const std::string &name, const laml::Mat4& value) const { NullRendererAPI::GetStats().uniformSets++; }
+
+    void NullShader::SetFloat(stringID name, f32 value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetInt(stringID name, s32 value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetVec2(stringID name, const laml::Vec2& value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetVec3(stringID name, const laml::Vec3& value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetVec4(stringID name, const laml::Vec4& value) const { NullRendererAPI::GetStats().uniformSets++; }
+    void NullShader::SetMat4(stringID name, const laml::Mat4& value) const { NullRendererAPI::GetStats().uniformSets++; }
+
+    // material uploads set every declared uniform, or only the overridden ones
+    void NullShader::SetVertUniformBuffer(Buffer buffer) {
+        NullRendererAPI::GetStats().uniformSets += GetVertUniformGroup().GetUniformDeclarations().size();
+    }
+
+    void NullShader::SetFragUniformBuffer(Buffer buffer) {
+        NullRendererAPI::GetStats().uniformSets += GetFragUniformGroup().GetUniformDeclarations().size();
+    }
+
+    void NullShader::SetVertUniformBuffer(Buffer buffer, const std::unordered_set<std::string>& overrides) {
+        for (const auto* uniform : GetVertUniformGroup().GetUniformDeclarations()) {
+            if (overrides.find(uniform->GetName()) != overrides.end())
+                NullRendererAPI::GetStats().uniformSets++;
+        }
+    }
+
+    void NullShader::SetFragUniformBuffer(Buffer buffer, const std::unordered_set<std::string>& overrides) {
+        for (const auto* uniform : GetFragUniformGroup().GetUniformDeclarations()) {
+            if (overrides.find(uniform->GetName()) != overrides.end())
+                NullRendererAPI::GetStats().uniformSets++;
+        }
+    }
+}
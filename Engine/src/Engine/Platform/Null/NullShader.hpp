@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Engine/Renderer/GLSLShader.hpp"
+
+namespace rh {
+
+    /// Reflects the GLSL source exactly like OpenGLShader, so materials get the same
+    /// uniform and sampler layout, but never compiles it. Binds and uniform
+    /// uploads are only counted.
+    class NullShader : public GLSLShader {
+    public:
+        NullShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
+        NullShader(const std::string& path);
+        virtual ~NullShader() {}
+
+        virtual void Bind() const override;
+        virtual void UnBind() const override {}
+        virtual void Reload() override;
+
+        virtual void SetFloat(const std::string &name, f32 value) const override;
+        virtual void SetInt(const std::string &name, s32 value) const override;
+        virtual void SetVec2(const std::string &name, const laml::Vec2& value) const override;
+        virtual void SetVec3(const std::string &name, const laml::Vec3& value) const override;
+        virtual void SetVec4(const std::string &name, const laml::Vec4& value) const override;
+        virtual void SetMat4(const std::string &name, const laml::Mat4& value) const override;
+
+        virtual void SetFloat(stringID name, f32 value) const override;
+        virtual void SetInt(stringID name, s32 value) const override;
+        virtual void SetVec2(stringID name, const laml::Vec2& value) const override;
+        virtual void SetVec3(stringID name, const laml::Vec3& value) const override;
+        virtual void SetVec4(stringID name, const laml::Vec4& value) const override;
+        virtual void SetMat4(stringID name, const laml::Mat4& value) const override;
+
+        virtual void SetVertUniformBuffer(Buffer buffer) override;
+        virtual void SetFragUniformBuffer(Buffer buffer) override;
+        virtual void SetVertUniformBuffer(Buffer buffer, const std::unordered_set<std::string>& overrides) override;
+        virtual void SetFragUniformBuffer(Buffer buffer, const std::unordered_set<std::string>& overrides) override;
+    };
+}
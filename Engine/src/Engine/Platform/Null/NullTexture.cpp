@@ -0,0 +1,50 @@
+#include <enpch.hpp>
+#include "NullTexture.hpp"
+
+#include "NullRendererAPI.hpp"
+
+#include <stb_image.h>
+
+namespace rh {
+
+    /* Texture2D *******************************************/
+    NullTexture2D::NullTexture2D(const std::string& path) {
+        int width = 0, height = 0, channels = 0;
+        int success = stbi_info(path.c_str(), &width, &height, &channels);
+        ENGINE_LOG_ASSERT(success, "Failed to load image file");
+        m_Width = width;
+        m_Height = height;
+
+        NullRendererAPI::GetStats().textureBytesUploaded += (u64)width * height * channels;
+    }
+
+    NullTexture2D::NullTexture2D(const unsigned char* bitmap, u32 res) {
+        ENGINE_LOG_ASSERT(bitmap, "Bad data passed to NullTexture2D");
+        m_Width = res;
+        m_Height = res;
+
+        NullRendererAPI::GetStats().textureBytesUploaded += (u64)res * res;
+    }
+
+    void NullTexture2D::Bind(u32 slot) const {
+        NullRendererAPI::GetStats().textureBinds++;
+    }
+
+    /* TextureCube ****************************************************************************/
+
+    // same 'cube-cross' layout as OpenGLTextureCube, six faces of RGB8
+    NullTextureCube::NullTextureCube(const std::string& path) {
+        int width = 0, height = 0, channels = 0;
+        int success = stbi_info(path.c_str(), &width, &height, &channels);
+        ENGINE_LOG_ASSERT(success, "Failed to load image file");
+        m_Width = width;
+        m_Height = height;
+
+        u64 faceWidth = m_Width / 4;
+        NullRendererAPI::GetStats().textureBytesUploaded += 6 * faceWidth * faceWidth * 3;
+    }
+
+    void NullTextureCube::Bind(u32 slot) const {
+        NullRendererAPI::GetStats().textureBinds++;
+    }
+}
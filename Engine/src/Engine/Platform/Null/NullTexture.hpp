@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Engine/Renderer/Texture.hpp"
+
+namespace rh {
+
+    /// Only reads the image header for its size, the pixels are never decoded
+    class NullTexture2D : public Texture2D {
+    public:
+        NullTexture2D(const std::string& path);
+        NullTexture2D(const unsigned char* bitmap, u32 res);
+        virtual ~NullTexture2D() {}
+
+        virtual void Bind(u32 slot = 0) const override;
+        virtual u32 GetID() const override { return 0; }
+
+        virtual u32 GetWidth() const override { return m_Width; }
+        virtual u32 GetHeight() const override { return m_Height; }
+
+    private:
+        u32 m_Width;
+        u32 m_Height;
+    };
+
+    class NullTextureCube : public TextureCube {
+    public:
+        NullTextureCube(const std::string& path);
+        virtual ~NullTextureCube() {}
+
+        virtual void Bind(u32 slot = 0) const override;
+        virtual u32 GetID() const override { return 0; }
+
+        virtual u32 GetWidth() const override { return m_Width; }
+        virtual u32 GetHeight() const override { return m_Height; }
+
+    private:
+        u32 m_Width;
+        u32 m_Height;
+    };
+}
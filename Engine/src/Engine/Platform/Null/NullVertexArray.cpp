@@ -0,0 +1,16 @@
+#include <enpch.hpp>
+#include "NullVertexArray.hpp"
+
+#include "NullRendererAPI.hpp"
+
+namespace rh {
+
+    void NullVertexArray::Bind() const {
+        NullRendererAPI::GetStats().vertexArrayBinds++;
+    }
+
+    void NullVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) {
+        ENGINE_LOG_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "VertexBuffer has no layout");
+        m_VertexBuffers.push_back(vertexBuffer);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Engine/Renderer/VertexArray.hpp"
+
+namespace rh {
+
+    class NullVertexArray : public VertexArray {
+    public:
+        NullVertexArray() {}
+        virtual ~NullVertexArray() {}
+
+        virtual void Bind() const override;
+        virtual void Unbind() const override {}
+
+        virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) override;
+        virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override { m_IndexBuffer = indexBuffer; }
+
+        virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; };
+        virtual const Ref<IndexBuffer>& GetIndexBuffer() const override { return m_IndexBuffer; };
+
+    private:
+        std::vector<Ref<VertexBuffer>> m_VertexBuffers;
+        Ref<IndexBuffer> m_IndexBuffer;
+    };
+}
@@ -6,12 +6,32 @@
 namespace rh {
 
     /* Vertex Buffer *************************************************************/
-    OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, u32 size) {
+    OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, u32 size) 
+        : m_Size(size) {
         glCreateBuffers(1, &m_BufferID);
         glBindBuffer(GL_ARRAY_BUFFER, m_BufferID);
         glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
     }
 
+    OpenGLVertexBuffer::OpenGLVertexBuffer(u32 size) 
+        : m_Size(size) {
+        glCreateBuffers(1, &m_BufferID);
+        glBindBuffer(GL_ARRAY_BUFFER, m_BufferID);
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    void OpenGLVertexBuffer::SetData(const void* data, u32 size) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_BufferID);
+        if (size > m_Size) {
+            m_Size = size;
+            glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
+        } else {
+            // orphan the old storage so we don't wait on draws still reading it
+            glBufferData(GL_ARRAY_BUFFER, m_Size, nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+        }
+    }
+
     OpenGLVertexBuffer::~OpenGLVertexBuffer() {
         glDeleteBuffers(1, &m_BufferID);
     }
@@ -42,4 +62,33 @@ namespace rh {
     void OpenGLIndexBuffer::Unbind() const {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
+
+
+    /* Uniform Buffer ************************************************************/
+    OpenGLUniformBuffer::OpenGLUniformBuffer(u32 size)
+        : m_Size(size) {
+        glCreateBuffers(1, &m_BufferID);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+        glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    u32 OpenGLUniformBuffer::QueryOffsetAlignment() {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        return alignment > 0 ? (u32)alignment : 256;
+    }
+
+    OpenGLUniformBuffer::~OpenGLUniformBuffer() {
+        glDeleteBuffers(1, &m_BufferID);
+    }
+
+    void OpenGLUniformBuffer::SetData(const void* data, u32 size, u32 offset) {
+        ENGINE_LOG_ASSERT(offset + size <= m_Size, "Uniform buffer write out of range");
+        glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    }
+
+    void OpenGLUniformBuffer::BindRange(u32 binding, u32 offset, u32 size) const {
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_BufferID, offset, size);
+    }
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ namespace rh {
     class OpenGLVertexBuffer : public VertexBuffer {
     public:
         OpenGLVertexBuffer(void* vertices, u32 size);
+        OpenGLVertexBuffer(u32 size);
         virtual ~OpenGLVertexBuffer();
 
         virtual void Bind() const override;
@@ -16,8 +17,11 @@ namespace rh {
         virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
         virtual const BufferLayout& GetLayout() const override { return m_Layout; }
 
+        virtual void SetData(const void* data, u32 size) override;
+
     private:
         u32 m_BufferID;
+        u32 m_Size;
         BufferLayout m_Layout;
     };
 
@@ -36,4 +40,22 @@ namespace rh {
         u32 m_Count;
     };
 
+    /* Uniform Buffer ************************************************************/
+    class OpenGLUniformBuffer : public UniformBuffer {
+    public:
+        OpenGLUniformBuffer(u32 size);
+        virtual ~OpenGLUniformBuffer();
+
+        virtual void SetData(const void* data, u32 size, u32 offset = 0) override;
+        virtual void BindRange(u32 binding, u32 offset, u32 size) const override;
+
+        virtual u32 GetSize() const override { return m_Size; }
+
+        static u32 QueryOffsetAlignment();
+
+    private:
+        u32 m_BufferID;
+        u32 m_Size;
+    };
+
 }
\ No newline at end of file
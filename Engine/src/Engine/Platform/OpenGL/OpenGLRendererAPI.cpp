@@ -69,10 +69,16 @@ namespace rh {
     void OpenGLRendererAPI::DrawSubIndexed_points(u32 startIndex, u32 startVertex, u32 count) {
         glDrawElements(GL_POINTS, count, GL_UNSIGNED_INT, (void*)(sizeof(GLuint) * startIndex));
     }
+    void OpenGLRendererAPI::DrawLineArray(u32 startVertex, u32 vertexCount) {
+        glDrawArrays(GL_LINES, startVertex, vertexCount);
+    }
     void OpenGLRendererAPI::DrawSubIndexed(u32 startIndex, u32 startVertex, u32 count) {
         //glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)(sizeof(uint32_t) * startIndex), startVertex);
         glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)(sizeof(GLuint) * startIndex));
     }
+    void OpenGLRendererAPI::DrawSubIndexedInstanced(u32 startIndex, u32 startVertex, u32 count, u32 instanceCount) {
+        glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)(sizeof(GLuint) * startIndex), instanceCount);
+    }
 
     void OpenGLRendererAPI::SetViewport(u32 x, u32 y, u32 width, u32 height) {
         glViewport(x, y, width, height);
@@ -103,4 +109,10 @@ namespace rh {
         if (enabled) glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
         else         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     }
+
+    u32 OpenGLRendererAPI::GetMaxTextureSlots() {
+        GLint slots = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &slots);
+        return slots > 0 ? (u32)slots : 16; // GL guarantees at least 16
+    }
 }
\ No newline at end of file
@@ -14,12 +14,16 @@ namespace rh {
 
         virtual void DrawLines(const Ref<VertexArray>& vertexArray, bool depth_test) override;
         virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, bool depth_test) override;
+        virtual void DrawLineArray(u32 startVertex, u32 vertexCount) override;
         virtual void DrawSubIndexed_points(u32 startIndex, u32 startVertex, u32 count) override;
         virtual void DrawSubIndexed(u32 startIndex, u32 startVertex, u32 count) override;
+        virtual void DrawSubIndexedInstanced(u32 startIndex, u32 startVertex, u32 count, u32 instanceCount) override;
         virtual void SetViewport(u32 x, u32 y, u32 width, u32 height) override;
 
         virtual void SetCullFace(int face) override;
         virtual void SetDepthTest(bool enabled) override;
         virtual void SetWireframe(bool enabled) override;
+
+        virtual u32 GetMaxTextureSlots() override;
     };
 }
@@ -1,67 +1,48 @@
 #include <enpch.hpp>
 #include "OpenGLShader.hpp"
 
-#include <fstream>
+#include "Engine/Core/Utils.hpp"
+
 #include <glad/glad.h>
 
 namespace rh {
 
-    static GLenum ShaderTypeFromString(const std::string& type) {
-        if (type == "vertex")
-            return GL_VERTEX_SHADER;
-        if (type == "fragment" || type == "pixel")
-            return GL_FRAGMENT_SHADER;
-        if (type == "geometry")
-            return GL_GEOMETRY_SHADER;
+    static GLenum ShaderDomainToGL(ShaderDomain domain) {
+        switch (domain) {
+            case ShaderDomain::Vertex:   return GL_VERTEX_SHADER;
+            case ShaderDomain::Fragment: return GL_FRAGMENT_SHADER;
+            case ShaderDomain::Geometry: return GL_GEOMETRY_SHADER;
+        }
 
         ENGINE_LOG_ASSERT(false, "Unknown shader type");
         return 0;
     }
 
-    OpenGLShader::OpenGLShader(const std::string& path) : m_Loaded(false), m_filepath(path) {
-        std::string source = ReadFile(path);
-        m_ShaderSources = PreProcess(source);
-
-        // Data/Shaders/simple.glsl
-        auto lastSlash = path.find_last_of("/\\");
-        lastSlash = lastSlash == std::string::npos ? 0 : lastSlash + 1;
-        auto lastDot = path.rfind('.');
-        auto count = lastDot == std::string::npos ? path.size() - lastSlash : lastDot - lastSlash;
-
-        m_Name = path.substr(lastSlash, count);
-
+    OpenGLShader::OpenGLShader(const std::string& path) 
+            : GLSLShader(path), m_ShaderID(0), m_Loaded(false) {
         CompileAndValidate();
     }
 
-    OpenGLShader::OpenGLShader(const std::string& name,  const std::string& vertexSrc, const std::string& fragmentSrc) 
-            : m_Name(name), m_filepath("Error, no path given") {
-        m_ShaderSources[GL_VERTEX_SHADER] = vertexSrc;
-        m_ShaderSources[GL_FRAGMENT_SHADER] = fragmentSrc;
-
+    OpenGLShader::OpenGLShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc) 
+            : GLSLShader(name, vertexSrc, fragmentSrc), m_ShaderID(0), m_Loaded(false) {
         CompileAndValidate();
     }
 
     void OpenGLShader::Reload() {
         m_Loaded = false;
-        std::string source = ReadFile(m_filepath);
-        m_ShaderSources = PreProcess(source);
+        ReadSource(m_filepath);
 
         CompileAndValidate();
     }
 
     void OpenGLShader::CompileAndValidate() {
-        // clear existing data if exists
-        m_Samplers.clear();
-        m_Structs.clear();
-        if (m_FragUniformGroup)   m_FragUniformGroup->Reset();
-        if (m_VertexUniformGroup) m_VertexUniformGroup->Reset();
-
         // cpu side
-        IdentifyUniforms();
+        Reflect();
 
         // gpu side
         Compile();
 
+        CacheUniformLocations();
         ValidateUniforms();
 
         if (m_Loaded) {
@@ -72,14 +53,8 @@ namespace rh {
     }
 
     OpenGLShader::~OpenGLShader() {
-        glDeleteProgram(m_ShaderID);
-
-        for (auto sampler : m_Samplers) {
-            auto samplerCast = static_cast<OpenGLShaderSamplerDeclaration*>(sampler);
-
-            delete samplerCast;
-            samplerCast = 0;
-        }
+        if (m_ShaderID)
+            glDeleteProgram(m_ShaderID);
     }
 
     void OpenGLShader::ValidateUniforms() {
@@ -91,14 +66,14 @@ namespace rh {
             if (decl) {
                 const std::vector<ShaderUniformDeclaration*>& uniformList = decl->GetUniformDeclarations();
                 for (int n = 0; n < uniformList.size(); n++) {
-                    OpenGLShaderUniformDeclaration* uniform = (OpenGLShaderUniformDeclaration*)uniformList[n];
+                    GLSLShaderUniformDeclaration* uniform = (GLSLShaderUniformDeclaration*)uniformList[n];
 
-                    if (uniform->GetType() == OpenGLShaderUniformDeclaration::Type::STRUCT) {
+                    if (uniform->GetType() == GLSLShaderUniformDeclaration::Type::STRUCT) {
                         // parse the struct fields
                         const ShaderStruct& s = *uniform->m_Struct;
                         const auto& fields = s.GetFields();
                         for (int k = 0; k < fields.size(); k++) {
-                            OpenGLShaderUniformDeclaration* field = (OpenGLShaderUniformDeclaration*)fields[k];
+                            GLSLShaderUniformDeclaration* field = (GLSLShaderUniformDeclaration*)fields[k];
                             field->SetLocation(GetUniformLocation(uniform->m_Name + "." + field->m_Name));
                         }
                     }
@@ -122,14 +97,14 @@ namespace rh {
             if (decl) {
                 const std::vector<ShaderUniformDeclaration*>& uniformList = decl->GetUniformDeclarations();
                 for (int n = 0; n < uniformList.size(); n++) {
-                    OpenGLShaderUniformDeclaration* uniform = (OpenGLShaderUniformDeclaration*)uniformList[n];
+                    GLSLShaderUniformDeclaration* uniform = (GLSLShaderUniformDeclaration*)uniformList[n];
 
-                    if (uniform->GetType() == OpenGLShaderUniformDeclaration::Type::STRUCT) {
+                    if (uniform->GetType() == GLSLShaderUniformDeclaration::Type::STRUCT) {
                         // parse the struct fields
                         const ShaderStruct& s = *uniform->m_Struct;
                         const auto& fields = s.GetFields();
                         for (int k = 0; k < fields.size(); k++) {
-                            OpenGLShaderUniformDeclaration* field = (OpenGLShaderUniformDeclaration*)fields[k];
+                            GLSLShaderUniformDeclaration* field = (GLSLShaderUniformDeclaration*)fields[k];
                             field->SetLocation(GetUniformLocation(uniform->m_Name + "." + field->m_Name));
                         }
                     }
@@ -141,20 +116,15 @@ namespace rh {
         }
 
         // validate Sampler uniforms
-        u32 samplerID = 0;
         for (int n = 0; n < m_Samplers.size(); n++) {
-            OpenGLShaderSamplerDeclaration* sampler = (OpenGLShaderSamplerDeclaration*)m_Samplers[n];
+            GLSLShaderSamplerDeclaration* sampler = (GLSLShaderSamplerDeclaration*)m_Samplers[n];
             s32 loc = GetUniformLocation(sampler->m_Name);
 
             if (sampler->GetCount() == 1) {
-                sampler->m_ID = samplerID;
                 if (loc != -1)
-                    glUniform1i(loc, samplerID);
-
-                samplerID++;
+                    glUniform1i(loc, sampler->m_ID);
             }
             else if (sampler->GetCount() > 1) {
-                sampler->m_ID = 0;
                 uint32_t count = sampler->GetCount();
                 int* samplers = new int[count];
                 for (uint32_t s = 0; s < count; s++)
@@ -166,36 +136,75 @@ namespace rh {
         }
     }
 
-    std::unordered_map<GLenum, std::string> OpenGLShader::PreProcess(const std::string& source) {
-        std::unordered_map<GLenum, std::string> shaderSources;
-
-        const char* typeToken = "#type";
-        size_t typeTokenLength = strlen(typeToken);
-        size_t pos = source.find(typeToken, 0);
-        while (pos != std::string::npos) {
-            size_t eol = source.find_first_of("\r\n", pos);
-            ENGINE_LOG_ASSERT(eol != std::string::npos, "Syntax error");
-            size_t begin = pos + typeTokenLength + 1;
-            std::string type = source.substr(begin, eol - begin);
-            ENGINE_LOG_ASSERT(type == "vertex" || type == "fragment" || type == "pixel" || type == "geometry", "Invalid shader type specified");
+    s32 OpenGLShader::GetUniformLocation(const std::string & name) const
+    {
+        return GetUniformLocation(hash_djb2(name.c_str(), name.size()));
+    }
 
-            size_t nextLinePos = source.find_first_not_of("\r\n", eol);
-            pos = source.find(typeToken, nextLinePos);
-            shaderSources[ShaderTypeFromString(type)] = 
-                source.substr(nextLinePos, pos - (nextLinePos == std::string::npos ? source.size() - 1 : nextLinePos));
+    s32 OpenGLShader::GetUniformLocation(stringID name) const
+    {
+        auto it = m_UniformLocations.find(name);
+        if (it == m_UniformLocations.end()) {
+            // not an active uniform, same as glGetUniformLocation returning -1
+            return -1;
         }
 
-        return shaderSources;
+        return it->second;
     }
 
-    s32 OpenGLShader::GetUniformLocation(const std::string & name) const
-    {
+    void OpenGLShader::AddUniformLocation(const std::string& name) {
         s32 loc = glGetUniformLocation(m_ShaderID, name.c_str());
-        if (loc == -1) {
-            //ENGINE_LOG_WARN("Could not find uniform '{0}' in shader", name);
+        s_UniformLookupCount++;
+        if (loc == -1)
+            return;
+
+        stringID id = hash_djb2(name.c_str(), name.size());
+        auto res = m_UniformLocations.emplace(id, loc);
+        if (!res.second && res.first->second != loc) {
+            ENGINE_LOG_ERROR("Uniform name hash collision on '{0}' in shader {1}", name, m_Name);
         }
+    }
+
+    void OpenGLShader::CacheUniformLocations() {
+        // Resolve every active uniform once, so the setters never have to ask GL by name
+        m_UniformLocations.clear();
 
-        return loc;
+        GLint numUniforms = 0, maxLength = 0;
+        glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORMS, &numUniforms);
+        glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        if (numUniforms <= 0 || maxLength <= 0)
+            return;
+
+        std::vector<GLchar> buffer(maxLength);
+        for (GLint n = 0; n < numUniforms; n++) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(m_ShaderID, n, maxLength, &length, &size, &type, buffer.data());
+            std::string name(buffer.data(), length);
+
+            // uniform block members have no location, they are set through a UniformBuffer
+            GLuint index = (GLuint)n;
+            GLint blockIndex = -1;
+            glGetActiveUniformsiv(m_ShaderID, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+            if (blockIndex != -1)
+                continue;
+
+            // arrays of basic types are reported once as "name[0]".
+            // register "name" and each element "name[i]".
+            // members of struct arrays are reported individually.
+            size_t bracket = name.size() > 3 ? name.size() - 3 : std::string::npos;
+            if (bracket != std::string::npos && name.compare(bracket, 3, "[0]") == 0) {
+                std::string base = name.substr(0, bracket);
+                AddUniformLocation(base);
+                for (GLint k = 0; k < size; k++) {
+                    AddUniformLocation(base + "[" + std::to_string(k) + "]");
+                }
+            }
+            else {
+                AddUniformLocation(name);
+            }
+        }
     }
 
     void OpenGLShader::Compile() {
@@ -206,7 +215,7 @@ namespace rh {
         int idx = 0;
 
         for (auto& kv : m_ShaderSources) {
-            GLenum type = kv.first;
+            GLenum type = ShaderDomainToGL(kv.first);
             const std::string& source = kv.second;
 
             GLuint shader = glCreateShader(type);
@@ -271,22 +280,6 @@ namespace rh {
         m_ShaderID = program;
     }
 
-    std::string OpenGLShader::ReadFile(const std::string& path) {
-        std::string result;
-        std::ifstream in(path, std::ios::in | std::ios::binary);
-        if (in) {
-            in.seekg(0, std::ios::end);
-            result.resize(in.tellg());
-            in.seekg(0, std::ios::beg);
-            in.read(&result[0], result.size());
-            in.close();
-        }
-        else {
-            ENGINE_LOG_ERROR("Could not open file: {0}", path);
-        }
-        return result;
-    }
-
     void OpenGLShader::Bind() const {
         glUseProgram(m_ShaderID);
     }
@@ -295,314 +288,6 @@ namespace rh {
         glUseProgram(0);
     }
 
-    // Parsing helper functions
-    const char* FindToken(const char* str, const std::string& token)
-    {
-        const char* t = str;
-        while (t = strstr(t, token.c_str()))
-        {
-            bool left = str == t || isspace(t[-1]);
-            bool right = !t[token.size()] || isspace(t[token.size()]);
-            if (left && right)
-                return t;
-
-            t += token.size();
-        }
-        return nullptr;
-    }
-
-    std::string GetStatement(const char* str, const char** outPosition)
-    {
-        const char* end = strstr(str, ";");
-        if (!end)
-            return str;
-
-        if (outPosition)
-            *outPosition = end;
-        uint32_t length = end - str + 1;
-        return std::string(str, length);
-    }
-
-    std::string GetBlock(const char* str, const char** outPosition)
-    {
-        const char* end = strstr(str, "}");
-        if (!end)
-            return str;
-
-        if (outPosition)
-            *outPosition = end;
-        uint32_t length = end - str + 1;
-        return std::string(str, length);
-    }
-
-    std::vector<std::string> SplitString(const std::string& string, const std::string& delimiters) {
-        size_t start = 0;
-        size_t end = string.find_first_of(delimiters);
-
-        std::vector<std::string> result;
-
-        while (end <= std::string::npos)
-        {
-            std::string token = string.substr(start, end - start);
-            if (!token.empty())
-                result.push_back(token);
-
-            if (end == std::string::npos)
-                break;
-
-            start = end + 1;
-            end = string.find_first_of(delimiters, start);
-        }
-
-        return result;
-    }
-
-    ShaderStruct* OpenGLShader::FindStruct(const std::string& structName) const {
-        for (ShaderStruct* s : m_Structs)
-        {
-            if (s->GetName() == structName)
-                return s;
-        }
-        return nullptr;
-    }
-
-    void OpenGLShader::ParseUniform(const std::string& statement, ShaderDomain domain) {
-        ///ENGINE_LOG_TRACE("Shader parsing uniform statement: ({0})", statement);
-        // read the uniform and determine how much data to allocate in the buffer
-
-        // split by all whitespace and newline characters
-        std::vector<std::string> tokens = SplitString(statement, " \t\r\n");
-        
-        uint32_t index = 0;
-
-        // tokens[0] should be uniform
-        // tokens[1] should be the type (float, vec3, mat4, etc...)
-        // tokens[2] should be the variable name (u_color) (still has the ; at the end)
-
-        ENGINE_LOG_ASSERT(tokens[0] == "uniform", "First token should be 'uniform'");
-        std::string typeString = tokens[1];
-        ENGINE_LOG_ASSERT(tokens[2][tokens[2].size()-1] == ';', "Statement should end in a ';'");
-        std::string varName = tokens[2].substr(0, tokens[2].size() - 1);
-
-        // if uniform is an array, it still hase the [x] at the end of the varName
-        std::string varName_tmp(varName);
-        int32_t arrCount = 1;
-        const char* namestr_tmp = varName_tmp.c_str();
-        if (const char* s = strstr(namestr_tmp, "["))
-        {
-            varName = std::string(namestr_tmp, s - namestr_tmp);
-
-            const char* end = strstr(namestr_tmp, "]");
-            std::string c(s + 1, end - s);
-            arrCount = atoi(c.c_str());
-        }
-
-        if (typeString == "sampler2D" || typeString == "samplerCube") {
-            ShaderSamplerDeclaration* decl = new OpenGLShaderSamplerDeclaration(OpenGLShaderSamplerDeclaration::StringToType(typeString), varName, arrCount);
-            m_Samplers.push_back(decl);
-        }
-        else {
-            // Can now store a uniform of type typeString, called varName, with a count of arrCount
-            OpenGLShaderUniformDeclaration::Type type = OpenGLShaderUniformDeclaration::StringToType(typeString);
-            OpenGLShaderUniformDeclaration* decl = nullptr;
-
-            if (type == OpenGLShaderUniformDeclaration::Type::NONE) {
-                // has to be a struct uniform
-                ShaderStruct* sStruct = FindStruct(typeString);
-                ENGINE_LOG_ASSERT(sStruct, "Cant find struct!");
-                decl = new OpenGLShaderUniformDeclaration(domain, sStruct, varName, arrCount);
-            }
-            else {
-                // needs to get deleted at some point...
-                decl = new OpenGLShaderUniformDeclaration(domain, type, varName, arrCount);
-            }
-
-            if (varName.find("r_") == 0) {
-                // starts with r_, reserve it as a render-wide uniform
-            }
-            else {
-                if (domain == ShaderDomain::Vertex) {
-                    if (!m_VertexUniformGroup)
-                        m_VertexUniformGroup.reset(new OpenGLShaderUniformGroupDeclaration("vertShaderGroup", domain));
-                    m_VertexUniformGroup->AddUniform(decl);
-                }
-                else if (domain == ShaderDomain::Fragment) {
-                    if (!m_FragUniformGroup)
-                        m_FragUniformGroup.reset(new OpenGLShaderUniformGroupDeclaration("fragShaderGroup", domain));
-                    m_FragUniformGroup->AddUniform(decl);
-                }
-            }
-        }
-    }
-
-    void OpenGLShader::ParseUniformStruct(const std::string& block, ShaderDomain domain) {
-        ///ENGINE_LOG_TRACE("Shader found token struct: ({0})", block);
-        // read the uniform and determine how much data to allocate in the buffer
-
-        // split by all whitespace and newline characters
-        std::vector<std::string> tokens = SplitString(block, " \t\r\n");
-
-        // tokens[0] should be struct
-        // tokens[1] should be the struct name
-        // tokens[2] should be the {
-        // tokens[3-n] should be indiviual statements
-        // last token should be }
-
-        ENGINE_LOG_ASSERT(tokens[0] == "struct", "First token should be 'struct'");
-        std::string structName = tokens[1];
-        ENGINE_LOG_ASSERT(tokens[2] == "{", "Should be a space between struct name and {");
-
-        // start building a ShaderStruct entry
-        ShaderStruct* uniformStruct = new ShaderStruct(structName);
-
-        u32 index = 3;
-        while (index < tokens.size()) {
-            if (tokens[index] == "}") // end of struct decl
-                break;
-
-            std::string typeString = tokens[index++];
-            std::string varName = tokens[index++];
-
-            if (const char* s = strstr(varName.c_str(), ";"))
-                varName = std::string(varName.c_str(), s - varName.c_str());
-
-            // get count if an array
-            uint32_t arrCount = 1;
-            const char* namestr = varName.c_str();
-            if (const char* s = strstr(namestr, "["))
-            {
-                varName = std::string(namestr, s - namestr);
-
-                const char* end = strstr(namestr, "]");
-                std::string c(s + 1, end - s);
-                arrCount = atoi(c.c_str());
-            }
-
-            // now have an individual var to add to the struct declaration
-            ShaderUniformDeclaration* field = new OpenGLShaderUniformDeclaration(domain, OpenGLShaderUniformDeclaration::StringToType(typeString), varName, arrCount);
-            uniformStruct->AddField(field);
-        }
-        m_Structs.push_back(uniformStruct);
-
-        bool done = true;
-    }
-
-    OpenGLShaderUniformGroupDeclaration::OpenGLShaderUniformGroupDeclaration(const std::string& name, ShaderDomain domain) 
-        : m_Name(name), m_Domain(domain), m_Size(0) {
-
-    }
-
-    OpenGLShaderUniformGroupDeclaration::~OpenGLShaderUniformGroupDeclaration() {
-        for (auto uniform : m_Uniforms) {
-            auto uniCast = static_cast<OpenGLShaderUniformDeclaration*>(uniform);
-
-            if (uniCast->m_Struct) {
-                auto s = uniCast->m_Struct;
-
-                s->Cleanup();
-            }
-
-            delete uniCast;
-            uniCast = nullptr;
-        }
-    }
-
-    void OpenGLShaderUniformGroupDeclaration::Reset() {
-        m_Uniforms.clear();
-        m_Size = 0;
-    }
-
-    OpenGLShaderUniformDeclaration::OpenGLShaderUniformDeclaration(ShaderDomain domain, Type type, const std::string& name, u32 count) 
-        : m_Domain(domain), m_Type(type), m_Name(name), m_Count(count), m_Struct(nullptr) {
-        m_Size = SizeOfUniformType(type) * count;
-    }
-
-    OpenGLShaderUniformDeclaration::OpenGLShaderUniformDeclaration(ShaderDomain domain, ShaderStruct* sStruct, const std::string& name, u32 count)
-        : m_Domain(domain), m_Struct(sStruct), m_Type(OpenGLShaderUniformDeclaration::Type::STRUCT), m_Name(name), m_Count(count) {
-        m_Size = sStruct->GetSize() * count;
-        m_Size = sStruct->GetSize() * count;
-    }
-
-    void OpenGLShaderUniformDeclaration::SetOffset(u32 offset) {
-        m_Offset = offset;
-    }
-
-    OpenGLShaderUniformDeclaration::Type OpenGLShaderUniformDeclaration::StringToType(const std::string& type) {
-        if (type == "int")      return Type::INT32;
-        if (type == "float")    return Type::FLOAT32;
-        if (type == "vec2")     return Type::VEC2;
-        if (type == "vec3")     return Type::VEC3;
-        if (type == "vec4")     return Type::VEC4;
-        if (type == "mat3")     return Type::MAT3;
-        if (type == "mat4")     return Type::MAT4;
-
-        return Type::NONE;
-    }
-
-    u32 OpenGLShaderUniformDeclaration::SizeOfUniformType(Type type) {
-        switch (type)
-        {
-        case OpenGLShaderUniformDeclaration::Type::INT32:       return 4;
-        case OpenGLShaderUniformDeclaration::Type::FLOAT32:     return 4;
-        case OpenGLShaderUniformDeclaration::Type::VEC2:        return 4 * 2;
-        case OpenGLShaderUniformDeclaration::Type::VEC3:        return 4 * 3;
-        case OpenGLShaderUniformDeclaration::Type::VEC4:        return 4 * 4;
-        case OpenGLShaderUniformDeclaration::Type::MAT3:        return 4 * 3 * 3;
-        case OpenGLShaderUniformDeclaration::Type::MAT4:        return 4 * 4 * 4;
-        }
-        return 0;
-    }
-
-    ShaderUniformDeclaration * OpenGLShaderUniformGroupDeclaration::FindUniformDeclaration(const std::string & name) const {
-        for (auto uniform : m_Uniforms) {
-            if (uniform->GetName() == name)
-                return uniform;
-        }
-        return nullptr;
-    }
-    void OpenGLShaderUniformGroupDeclaration::AddUniform(OpenGLShaderUniformDeclaration * uniform) {
-        u32 offset = 0;
-        if (m_Uniforms.size()) {
-            // there are already uniforms in the group
-            OpenGLShaderUniformDeclaration* previous = (OpenGLShaderUniformDeclaration*)m_Uniforms.back();
-            offset = previous->m_Offset + previous->m_Size;
-        }
-        uniform->SetOffset(offset);
-        m_Size += uniform->GetSize();
-        m_Uniforms.push_back(uniform);
-    }
-
-    void OpenGLShader::IdentifyUniforms() {
-        auto& vertexSource = m_ShaderSources[GL_VERTEX_SHADER];
-        auto& fragmentSource = m_ShaderSources[GL_FRAGMENT_SHADER];
-
-        const char* token;
-        const char* vstr;
-        const char* fstr;
-
-        vstr = vertexSource.c_str();
-        while (token = FindToken(vstr, "struct")) {
-            ParseUniformStruct(GetBlock(token, &vstr), ShaderDomain::Vertex);
-        }
-
-        vstr = vertexSource.c_str();
-        while (token = FindToken(vstr, "uniform")) {
-            ParseUniform(GetStatement(token, &vstr), ShaderDomain::Vertex);
-        }
-
-
-        fstr = fragmentSource.c_str();
-        while (token = FindToken(fstr, "struct")) {
-            ParseUniformStruct(GetBlock(token, &fstr), ShaderDomain::Fragment);
-        }
-
-        fstr = fragmentSource.c_str();
-        while (token = FindToken(fstr, "uniform")) {
-            ParseUniform(GetStatement(token, &fstr), ShaderDomain::Fragment);
-        }
-
-    }
-
     void OpenGLShader::SetVertUniformBuffer(Buffer buffer) {
         glUseProgram(m_ShaderID);
         ResolveAndSetUniforms(m_VertexUniformGroup, buffer);
@@ -625,12 +310,12 @@ namespace rh {
         ResolveAndSetUniforms(m_FragUniformGroup, buffer, overrides);
     }
 
-    void OpenGLShader::ResolveAndSetUniforms(const Ref<OpenGLShaderUniformGroupDeclaration>& decl, Buffer buffer)
+    void OpenGLShader::ResolveAndSetUniforms(const Ref<GLSLShaderUniformGroupDeclaration>& decl, Buffer buffer)
     {
         const std::vector<ShaderUniformDeclaration*>& uniforms = decl->GetUniformDeclarations();
         for (size_t i = 0; i < uniforms.size(); i++)
         {
-            OpenGLShaderUniformDeclaration* uniform = (OpenGLShaderUniformDeclaration*)uniforms[i];
+            GLSLShaderUniformDeclaration* uniform = (GLSLShaderUniformDeclaration*)uniforms[i];
             if (uniform->m_Count > 1)
                 ResolveAndSetUniformArray(uniform, buffer);
             else
@@ -639,12 +324,12 @@ namespace rh {
     }
     /////////////////////////////////////////////////////////////////////////////
 
-    void OpenGLShader::ResolveAndSetUniforms(const Ref<OpenGLShaderUniformGroupDeclaration>& decl, Buffer buffer, const std::unordered_set<std::string>& overrides)
+    void OpenGLShader::ResolveAndSetUniforms(const Ref<GLSLShaderUniformGroupDeclaration>& decl, Buffer buffer, const std::unordered_set<std::string>& overrides)
     {
         const std::vector<ShaderUniformDeclaration*>& uniforms = decl->GetUniformDeclarations();
         for (size_t i = 0; i < uniforms.size(); i++)
         {
-            OpenGLShaderUniformDeclaration* uniform = (OpenGLShaderUniformDeclaration*)uniforms[i];
+            GLSLShaderUniformDeclaration* uniform = (GLSLShaderUniformDeclaration*)uniforms[i];
             // only resolve if its in the list of overrides
             if (overrides.find(uniform->GetName()) != overrides.end()) {
                 if (uniform->m_Count > 1)
@@ -655,7 +340,7 @@ namespace rh {
         }
     }
 
-    void OpenGLShader::ResolveAndSetUniform(OpenGLShaderUniformDeclaration* uniform, Buffer buffer)
+    void OpenGLShader::ResolveAndSetUniform(GLSLShaderUniformDeclaration* uniform, Buffer buffer)
     {
         if (uniform->GetLocation() == -1)
             return;
@@ -665,28 +350,28 @@ namespace rh {
         uint32_t offset = uniform->GetOffset();
         switch (uniform->GetType())
         {
-        case OpenGLShaderUniformDeclaration::Type::FLOAT32:
+        case GLSLShaderUniformDeclaration::Type::FLOAT32:
             UploadUniformFloat(uniform->GetLocation(), *(float*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::INT32:
+        case GLSLShaderUniformDeclaration::Type::INT32:
             UploadUniformInt(uniform->GetLocation(), *(int32_t*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC2:
+        case GLSLShaderUniformDeclaration::Type::VEC2:
             UploadUniformFloat2(uniform->GetLocation(), *(laml::Vec2*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC3:
+        case GLSLShaderUniformDeclaration::Type::VEC3:
             UploadUniformFloat3(uniform->GetLocation(), *(laml::Vec3*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC4:
+        case GLSLShaderUniformDeclaration::Type::VEC4:
             UploadUniformFloat4(uniform->GetLocation(), *(laml::Vec4*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::MAT3:
+        case GLSLShaderUniformDeclaration::Type::MAT3:
             UploadUniformMat3(uniform->GetLocation(), *(laml::Mat3*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::MAT4:
+        case GLSLShaderUniformDeclaration::Type::MAT4:
             UploadUniformMat4(uniform->GetLocation(), *(laml::Mat4*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::STRUCT:
+        case GLSLShaderUniformDeclaration::Type::STRUCT:
             UploadUniformStruct(uniform, buffer.Data, offset);
             break;
         default:
@@ -694,35 +379,35 @@ namespace rh {
         }
     }
 
-    void OpenGLShader::ResolveAndSetUniformArray(OpenGLShaderUniformDeclaration* uniform, Buffer buffer)
+    void OpenGLShader::ResolveAndSetUniformArray(GLSLShaderUniformDeclaration* uniform, Buffer buffer)
     {
         //HZ_CORE_ASSERT(uniform->GetLocation() != -1, "Uniform has invalid location!");
 
         uint32_t offset = uniform->GetOffset();
         switch (uniform->GetType())
         {
-        case OpenGLShaderUniformDeclaration::Type::FLOAT32:
+        case GLSLShaderUniformDeclaration::Type::FLOAT32:
             UploadUniformFloat(uniform->GetLocation(), *(float*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::INT32:
+        case GLSLShaderUniformDeclaration::Type::INT32:
             UploadUniformInt(uniform->GetLocation(), *(int32_t*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC2:
+        case GLSLShaderUniformDeclaration::Type::VEC2:
             UploadUniformFloat2(uniform->GetLocation(), *(laml::Vec2*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC3:
+        case GLSLShaderUniformDeclaration::Type::VEC3:
             UploadUniformFloat3(uniform->GetLocation(), *(laml::Vec3*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC4:
+        case GLSLShaderUniformDeclaration::Type::VEC4:
             UploadUniformFloat4(uniform->GetLocation(), *(laml::Vec4*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::MAT3:
+        case GLSLShaderUniformDeclaration::Type::MAT3:
             UploadUniformMat3(uniform->GetLocation(), *(laml::Mat3*)&buffer.Data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::MAT4:
+        case GLSLShaderUniformDeclaration::Type::MAT4:
             UploadUniformMat4Array(uniform->GetLocation(), *(laml::Mat4*)&buffer.Data[offset], uniform->GetCount());
             break;
-        case OpenGLShaderUniformDeclaration::Type::STRUCT:
+        case GLSLShaderUniformDeclaration::Type::STRUCT:
             UploadUniformStruct(uniform, buffer.Data, offset);
             break;
         default:
@@ -730,29 +415,29 @@ namespace rh {
         }
     }
 
-    void OpenGLShader::ResolveAndSetUniformField(const OpenGLShaderUniformDeclaration& field, byte* data, int32_t offset)
+    void OpenGLShader::ResolveAndSetUniformField(const GLSLShaderUniformDeclaration& field, byte* data, int32_t offset)
     {
         switch (field.GetType())
         {
-        case OpenGLShaderUniformDeclaration::Type::FLOAT32:
+        case GLSLShaderUniformDeclaration::Type::FLOAT32:
             UploadUniformFloat(field.GetLocation(), *(float*)&data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::INT32:
+        case GLSLShaderUniformDeclaration::Type::INT32:
             UploadUniformInt(field.GetLocation(), *(int32_t*)&data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC2:
+        case GLSLShaderUniformDeclaration::Type::VEC2:
             UploadUniformFloat2(field.GetLocation(), *(laml::Vec2*)&data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC3:
+        case GLSLShaderUniformDeclaration::Type::VEC3:
             UploadUniformFloat3(field.GetLocation(), *(laml::Vec3*)&data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::VEC4:
+        case GLSLShaderUniformDeclaration::Type::VEC4:
             UploadUniformFloat4(field.GetLocation(), *(laml::Vec4*)&data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::MAT3:
+        case GLSLShaderUniformDeclaration::Type::MAT3:
             UploadUniformMat3(field.GetLocation(), *(laml::Mat3*)&data[offset]);
             break;
-        case OpenGLShaderUniformDeclaration::Type::MAT4:
+        case GLSLShaderUniformDeclaration::Type::MAT4:
             UploadUniformMat4(field.GetLocation(), *(laml::Mat4*)&data[offset]);
             break;
         default:
@@ -760,26 +445,6 @@ namespace rh {
         }
     }
 
-    OpenGLShaderSamplerDeclaration::OpenGLShaderSamplerDeclaration(Type type, const std::string & name, uint32_t count) 
-        : m_Type(type), m_Name(name), m_Count(count) {
-    }
-
-    OpenGLShaderSamplerDeclaration::Type OpenGLShaderSamplerDeclaration::StringToType(const std::string & type) {
-        if (type == "sampler2D")    return Type::TEXTURE2D;
-        if (type == "samplerCube")  return Type::TEXTURECUBE;
-
-        return Type::NONE;
-    }
-
-    std::string OpenGLShaderSamplerDeclaration::TypeToString(Type type) {
-        switch (type)
-        {
-        case Type::TEXTURE2D:       return "sampler2D";
-        case Type::TEXTURECUBE:     return "samplerCube";
-        }
-        return "Error: Invalid Type";
-    }
-
     void OpenGLShader::UploadUniformInt(uint32_t location, int32_t value)
     {
         glUniform1i(location, value);
@@ -826,69 +491,92 @@ namespace rh {
         glUniformMatrix4fv(location, count, GL_FALSE, &values.c_11);
     }
 
-    void OpenGLShader::UploadUniformStruct(OpenGLShaderUniformDeclaration* uniform, byte* buffer, uint32_t offset)
+    void OpenGLShader::UploadUniformStruct(GLSLShaderUniformDeclaration* uniform, byte* buffer, uint32_t offset)
     {
         const ShaderStruct& s = *uniform->m_Struct;
         const auto& fields = s.GetFields();
         for (size_t k = 0; k < fields.size(); k++)
         {
-            OpenGLShaderUniformDeclaration* field = (OpenGLShaderUniformDeclaration*)fields[k];
+            GLSLShaderUniformDeclaration* field = (GLSLShaderUniformDeclaration*)fields[k];
             ResolveAndSetUniformField(*field, buffer, offset);
             offset += field->m_Size;
         }
     }
 
-    //TODO: turn this logging back on
     void OpenGLShader::SetMat4(const std::string &name, const laml::Mat4& value) const {
-        s32 loc = glGetUniformLocation(m_ShaderID, name.c_str());
+        SetMat4(hash_djb2(name.c_str(), name.size()), value);
+    }
+
+    void OpenGLShader::SetVec2(const std::string &name, const laml::Vec2& value) const {
+        SetVec2(hash_djb2(name.c_str(), name.size()), value);
+    }
+
+    void OpenGLShader::SetVec3(const std::string &name, const laml::Vec3& value) const {
+        SetVec3(hash_djb2(name.c_str(), name.size()), value);
+    }
+
+    void OpenGLShader::SetVec4(const std::string &name, const laml::Vec4& value) const {
+        SetVec4(hash_djb2(name.c_str(), name.size()), value);
+    }
+
+    void OpenGLShader::SetFloat(const std::string &name, f32 value) const {
+        SetFloat(hash_djb2(name.c_str(), name.size()), value);
+    }
+
+    void OpenGLShader::SetInt(const std::string &name, s32 value) const {
+        SetInt(hash_djb2(name.c_str(), name.size()), value);
+    }
+
+    //TODO: turn this logging back on
+    void OpenGLShader::SetMat4(stringID name, const laml::Mat4& value) const {
+        s32 loc = GetUniformLocation(name);
         if (loc == -1) {
-            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name.c_str());
+            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name);
             return;
         }
         glUniformMatrix4fv(loc, 1, GL_FALSE, &value.c_11);
-
     }
 
-    void OpenGLShader::SetVec2(const std::string &name, const laml::Vec2& value) const {
-        s32 loc = glGetUniformLocation(m_ShaderID, name.c_str());
+    void OpenGLShader::SetVec2(stringID name, const laml::Vec2& value) const {
+        s32 loc = GetUniformLocation(name);
         if (loc == -1) {
-            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name.c_str());
+            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name);
             return;
         }
         glUniform2f(loc, value.x, value.y);
     }
 
-    void OpenGLShader::SetVec3(const std::string &name, const laml::Vec3& value) const {
-        s32 loc = glGetUniformLocation(m_ShaderID, name.c_str());
+    void OpenGLShader::SetVec3(stringID name, const laml::Vec3& value) const {
+        s32 loc = GetUniformLocation(name);
         if (loc == -1) {
-            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name.c_str());
+            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name);
             return;
         }
         glUniform3f(loc, value.x, value.y, value.z);
     }
 
-    void OpenGLShader::SetVec4(const std::string &name, const laml::Vec4& value) const {
-        s32 loc = glGetUniformLocation(m_ShaderID, name.c_str());
+    void OpenGLShader::SetVec4(stringID name, const laml::Vec4& value) const {
+        s32 loc = GetUniformLocation(name);
         if (loc == -1) {
-            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name.c_str());
+            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name);
             return;
         }
         glUniform4f(loc, value.x, value.y, value.z, value.w);
     }
 
-    void OpenGLShader::SetFloat(const std::string &name, f32 value) const {
-        s32 loc = glGetUniformLocation(m_ShaderID, name.c_str());
+    void OpenGLShader::SetFloat(stringID name, f32 value) const {
+        s32 loc = GetUniformLocation(name);
         if (loc == -1) {
-            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name.c_str());
+            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name);
             return;
         }
         glUniform1f(loc, value);
     }
 
-    void OpenGLShader::SetInt(const std::string &name, s32 value) const {
-        s32 loc = glGetUniformLocation(m_ShaderID, name.c_str());
+    void OpenGLShader::SetInt(stringID name, s32 value) const {
+        s32 loc = GetUniformLocation(name);
         if (loc == -1) {
-            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name.c_str());
+            //ENGINE_LOG_WARN("Chould not find uniform: {0}", name);
             return;
         }
         glUniform1i(loc, value);
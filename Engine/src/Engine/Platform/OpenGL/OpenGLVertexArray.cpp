@@ -65,26 +65,44 @@ namespace rh {
 
         ENGINE_LOG_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "VertexBuffer has no layout");
 
-        u32 index = 0;
+        // attributes continue after the ones of previously added buffers
         const auto& layout = vertexBuffer->GetLayout();
         for (const auto& element : layout) {
-            glEnableVertexAttribArray(index);
+            if (element.Type == ShaderDataType::Mat3 || element.Type == ShaderDataType::Mat4) {
+                // matrices take one attribute location per column
+                u32 columns = element.Type == ShaderDataType::Mat3 ? 3 : 4;
+                for (u32 c = 0; c < columns; c++) {
+                    glEnableVertexAttribArray(m_AttributeIndex);
+                    glVertexAttribPointer(m_AttributeIndex,
+                        columns,
+                        GL_FLOAT,
+                        element.Normalized ? GL_TRUE : GL_FALSE,
+                        layout.GetStride(),
+                        (const void*)(element.Offset + sizeof(float) * columns * c));
+                    glVertexAttribDivisor(m_AttributeIndex, layout.GetInstanceStep());
+                    m_AttributeIndex++;
+                }
+                continue;
+            }
+
+            glEnableVertexAttribArray(m_AttributeIndex);
             if (IsIntegerType(element.Type)) {
-                glVertexAttribIPointer(index,
+                glVertexAttribIPointer(m_AttributeIndex,
                     element.GetComponentCount(),
                     ShaderDataTypeToOpenGLBaseType(element.Type),
                     layout.GetStride(),
                     (const void*)element.Offset);
             }
             else {
-                glVertexAttribPointer(index,
+                glVertexAttribPointer(m_AttributeIndex,
                     element.GetComponentCount(),
                     ShaderDataTypeToOpenGLBaseType(element.Type),
                     element.Normalized ? GL_TRUE : GL_FALSE,
                     layout.GetStride(),
                     (const void*)element.Offset);
             }
-            index++;
+            glVertexAttribDivisor(m_AttributeIndex, layout.GetInstanceStep());
+            m_AttributeIndex++;
         }
 
         m_VertexBuffers.push_back(vertexBuffer);
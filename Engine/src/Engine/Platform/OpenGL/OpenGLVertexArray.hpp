@@ -22,5 +22,7 @@ namespace rh {
         std::vector<Ref<VertexBuffer>> m_VertexBuffers;
         Ref<IndexBuffer> m_IndexBuffer;
         u32 m_ArrayID;
+        u32 m_AttributeIndex = 0; // next free attribute location
+
     };
 }
@@ -5,6 +5,7 @@
 
 /* API implementations */
 #include "Engine/Platform/OpenGL/OpenGLBuffer.hpp"
+#include "Engine/Platform/Null/NullBuffer.hpp"
 
 namespace rh {
     Ref<IndexBuffer> IndexBuffer::Create(void* indices, u32 count) {
@@ -16,6 +17,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return std::make_shared<OpenGLIndexBuffer>(indices, count);
             break;
+        case RendererAPI::API::Null:
+            return std::make_shared<NullIndexBuffer>(indices, count);
+            break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -31,6 +35,63 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return std::make_shared<OpenGLVertexBuffer>(vertices, size);
             break;
+        case RendererAPI::API::Null:
+            return std::make_shared<NullVertexBuffer>(vertices, size);
+            break;
+        }
+
+        ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
+        return nullptr;
+    }
+
+    Ref<VertexBuffer> VertexBuffer::Create(u32 size) {
+        switch (Renderer::GetAPI()) {
+        case RendererAPI::API::None:
+            ENGINE_LOG_ASSERT(false, "No API selected when creating vertexBuffer");
+            return nullptr;
+            break;
+        case RendererAPI::API::OpenGL:
+            return std::make_shared<OpenGLVertexBuffer>(size);
+            break;
+        case RendererAPI::API::Null:
+            return std::make_shared<NullVertexBuffer>(size);
+            break;
+        }
+
+        ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
+        return nullptr;
+    }
+
+    u32 UniformBuffer::GetOffsetAlignment() {
+        switch (Renderer::GetAPI()) {
+        case RendererAPI::API::None:
+            ENGINE_LOG_ASSERT(false, "No API selected when querying uniformBuffer alignment");
+            return 0;
+            break;
+        case RendererAPI::API::OpenGL:
+            return OpenGLUniformBuffer::QueryOffsetAlignment();
+            break;
+        case RendererAPI::API::Null:
+            return NullUniformBuffer::QueryOffsetAlignment();
+            break;
+        }
+
+        ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
+        return 0;
+    }
+
+    Ref<UniformBuffer> UniformBuffer::Create(u32 size) {
+        switch (Renderer::GetAPI()) {
+        case RendererAPI::API::None:
+            ENGINE_LOG_ASSERT(false, "No API selected when creating uniformBuffer");
+            return nullptr;
+            break;
+        case RendererAPI::API::OpenGL:
+            return std::make_shared<OpenGLUniformBuffer>(size);
+            break;
+        case RendererAPI::API::Null:
+            return std::make_shared<NullUniformBuffer>(size);
+            break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
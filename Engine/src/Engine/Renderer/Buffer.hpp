@@ -70,8 +70,13 @@ namespace rh {
         BufferLayout(const std::initializer_list<BufferElement>& elements) : m_Elements(elements) {
             CalculateOffsetsAndStride();
         }
+        /// instanceStep > 0 advances the attributes once per that many instances instead of per vertex
+        BufferLayout(const std::initializer_list<BufferElement>& elements, u32 instanceStep) : m_Elements(elements), m_InstanceStep(instanceStep) {
+            CalculateOffsetsAndStride();
+        }
 
         inline u32 GetStride() const { return m_Stride; }
+        inline u32 GetInstanceStep() const { return m_InstanceStep; }
         inline const std::vector<BufferElement>& GetElements() const { return m_Elements; }
 
         std::vector<BufferElement>::iterator begin() { return m_Elements.begin(); }
@@ -90,6 +95,7 @@ namespace rh {
         }
         std::vector<BufferElement> m_Elements;
         u32 m_Stride = 0;
+        u32 m_InstanceStep = 0;
     };
 
     class VertexBuffer
@@ -103,7 +109,12 @@ namespace rh {
         virtual void SetLayout(const BufferLayout& layout) = 0;
         virtual const BufferLayout& GetLayout() const = 0;
 
+        /// Replace the contents of a dynamic buffer, reallocating if size grew
+        virtual void SetData(const void* data, u32 size) = 0;
+
         static Ref<VertexBuffer> Create(void* vertices, u32 size);
+        /// Empty buffer meant to be refilled every frame with SetData
+        static Ref<VertexBuffer> Create(u32 size);
     };
 
     class IndexBuffer
@@ -119,4 +130,25 @@ namespace rh {
         static Ref<IndexBuffer> Create(void* indices, u32 count);
     };
 
+    /// Backing storage for std140 uniform blocks. Shaders pick a range of it up
+    /// through the binding point in their layout(binding = n) declaration.
+    class UniformBuffer
+    {
+    public:
+        virtual ~UniformBuffer() {}
+
+        /// Copy size bytes into the buffer starting at offset
+        virtual void SetData(const void* data, u32 size, u32 offset = 0) = 0;
+
+        /// Attach [offset, offset+size) to a binding point.
+        /// offset has to be a multiple of GetOffsetAlignment()
+        virtual void BindRange(u32 binding, u32 offset, u32 size) const = 0;
+
+        virtual u32 GetSize() const = 0;
+
+        static Ref<UniformBuffer> Create(u32 size);
+        /// Alignment the API requires of BindRange offsets
+        static u32 GetOffsetAlignment();
+    };
+
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Platform/OpenGL/OpenGLFramebuffer.hpp"
+#include "Engine/Platform/Null/NullFramebuffer.hpp"
 
 namespace rh {
 
@@ -15,6 +16,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return std::make_shared<OpenGLFramebuffer>(spec);
             break;
+        case RendererAPI::API::Null:
+            return std::make_shared<NullFramebuffer>(spec);
+            break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
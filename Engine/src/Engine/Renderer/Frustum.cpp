@@ -0,0 +1,170 @@
+#include <enpch.hpp>
+#include "Frustum.hpp"
+
+#if defined(FRUSTUM_CULL_SSE)
+#include <emmintrin.h>
+#endif
+
+namespace rh {
+
+    BoundingVolume BoundingVolume::FromIndexedPositions(const void* positions, size_t stride, const u32* indices, u32 indexCount) {
+        BoundingVolume bv;
+        bv.boxMin = laml::Vec3(0.0f, 0.0f, 0.0f);
+        bv.boxMax = laml::Vec3(0.0f, 0.0f, 0.0f);
+        bv.sphereCenter = laml::Vec3(0.0f, 0.0f, 0.0f);
+        bv.sphereRadius = 0.0f;
+        if (indexCount == 0)
+            return bv;
+
+        const u8* base = reinterpret_cast<const u8*>(positions);
+        auto position = [base, stride](u32 index) -> const f32* {
+            return reinterpret_cast<const f32*>(base + index * stride);
+        };
+
+        const f32* p0 = position(indices[0]);
+        f32 lo[3] = { p0[0], p0[1], p0[2] };
+        f32 hi[3] = { p0[0], p0[1], p0[2] };
+        for (u32 n = 1; n < indexCount; n++) {
+            const f32* p = position(indices[n]);
+            for (int k = 0; k < 3; k++) {
+                lo[k] = std::min(lo[k], p[k]);
+                hi[k] = std::max(hi[k], p[k]);
+            }
+        }
+        bv.boxMin = laml::Vec3(lo[0], lo[1], lo[2]);
+        bv.boxMax = laml::Vec3(hi[0], hi[1], hi[2]);
+
+        // sphere around the box center, radius reaching the farthest vertex
+        f32 c[3] = { 0.5f*(lo[0] + hi[0]), 0.5f*(lo[1] + hi[1]), 0.5f*(lo[2] + hi[2]) };
+        f32 maxDist2 = 0.0f;
+        for (u32 n = 0; n < indexCount; n++) {
+            const f32* p = position(indices[n]);
+            f32 dx = p[0] - c[0], dy = p[1] - c[1], dz = p[2] - c[2];
+            maxDist2 = std::max(maxDist2, dx*dx + dy*dy + dz*dz);
+        }
+        bv.sphereCenter = laml::Vec3(c[0], c[1], c[2]);
+        bv.sphereRadius = sqrtf(maxDist2);
+
+        return bv;
+    }
+
+    Frustum Frustum::FromMatrix(const laml::Mat4& m) {
+        // Gribb/Hartmann: planes are sums/differences of the 4th row with the others
+        Frustum f;
+        f.planes[Left]   = laml::Vec4(m.c_41 + m.c_11, m.c_42 + m.c_12, m.c_43 + m.c_13, m.c_44 + m.c_14);
+        f.planes[Right]  = laml::Vec4(m.c_41 - m.c_11, m.c_42 - m.c_12, m.c_43 - m.c_13, m.c_44 - m.c_14);
+        f.planes[Bottom] = laml::Vec4(m.c_41 + m.c_21, m.c_42 + m.c_22, m.c_43 + m.c_23, m.c_44 + m.c_24);
+        f.planes[Top]    = laml::Vec4(m.c_41 - m.c_21, m.c_42 - m.c_22, m.c_43 - m.c_23, m.c_44 - m.c_24);
+        f.planes[Near]   = laml::Vec4(m.c_41 + m.c_31, m.c_42 + m.c_32, m.c_43 + m.c_33, m.c_44 + m.c_34);
+        f.planes[Far]    = laml::Vec4(m.c_41 - m.c_31, m.c_42 - m.c_32, m.c_43 - m.c_33, m.c_44 - m.c_34);
+
+        for (int n = 0; n < 6; n++) {
+            laml::Vec4& p = f.planes[n];
+            f32 len = sqrtf(p.x*p.x + p.y*p.y + p.z*p.z);
+            if (len > 0.0f) {
+                f32 inv = 1.0f / len;
+                p = laml::Vec4(p.x*inv, p.y*inv, p.z*inv, p.w*inv);
+            }
+        }
+
+        return f;
+    }
+
+    bool Frustum::TestSphere(const laml::Vec3& c, f32 radius) const {
+        for (int n = 0; n < 6; n++) {
+            const laml::Vec4& p = planes[n];
+            if (p.x*c.x + p.y*c.y + p.z*c.z + p.w < -radius)
+                return false;
+        }
+        return true;
+    }
+
+    void CullingSet::Clear() {
+        x.clear(); y.clear(); z.clear(); r.clear();
+        visible.clear();
+        count = 0;
+    }
+
+    int CullingSet::Add(const laml::Vec3& c, f32 radius, const laml::Mat4& m) {
+        // scale the radius by the largest axis scale of the transform
+        f32 sx = m.c_11*m.c_11 + m.c_21*m.c_21 + m.c_31*m.c_31;
+        f32 sy = m.c_12*m.c_12 + m.c_22*m.c_22 + m.c_32*m.c_32;
+        f32 sz = m.c_13*m.c_13 + m.c_23*m.c_23 + m.c_33*m.c_33;
+        f32 scale = sqrtf(std::max(sx, std::max(sy, sz)));
+
+        // arrays may still hold padding from the last CullSpheres
+        size_t n = (size_t)count;
+        x.resize(n + 1); y.resize(n + 1); z.resize(n + 1); r.resize(n + 1);
+
+        x[n] = m.c_11*c.x + m.c_12*c.y + m.c_13*c.z + m.c_14;
+        y[n] = m.c_21*c.x + m.c_22*c.y + m.c_23*c.z + m.c_24;
+        z[n] = m.c_31*c.x + m.c_32*c.y + m.c_33*c.z + m.c_34;
+        r[n] = radius * scale;
+        return count++;
+    }
+
+    int CullSpheres_Scalar(const Frustum& frustum, CullingSet& set) {
+        set.visible.resize(set.count);
+
+        int numVisible = 0;
+        for (int n = 0; n < set.count; n++) {
+            bool inside = frustum.TestSphere(laml::Vec3(set.x[n], set.y[n], set.z[n]), set.r[n]);
+            set.visible[n] = inside;
+            numVisible += inside;
+        }
+        return numVisible;
+    }
+
+#if defined(FRUSTUM_CULL_SSE)
+
+    int CullSpheres(const Frustum& frustum, CullingSet& set) {
+        const int count = set.count;
+        set.visible.resize(count);
+
+        // pad the SoA arrays to the kernel width, padding spheres are never read back
+        size_t padded = (size_t)((count + 3) & ~3);
+        set.x.resize(padded, 0.0f); set.y.resize(padded, 0.0f);
+        set.z.resize(padded, 0.0f); set.r.resize(padded, 0.0f);
+
+        __m128 px[6], py[6], pz[6], pw[6];
+        for (int k = 0; k < 6; k++) {
+            px[k] = _mm_set1_ps(frustum.planes[k].x);
+            py[k] = _mm_set1_ps(frustum.planes[k].y);
+            pz[k] = _mm_set1_ps(frustum.planes[k].z);
+            pw[k] = _mm_set1_ps(frustum.planes[k].w);
+        }
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        int numVisible = 0;
+        for (int n = 0; n < count; n += 4) {
+            __m128 cx = _mm_loadu_ps(&set.x[n]);
+            __m128 cy = _mm_loadu_ps(&set.y[n]);
+            __m128 cz = _mm_loadu_ps(&set.z[n]);
+            __m128 negR = _mm_xor_ps(_mm_loadu_ps(&set.r[n]), signMask);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int k = 0; k < 6; k++) {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[k], cx), _mm_mul_ps(py[k], cy)),
+                                      _mm_add_ps(_mm_mul_ps(pz[k], cz), pw[k]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+            }
+
+            int mask = _mm_movemask_ps(inside);
+            int lanes = std::min(4, count - n);
+            for (int l = 0; l < lanes; l++) {
+                u8 v = (mask >> l) & 1;
+                set.visible[n + l] = v;
+                numVisible += v;
+            }
+        }
+        return numVisible;
+    }
+
+#else
+
+    int CullSpheres(const Frustum& frustum, CullingSet& set) {
+        return CullSpheres_Scalar(frustum, set);
+    }
+
+#endif
+}
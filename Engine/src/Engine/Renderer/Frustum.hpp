@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Engine/Core/Base.hpp"
+
+// Pick the widest culling kernel the compiler is allowed to emit
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define FRUSTUM_CULL_SSE 1
+    #define FRUSTUM_CULL_WIDTH 4
+#else
+    #define FRUSTUM_CULL_WIDTH 1
+#endif
+
+namespace rh {
+
+    /// Local-space bounds of a piece of geometry
+    struct BoundingVolume {
+        laml::Vec3 boxMin;
+        laml::Vec3 boxMax;
+        laml::Vec3 sphereCenter;
+        f32 sphereRadius;
+
+        /// Build from the positions referenced by an index list.
+        /// positions points at the first vertex's position, stride is the vertex size in bytes.
+        static BoundingVolume FromIndexedPositions(const void* positions, size_t stride, const u32* indices, u32 indexCount);
+    };
+
+    /// Six normalized planes (xyz = normal pointing inside, w = distance)
+    struct Frustum {
+        enum { Left = 0, Right, Bottom, Top, Near, Far };
+        laml::Vec4 planes[6];
+
+        /// Extract the planes of a projection * view matrix (OpenGL clip space)
+        static Frustum FromMatrix(const laml::Mat4& viewProjection);
+
+        bool TestSphere(const laml::Vec3& center, f32 radius) const;
+    };
+
+    /// World-space bounding spheres of all draw candidates in SoA layout, so the
+    /// culling kernel can test several spheres per plane at once.
+    struct CullingSet {
+        std::vector<f32> x, y, z, r;
+        std::vector<u8> visible; // output of CullSpheres
+        int count = 0;
+
+        void Clear();
+
+        /// Add a local sphere transformed by transform, returns the candidate index
+        int Add(const laml::Vec3& localCenter, f32 localRadius, const laml::Mat4& transform);
+    };
+
+    /// Visible/culled candidates for a frame
+    struct CullingStats {
+        u32 candidates;
+        u32 visible;
+        u32 culled;
+    };
+
+    /// Test every sphere in the set against the frustum, fills set.visible.
+    /// Returns the number of visible spheres.
+    int CullSpheres(const Frustum& frustum, CullingSet& set);
+
+    /// Reference one-sphere-at-a-time version of CullSpheres
+    int CullSpheres_Scalar(const Frustum& frustum, CullingSet& set);
+}
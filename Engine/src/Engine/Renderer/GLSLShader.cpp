@@ -0,0 +1,462 @@
+#include <enpch.hpp>
+#include "GLSLShader.hpp"
+
+#include <fstream>
+
+namespace rh {
+
+    static ShaderDomain ShaderTypeFromString(const std::string& type) {
+        if (type == "vertex")
+            return ShaderDomain::Vertex;
+        if (type == "fragment" || type == "pixel")
+            return ShaderDomain::Fragment;
+        if (type == "geometry")
+            return ShaderDomain::Geometry;
+
+        ENGINE_LOG_ASSERT(false, "Unknown shader type");
+        return ShaderDomain::None;
+    }
+
+    GLSLShader::GLSLShader(const std::string& path) 
+            : m_filepath(path) {
+        ReadSource(path);
+
+        // Data/Shaders/simple.glsl
+        auto lastSlash = path.find_last_of("/\\");
+        lastSlash = lastSlash == std::string::npos ? 0 : lastSlash + 1;
+        auto lastDot = path.rfind('.');
+        auto count = lastDot == std::string::npos ? path.size() - lastSlash : lastDot - lastSlash;
+
+        m_Name = path.substr(lastSlash, count);
+    }
+
+    GLSLShader::GLSLShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc) 
+            : m_Name(name), m_filepath("Error, no path given") {
+        m_ShaderSources[ShaderDomain::Vertex] = vertexSrc;
+        m_ShaderSources[ShaderDomain::Fragment] = fragmentSrc;
+    }
+
+    GLSLShader::~GLSLShader() {
+        for (auto sampler : m_Samplers) {
+            auto samplerCast = static_cast<GLSLShaderSamplerDeclaration*>(sampler);
+
+            delete samplerCast;
+            samplerCast = 0;
+        }
+    }
+
+    void GLSLShader::ReadSource(const std::string& path) {
+        std::string source = ReadFile(path);
+        m_ShaderSources = PreProcess(source);
+    }
+
+    void GLSLShader::Reflect() {
+        // clear existing data if exists
+        m_Samplers.clear();
+        m_Structs.clear();
+        if (m_FragUniformGroup)   m_FragUniformGroup->Reset();
+        if (m_VertexUniformGroup) m_VertexUniformGroup->Reset();
+
+        IdentifyUniforms();
+        AssignSamplerSlots();
+    }
+
+    void GLSLShader::AssignSamplerSlots() {
+        // single samplers take consecutive texture units, arrays start at unit 0
+        u32 samplerID = 0;
+        for (int n = 0; n < m_Samplers.size(); n++) {
+            GLSLShaderSamplerDeclaration* sampler = (GLSLShaderSamplerDeclaration*)m_Samplers[n];
+
+            if (sampler->GetCount() == 1) {
+                sampler->m_ID = samplerID;
+                samplerID++;
+            }
+            else if (sampler->GetCount() > 1) {
+                sampler->m_ID = 0;
+            }
+        }
+    }
+
+    std::unordered_map<ShaderDomain, std::string> GLSLShader::PreProcess(const std::string& source) {
+        std::unordered_map<ShaderDomain, std::string> shaderSources;
+
+        const char* typeToken = "#type";
+        size_t typeTokenLength = strlen(typeToken);
+        size_t pos = source.find(typeToken, 0);
+        while (pos != std::string::npos) {
+            size_t eol = source.find_first_of("\r\n", pos);
+            ENGINE_LOG_ASSERT(eol != std::string::npos, "Syntax error");
+            size_t begin = pos + typeTokenLength + 1;
+            std::string type = source.substr(begin, eol - begin);
+            ENGINE_LOG_ASSERT(type == "vertex" || type == "fragment" || type == "pixel" || type == "geometry", "Invalid shader type specified");
+
+            size_t nextLinePos = source.find_first_not_of("\r\n", eol);
+            pos = source.find(typeToken, nextLinePos);
+            shaderSources[ShaderTypeFromString(type)] = 
+                source.substr(nextLinePos, pos - (nextLinePos == std::string::npos ? source.size() - 1 : nextLinePos));
+        }
+
+        return shaderSources;
+    }
+
+    std::string GLSLShader::ReadFile(const std::string& path) {
+        std::string result;
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+        if (in) {
+            in.seekg(0, std::ios::end);
+            result.resize(in.tellg());
+            in.seekg(0, std::ios::beg);
+            in.read(&result[0], result.size());
+            in.close();
+        }
+        else {
+            ENGINE_LOG_ERROR("Could not open file: {0}", path);
+        }
+        return result;
+    }
+
+    // Parsing helper functions
+    static const char* FindToken(const char* str, const std::string& token)
+    {
+        const char* t = str;
+        while (t = strstr(t, token.c_str()))
+        {
+            bool left = str == t || isspace(t[-1]);
+            bool right = !t[token.size()] || isspace(t[token.size()]);
+            if (left && right)
+                return t;
+
+            t += token.size();
+        }
+        return nullptr;
+    }
+
+    static std::string GetStatement(const char* str, const char** outPosition)
+    {
+        const char* end = strstr(str, ";");
+        if (!end)
+            return str;
+
+        if (outPosition)
+            *outPosition = end;
+        uint32_t length = end - str + 1;
+        return std::string(str, length);
+    }
+
+    static std::string GetBlock(const char* str, const char** outPosition)
+    {
+        const char* end = strstr(str, "}");
+        if (!end)
+            return str;
+
+        if (outPosition)
+            *outPosition = end;
+        uint32_t length = end - str + 1;
+        return std::string(str, length);
+    }
+
+    // 'uniform Name { ... };' declares a block, a '{' shows up before the first ';'
+    static bool IsUniformBlock(const char* str)
+    {
+        const char* end = strstr(str, ";");
+        const char* brace = strstr(str, "{");
+        return brace && (!end || brace < end);
+    }
+
+    static std::vector<std::string> SplitString(const std::string& string, const std::string& delimiters) {
+        size_t start = 0;
+        size_t end = string.find_first_of(delimiters);
+
+        std::vector<std::string> result;
+
+        while (end <= std::string::npos)
+        {
+            std::string token = string.substr(start, end - start);
+            if (!token.empty())
+                result.push_back(token);
+
+            if (end == std::string::npos)
+                break;
+
+            start = end + 1;
+            end = string.find_first_of(delimiters, start);
+        }
+
+        return result;
+    }
+
+    ShaderStruct* GLSLShader::FindStruct(const std::string& structName) const {
+        for (ShaderStruct* s : m_Structs)
+        {
+            if (s->GetName() == structName)
+                return s;
+        }
+        return nullptr;
+    }
+
+    void GLSLShader::ParseUniform(const std::string& statement, ShaderDomain domain) {
+        ///ENGINE_LOG_TRACE("Shader parsing uniform statement: ({0})", statement);
+        // read the uniform and determine how much data to allocate in the buffer
+
+        // split by all whitespace and newline characters
+        std::vector<std::string> tokens = SplitString(statement, " \t\r\n");
+        
+        uint32_t index = 0;
+
+        // tokens[0] should be uniform
+        // tokens[1] should be the type (float, vec3, mat4, etc...)
+        // tokens[2] should be the variable name (u_color) (still has the ; at the end)
+
+        ENGINE_LOG_ASSERT(tokens[0] == "uniform", "First token should be 'uniform'");
+        std::string typeString = tokens[1];
+        ENGINE_LOG_ASSERT(tokens[2][tokens[2].size()-1] == ';', "Statement should end in a ';'");
+        std::string varName = tokens[2].substr(0, tokens[2].size() - 1);
+
+        // if uniform is an array, it still hase the [x] at the end of the varName
+        std::string varName_tmp(varName);
+        int32_t arrCount = 1;
+        const char* namestr_tmp = varName_tmp.c_str();
+        if (const char* s = strstr(namestr_tmp, "["))
+        {
+            varName = std::string(namestr_tmp, s - namestr_tmp);
+
+            const char* end = strstr(namestr_tmp, "]");
+            std::string c(s + 1, end - s);
+            arrCount = atoi(c.c_str());
+        }
+
+        if (typeString == "sampler2D" || typeString == "samplerCube") {
+            ShaderSamplerDeclaration* decl = new GLSLShaderSamplerDeclaration(GLSLShaderSamplerDeclaration::StringToType(typeString), varName, arrCount);
+            m_Samplers.push_back(decl);
+        }
+        else {
+            // Can now store a uniform of type typeString, called varName, with a count of arrCount
+            GLSLShaderUniformDeclaration::Type type = GLSLShaderUniformDeclaration::StringToType(typeString);
+            GLSLShaderUniformDeclaration* decl = nullptr;
+
+            if (type == GLSLShaderUniformDeclaration::Type::NONE) {
+                // has to be a struct uniform
+                ShaderStruct* sStruct = FindStruct(typeString);
+                ENGINE_LOG_ASSERT(sStruct, "Cant find struct!");
+                decl = new GLSLShaderUniformDeclaration(domain, sStruct, varName, arrCount);
+            }
+            else {
+                // needs to get deleted at some point...
+                decl = new GLSLShaderUniformDeclaration(domain, type, varName, arrCount);
+            }
+
+            if (varName.find("r_") == 0) {
+                // starts with r_, reserve it as a render-wide uniform
+            }
+            else {
+                if (domain == ShaderDomain::Vertex) {
+                    if (!m_VertexUniformGroup)
+                        m_VertexUniformGroup.reset(new GLSLShaderUniformGroupDeclaration("vertShaderGroup", domain));
+                    m_VertexUniformGroup->AddUniform(decl);
+                }
+                else if (domain == ShaderDomain::Fragment) {
+                    if (!m_FragUniformGroup)
+                        m_FragUniformGroup.reset(new GLSLShaderUniformGroupDeclaration("fragShaderGroup", domain));
+                    m_FragUniformGroup->AddUniform(decl);
+                }
+            }
+        }
+    }
+
+    void GLSLShader::ParseUniformStruct(const std::string& block, ShaderDomain domain) {
+        ///ENGINE_LOG_TRACE("Shader found token struct: ({0})", block);
+        // read the uniform and determine how much data to allocate in the buffer
+
+        // split by all whitespace and newline characters
+        std::vector<std::string> tokens = SplitString(block, " \t\r\n");
+
+        // tokens[0] should be struct
+        // tokens[1] should be the struct name
+        // tokens[2] should be the {
+        // tokens[3-n] should be indiviual statements
+        // last token should be }
+
+        ENGINE_LOG_ASSERT(tokens[0] == "struct", "First token should be 'struct'");
+        std::string structName = tokens[1];
+        ENGINE_LOG_ASSERT(tokens[2] == "{", "Should be a space between struct name and {");
+
+        // start building a ShaderStruct entry
+        ShaderStruct* uniformStruct = new ShaderStruct(structName);
+
+        u32 index = 3;
+        while (index < tokens.size()) {
+            if (tokens[index] == "}") // end of struct decl
+                break;
+
+            std::string typeString = tokens[index++];
+            std::string varName = tokens[index++];
+
+            if (const char* s = strstr(varName.c_str(), ";"))
+                varName = std::string(varName.c_str(), s - varName.c_str());
+
+            // get count if an array
+            uint32_t arrCount = 1;
+            const char* namestr = varName.c_str();
+            if (const char* s = strstr(namestr, "["))
+            {
+                varName = std::string(namestr, s - namestr);
+
+                const char* end = strstr(namestr, "]");
+                std::string c(s + 1, end - s);
+                arrCount = atoi(c.c_str());
+            }
+
+            // now have an individual var to add to the struct declaration
+            ShaderUniformDeclaration* field = new GLSLShaderUniformDeclaration(domain, GLSLShaderUniformDeclaration::StringToType(typeString), varName, arrCount);
+            uniformStruct->AddField(field);
+        }
+        m_Structs.push_back(uniformStruct);
+
+        bool done = true;
+    }
+
+    GLSLShaderUniformGroupDeclaration::GLSLShaderUniformGroupDeclaration(const std::string& name, ShaderDomain domain) 
+        : m_Name(name), m_Domain(domain), m_Size(0) {
+
+    }
+
+    GLSLShaderUniformGroupDeclaration::~GLSLShaderUniformGroupDeclaration() {
+        for (auto uniform : m_Uniforms) {
+            auto uniCast = static_cast<GLSLShaderUniformDeclaration*>(uniform);
+
+            if (uniCast->m_Struct) {
+                auto s = uniCast->m_Struct;
+
+                s->Cleanup();
+            }
+
+            delete uniCast;
+            uniCast = nullptr;
+        }
+    }
+
+    void GLSLShaderUniformGroupDeclaration::Reset() {
+        m_Uniforms.clear();
+        m_Size = 0;
+    }
+
+    GLSLShaderUniformDeclaration::GLSLShaderUniformDeclaration(ShaderDomain domain, Type type, const std::string& name, u32 count) 
+        : m_Domain(domain), m_Type(type), m_Name(name), m_Count(count), m_Struct(nullptr) {
+        m_Size = SizeOfUniformType(type) * count;
+    }
+
+    GLSLShaderUniformDeclaration::GLSLShaderUniformDeclaration(ShaderDomain domain, ShaderStruct* sStruct, const std::string& name, u32 count)
+        : m_Domain(domain), m_Struct(sStruct), m_Type(GLSLShaderUniformDeclaration::Type::STRUCT), m_Name(name), m_Count(count) {
+        m_Size = sStruct->GetSize() * count;
+        m_Size = sStruct->GetSize() * count;
+    }
+
+    void GLSLShaderUniformDeclaration::SetOffset(u32 offset) {
+        m_Offset = offset;
+    }
+
+    GLSLShaderUniformDeclaration::Type GLSLShaderUniformDeclaration::StringToType(const std::string& type) {
+        if (type == "int")      return Type::INT32;
+        if (type == "float")    return Type::FLOAT32;
+        if (type == "vec2")     return Type::VEC2;
+        if (type == "vec3")     return Type::VEC3;
+        if (type == "vec4")     return Type::VEC4;
+        if (type == "mat3")     return Type::MAT3;
+        if (type == "mat4")     return Type::MAT4;
+
+        return Type::NONE;
+    }
+
+    u32 GLSLShaderUniformDeclaration::SizeOfUniformType(Type type) {
+        switch (type)
+        {
+        case GLSLShaderUniformDeclaration::Type::INT32:       return 4;
+        case GLSLShaderUniformDeclaration::Type::FLOAT32:     return 4;
+        case GLSLShaderUniformDeclaration::Type::VEC2:        return 4 * 2;
+        case GLSLShaderUniformDeclaration::Type::VEC3:        return 4 * 3;
+        case GLSLShaderUniformDeclaration::Type::VEC4:        return 4 * 4;
+        case GLSLShaderUniformDeclaration::Type::MAT3:        return 4 * 3 * 3;
+        case GLSLShaderUniformDeclaration::Type::MAT4:        return 4 * 4 * 4;
+        }
+        return 0;
+    }
+
+    GLSLShaderSamplerDeclaration::GLSLShaderSamplerDeclaration(Type type, const std::string & name, uint32_t count) 
+        : m_Type(type), m_Name(name), m_Count(count) {
+    }
+
+    GLSLShaderSamplerDeclaration::Type GLSLShaderSamplerDeclaration::StringToType(const std::string & type) {
+        if (type == "sampler2D")    return Type::TEXTURE2D;
+        if (type == "samplerCube")  return Type::TEXTURECUBE;
+
+        return Type::NONE;
+    }
+
+    std::string GLSLShaderSamplerDeclaration::TypeToString(Type type) {
+        switch (type)
+        {
+        case Type::TEXTURE2D:       return "sampler2D";
+        case Type::TEXTURECUBE:     return "samplerCube";
+        }
+        return "Error: Invalid Type";
+    }
+
+    ShaderUniformDeclaration * GLSLShaderUniformGroupDeclaration::FindUniformDeclaration(const std::string & name) const {
+        for (auto uniform : m_Uniforms) {
+            if (uniform->GetName() == name)
+                return uniform;
+        }
+        return nullptr;
+    }
+    void GLSLShaderUniformGroupDeclaration::AddUniform(GLSLShaderUniformDeclaration * uniform) {
+        u32 offset = 0;
+        if (m_Uniforms.size()) {
+            // there are already uniforms in the group
+            GLSLShaderUniformDeclaration* previous = (GLSLShaderUniformDeclaration*)m_Uniforms.back();
+            offset = previous->m_Offset + previous->m_Size;
+        }
+        uniform->SetOffset(offset);
+        m_Size += uniform->GetSize();
+        m_Uniforms.push_back(uniform);
+    }
+
+    void GLSLShader::IdentifyUniforms() {
+        auto& vertexSource = m_ShaderSources[ShaderDomain::Vertex];
+        auto& fragmentSource = m_ShaderSources[ShaderDomain::Fragment];
+
+        const char* token;
+        const char* vstr;
+        const char* fstr;
+
+        vstr = vertexSource.c_str();
+        while (token = FindToken(vstr, "struct")) {
+            ParseUniformStruct(GetBlock(token, &vstr), ShaderDomain::Vertex);
+        }
+
+        vstr = vertexSource.c_str();
+        while (token = FindToken(vstr, "uniform")) {
+            if (IsUniformBlock(token)) {
+                // members of a uniform block live in a buffer, not in the program
+                GetBlock(token, &vstr);
+                continue;
+            }
+            ParseUniform(GetStatement(token, &vstr), ShaderDomain::Vertex);
+        }
+
+
+        fstr = fragmentSource.c_str();
+        while (token = FindToken(fstr, "struct")) {
+            ParseUniformStruct(GetBlock(token, &fstr), ShaderDomain::Fragment);
+        }
+
+        fstr = fragmentSource.c_str();
+        while (token = FindToken(fstr, "uniform")) {
+            if (IsUniformBlock(token)) {
+                GetBlock(token, &fstr);
+                continue;
+            }
+            ParseUniform(GetStatement(token, &fstr), ShaderDomain::Fragment);
+        }
+
+    }
+}
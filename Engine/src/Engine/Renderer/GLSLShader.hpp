@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Engine/Renderer/Shader.hpp"
+
+namespace rh {
+
+    class GLSLShaderUniformDeclaration : public ShaderUniformDeclaration {
+    private:
+        friend class GLSLShader;
+        friend class OpenGLShader;
+        friend class GLSLShaderUniformGroupDeclaration;
+    public:
+        enum class Type
+        {
+            NONE, FLOAT32, VEC2, VEC3, VEC4, MAT3, MAT4, INT32, STRUCT
+        };
+    public:
+        GLSLShaderUniformDeclaration(ShaderDomain domain, Type type, const std::string& name, u32 count);
+        GLSLShaderUniformDeclaration(ShaderDomain domain, ShaderStruct* sStruct, const std::string& name, u32 count);
+
+        virtual const std::string& GetName() const override { return m_Name; }
+        virtual u32 GetSize() const override { return m_Size; }
+        virtual u32 GetCount() const override { return m_Count; }
+        virtual u32 GetOffset() const override { return m_Offset; }
+        virtual ShaderDomain GetDomain() const override { return m_Domain; }
+
+        inline Type GetType() const { return m_Type; }
+        inline u32 GetLocation() const { return m_Location; }
+
+    private:
+        virtual void SetOffset(u32 offset) override;
+        void SetLocation(u32 location) { m_Location = location; }
+
+        static Type StringToType(const std::string& typeString);
+        static u32 SizeOfUniformType(Type type);
+
+    private:
+        std::string m_Name;
+        u32 m_Size, m_Offset;
+        ShaderDomain m_Domain; // shader source type
+        Type m_Type; // if a simple variable
+        ShaderStruct* m_Struct; // if a struct
+        u32 m_Count; // if an array of vars
+        u32 m_Location; // set by the backend after linking
+    };
+
+    class GLSLShaderSamplerDeclaration : public ShaderSamplerDeclaration
+    {
+    public:
+        enum class Type
+        {
+            NONE, TEXTURE2D, TEXTURECUBE
+        };
+    private:
+        friend class GLSLShader;
+        friend class OpenGLShader;
+    public:
+        GLSLShaderSamplerDeclaration(Type type, const std::string& name, uint32_t count);
+
+        inline const std::string& GetName() const override { return m_Name; }
+        inline uint32_t GetID() const override { return m_ID; }
+        inline uint32_t GetCount() const override { return m_Count; }
+
+        inline Type GetType() const { return m_Type; }
+
+    public:
+        static Type StringToType(const std::string& type);
+        static std::string TypeToString(Type type);
+
+    private:
+        std::string m_Name;
+        uint32_t m_ID = 0;
+        uint32_t m_Count;
+        Type m_Type;
+    };
+
+    class GLSLShaderUniformGroupDeclaration : public ShaderUniformGroupDeclaration {
+    private:
+        friend class Shader;
+    public:
+        //"vertShaderGroup", domain
+        GLSLShaderUniformGroupDeclaration(const std::string& name, ShaderDomain domain);
+        virtual ~GLSLShaderUniformGroupDeclaration();
+
+        virtual const std::string& GetName() const override { return m_Name; }
+        virtual u32 GetSize() const override { return m_Size; }
+        virtual const std::vector<ShaderUniformDeclaration*>& GetUniformDeclarations() const override { return m_Uniforms; }
+        virtual ShaderUniformDeclaration* FindUniformDeclaration(const std::string& name) const override;
+
+        void AddUniform(GLSLShaderUniformDeclaration* uniform);
+        ShaderDomain GetDomain() const { return m_Domain; }
+
+        void Reset();
+
+    private:
+        std::string m_Name;
+        u32 m_Size;
+        std::vector<ShaderUniformDeclaration*> m_Uniforms;
+        ShaderDomain m_Domain;
+    };
+
+    /// Reads a GLSL source file and reflects its uniforms, structs and samplers into
+    /// the declarations materials are laid out from. Nothing here touches a graphics API,
+    /// the backends only compile the sources and resolve locations.
+    class GLSLShader : public Shader {
+    public:
+        virtual ~GLSLShader();
+
+        virtual const std::string& GetName() const override { return m_Name; }
+
+        virtual bool HasFragUniformBuffer() const override { return (bool)m_FragUniformGroup; }
+        virtual bool HasVertUniformBuffer() const override { return (bool)m_VertexUniformGroup; }
+        virtual const ShaderUniformGroupDeclaration& GetVertUniformGroup() const override { return *m_VertexUniformGroup; }
+        virtual const ShaderUniformGroupDeclaration& GetFragUniformGroup() const override { return *m_FragUniformGroup; }
+        virtual const std::vector<ShaderSamplerDeclaration*>& GetSamplers() const override { return m_Samplers; }
+
+    protected:
+        GLSLShader(const std::string& path);
+        GLSLShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
+
+        /// Re-read the '#type' sections of a source file
+        void ReadSource(const std::string& path);
+        /// Rebuild the uniform and sampler declarations from the current sources
+        void Reflect();
+
+    private:
+        std::string ReadFile(const std::string& path);
+        std::unordered_map<ShaderDomain, std::string> PreProcess(const std::string& source);
+
+        void ParseUniform(const std::string& statement, ShaderDomain domain);
+        void ParseUniformStruct(const std::string& statement, ShaderDomain domain);
+        void AssignSamplerSlots();
+        void IdentifyUniforms();
+        ShaderStruct* FindStruct(const std::string& structName) const;
+
+    protected:
+        std::unordered_map<ShaderDomain, std::string> m_ShaderSources;
+        Ref<GLSLShaderUniformGroupDeclaration> m_FragUniformGroup;
+        Ref<GLSLShaderUniformGroupDeclaration> m_VertexUniformGroup;
+        std::vector<ShaderStruct*> m_Structs;
+        std::vector<ShaderSamplerDeclaration*> m_Samplers;
+
+        std::string m_Name;
+        std::string m_filepath;
+    };
+}
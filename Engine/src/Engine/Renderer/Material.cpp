@@ -77,13 +77,18 @@ namespace rh {
 
     void Material::Bind()
     {
-        m_Shader->Bind();
+        Bind(m_Shader.get());
+    }
+
+    void Material::Bind(Shader* shader)
+    {
+        shader->Bind();
 
         if (m_VertUniformStorage)
-            m_Shader->SetVertUniformBuffer(m_VertUniformStorage);
+            shader->SetVertUniformBuffer(m_VertUniformStorage);
 
         if (m_FragUniformStorage)
-            m_Shader->SetFragUniformBuffer(m_FragUniformStorage);
+            shader->SetFragUniformBuffer(m_FragUniformStorage);
 
         BindTextures();
     }
@@ -141,18 +146,22 @@ namespace rh {
     }
 
     void MaterialInstance::Bind() {
+        Bind(m_Material->m_Shader.get());
+    }
+
+    void MaterialInstance::Bind(Shader* shader) {
 
         // bind the base material
-        m_Material->Bind();
+        m_Material->Bind(shader);
 
         // if the material instance has anything to override, bind that
-        m_Material->m_Shader->Bind();
+        shader->Bind();
 
         if (m_VertStorage)
-            m_Material->m_Shader->SetVertUniformBuffer(m_VertStorage, m_OverriddenValues);
+            shader->SetVertUniformBuffer(m_VertStorage, m_OverriddenValues);
 
         if (m_FragStorage)
-            m_Material->m_Shader->SetFragUniformBuffer(m_FragStorage, m_OverriddenValues);
+            shader->SetFragUniformBuffer(m_FragStorage, m_OverriddenValues);
 
         //m_Material->BindTextures();
         for (size_t i = 0; i < m_Textures.size(); i++)
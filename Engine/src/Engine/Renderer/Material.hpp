@@ -17,6 +17,9 @@ namespace rh {
         virtual ~Material();
 
         void Bind();
+        /// Bind the material values against a shader with the same u_ uniforms and samplers,
+        /// e.g. an instanced variant of the material's shader
+        void Bind(Shader* shader);
 
         template <typename T>
         void Set(const std::string& name, const T& value)
@@ -88,6 +91,7 @@ namespace rh {
         virtual ~MaterialInstance();
 
         void Bind();
+        void Bind(Shader* shader);
         Ref<Shader> GetShader() { return m_Material->m_Shader; }
         const std::string& GetName() { return m_Name; }
 
@@ -4,6 +4,7 @@
 #include "Engine/Renderer/Renderer.hpp"
 
 #include "Engine/Resources/nbt/nbt.hpp"
+#include "Engine/Resources/nbt/sax.hpp"
 
 #include "Engine/Resources/MaterialCatalog.hpp"
 
@@ -194,6 +195,9 @@ namespace rh {
 
                 m_Skeleton.bones.push_back(joint);
             }
+
+            // bind pose until an animation gets sampled
+            UpdateSkinningPalette();
         }
 
         // DATA block
@@ -251,6 +255,9 @@ namespace rh {
             }
         }
 
+        ComputeSubmeshBounds(vertex_data_ptr, m_hasAnimations ? sizeof(Vertex_Anim) : sizeof(Vertex),
+            reinterpret_cast<const u32*>(m_Tris.data()), numInds);
+
         // Animations catalog
         if (m_hasAnimations) {
             char ANIMS[4];
@@ -358,6 +365,9 @@ namespace rh {
             auto ib = IndexBuffer::Create(m_Tris.data(), m_Tris.size() * 3); // TODO: make sure this is # if indices
             m_VertexArray->SetIndexBuffer(ib);
 
+            if (!m_hasAnimations)
+                CreateInstanceBuffer();
+
             m_VertexArray->Unbind();
         }
 
@@ -369,14 +379,117 @@ namespace rh {
         m_loaded = true;
     }
 
+    void Mesh::ComputeSubmeshBounds(const void* vertices, size_t stride, const u32* indices, u32 numInds) {
+        for (auto& sm : m_Submeshes) {
+            if (sm.BaseIndex + sm.IndexCount > numInds) {
+                ENGINE_LOG_WARN("Submesh indices out of range, bounds left empty");
+                sm.Bounds = BoundingVolume::FromIndexedPositions(vertices, stride, indices, 0);
+                continue;
+            }
+
+            // Position is the first member of both vertex types
+            sm.Bounds = BoundingVolume::FromIndexedPositions(vertices, stride, indices + sm.BaseIndex, sm.IndexCount);
+        }
+    }
+
+    void Mesh::CreateInstanceBuffer() {
+        // starts small, SetData grows it to the largest instance group seen
+        m_InstanceBuffer = VertexBuffer::Create(16 * sizeof(laml::Mat4));
+        m_InstanceBuffer->SetLayout(BufferLayout({
+            { ShaderDataType::Mat4, "a_InstanceTransform" },
+            }, 1));
+        m_VertexArray->AddVertexBuffer(m_InstanceBuffer);
+
+        m_InstancedShader = Renderer::GetShaderLibrary()->Get("PrePass_Instanced");
+    }
+
+    namespace { // anonymous
+        // Streams an .nbt mesh: the vertex and index arrays are read straight into the
+        // vectors that get uploaded, the top-level material settings are kept on the side
+        class MeshNbtReader : public nbt::sax_handler {
+        public:
+            using nbt::sax_handler::value;
+
+            std::vector<Vertex> Vertices;
+            std::vector<Triangle> Tris;
+            int NumVerts = 0;
+            int NumInds = 0;
+
+            bool HasString(const char* key) const { return m_Strings.find(key) != m_Strings.end(); }
+            const std::string& GetString(const char* key) const { return m_Strings.at(key); }
+
+            float GetFloat(const char* key, float fallback) const {
+                auto it = m_Floats.find(key);
+                return it != m_Floats.end() ? it->second : fallback;
+            }
+
+            laml::Vec3 GetAlbedoColor(const laml::Vec3& fallback) const {
+                return m_HasAlbedoColor ? m_AlbedoColor : fallback;
+            }
+
+            void key(std::string_view name) override { m_Key = name; }
+            void begin_compound() override { m_Depth++; }
+            void end_compound() override { m_Depth--; }
+            void begin_list(nbt::tag_type, size_t) override { m_Depth++; }
+            void end_list() override { m_Depth--; }
+
+            void value(nbt::nbt_int x) override {
+                if (m_Depth != 1) return;
+                if (m_Key == "num_verts") NumVerts = x;
+                if (m_Key == "num_inds")  NumInds = x;
+            }
+
+            void value(nbt::nbt_float x) override {
+                if (m_Depth == 1) m_Floats[m_Key] = x;
+            }
+
+            void value(const laml::Vec3& x) override {
+                if (m_Depth == 1 && m_Key == "albedo_color") {
+                    m_AlbedoColor = x;
+                    m_HasAlbedoColor = true;
+                }
+            }
+
+            void string(std::string_view str) override {
+                if (m_Depth == 1) m_Strings[m_Key] = std::string(str);
+            }
+
+            void* array(nbt::tag_type type, size_t count) override {
+                if (m_Depth != 1)
+                    return nullptr;
+
+                if (type == nbt::tag_type::Byte_Array && m_Key == "vertices" && count % sizeof(Vertex) == 0) {
+                    Vertices.resize(count / sizeof(Vertex));
+                    return Vertices.data();
+                }
+                if (type == nbt::tag_type::Int_Array && m_Key == "indices" && count % 3 == 0) {
+                    Tris.resize(count / 3);
+                    return Tris.data();
+                }
+                return nullptr;
+            }
+
+        private:
+            std::string m_Key;
+            int m_Depth = 0;
+
+            std::unordered_map<std::string, std::string> m_Strings;
+            std::unordered_map<std::string, float> m_Floats;
+            laml::Vec3 m_AlbedoColor;
+            bool m_HasAlbedoColor = false;
+        };
+    }
+
     // NBT file load
     Mesh::Mesh(const std::string & filename, float, float) {
         ENGINE_LOG_INFO("Loading a mesh from a .nbt file");
 
-        nbt::file_data data;
+        // stream the file straight into the vertex/index arrays. compressed files
+        // only keep the block being read unpacked next to them
+        MeshNbtReader reader;
         nbt::nbt_byte version_major, version_minor;
         endian::endian endianness;
-        if (!nbt::read_from_file(filename, data, version_major, version_minor, endianness)) {
+        if (!nbt::sax_read_from_file(filename, reader, version_major, version_minor, endianness)) {
             ENGINE_LOG_ERROR("Failed to read nbt dat for mesh [{0}]", filename);
             m_loaded = false;
             return;
@@ -385,28 +498,16 @@ namespace rh {
         ENGINE_LOG_INFO("Mesh loaded correctly. Version {0}.{1}, {2}-endian", version_major, version_minor,
             (endianness == endian::big ? "big" : "little"));
 
-        auto str = data.first;
-        auto& comp = data.second->as<nbt::tag_compound>();
-
-        int num_verts = comp["num_verts"].as<nbt::tag_int>().get();
-        int num_inds  = comp["num_inds"].as<nbt::tag_int>().get();
+        int num_verts = reader.NumVerts;
+        int num_inds  = reader.NumInds;
         int num_tris = num_inds / 3;
         ENGINE_LOG_ASSERT(num_tris * 3 == num_inds, ".nbt mesh needs to be triangulated!!");
-        auto vert_byte_array = comp["vertices"].as<nbt::tag_byte_array>().get();
-        auto ind_int_array  = comp["indices"].as<nbt::tag_int_array>().get();
 
-        ENGINE_LOG_ASSERT(vert_byte_array.size() == sizeof(Vertex)*num_verts, ".nbt mesh data mismatch");
-        ENGINE_LOG_ASSERT(ind_int_array.size()*sizeof(nbt::nbt_int)  == sizeof(u32)*num_inds, ".nbt mesh data mismatch");
+        ENGINE_LOG_ASSERT(reader.Vertices.size() == (size_t)num_verts, ".nbt mesh data mismatch");
+        ENGINE_LOG_ASSERT(reader.Tris.size() == (size_t)num_tris, ".nbt mesh data mismatch");
 
-        std::vector<Vertex> m_Vertices;
-        m_Vertices.reserve(num_verts);
-        Vertex* _vertex = reinterpret_cast<Vertex*>(vert_byte_array.data());
-        m_Vertices.assign(_vertex, _vertex + num_verts);
-
-        std::vector<Triangle> m_Tris;
-        m_Tris.reserve(num_tris);
-        Triangle* _tris = reinterpret_cast<Triangle*>(ind_int_array.data());
-        m_Tris.assign(_tris, _tris+ num_tris);
+        std::vector<Vertex> m_Vertices = std::move(reader.Vertices);
+        std::vector<Triangle> m_Tris = std::move(reader.Tris);
 
         /* manually fill out submesh data */
         Submesh sm;
@@ -417,6 +518,8 @@ namespace rh {
         //sm.BaseVertex = 0; // currently not using this
         m_Submeshes.push_back(sm);
 
+        ComputeSubmeshBounds(m_Vertices.data(), sizeof(Vertex), reinterpret_cast<const u32*>(m_Tris.data()), num_inds);
+
         // Set shader info
         m_MeshShader = Renderer::GetShaderLibrary()->Get("PrePass"); // TODO: allow meshes to choose their shader?
         m_BaseMaterial = std::make_shared<Material>(m_MeshShader);
@@ -425,41 +528,41 @@ namespace rh {
         {
             MaterialSpec mat_spec;
             // see if a comprehensive material is listed to load
-            if (comp.has_key("material")) {
+            if (reader.HasString("material")) {
                 // load material props from this material listing
-                const auto& material_name = comp["material"].as<nbt::tag_string>().get();
+                const auto& material_name = reader.GetString("material");
                 mat_spec = MaterialCatalog::GetMaterial(material_name);
                 ENGINE_LOG_TRACE("This mesh is using material {0}[{1}]", material_name, mat_spec.Name);
             }
 
             // If mesh nbt file overrwrites anything, capture that
-            mat_spec.AlbedoBase = nbt::SafeGetVec3(comp, "albedo_color", mat_spec.AlbedoBase);
-            mat_spec.MetalnessBase = nbt::SafeGetFloat(comp, "metalness", mat_spec.MetalnessBase);
-            mat_spec.RoughnessBase = nbt::SafeGetFloat(comp, "roughness", mat_spec.RoughnessBase);
-            mat_spec.TextureScale = nbt::SafeGetFloat(comp, "texture_scale", mat_spec.TextureScale);
+            mat_spec.AlbedoBase = reader.GetAlbedoColor(mat_spec.AlbedoBase);
+            mat_spec.MetalnessBase = reader.GetFloat("metalness", mat_spec.MetalnessBase);
+            mat_spec.RoughnessBase = reader.GetFloat("roughness", mat_spec.RoughnessBase);
+            mat_spec.TextureScale = reader.GetFloat("texture_scale", mat_spec.TextureScale);
 
-            if (comp.has_key("albedo_path")) {
-                const auto& albedo_path = comp.at("albedo_path").as<nbt::tag_string>().get();
+            if (reader.HasString("albedo_path")) {
+                const auto& albedo_path = reader.GetString("albedo_path");
                 mat_spec.Albedo = MaterialCatalog::GetTexture(albedo_path);
             }
-            if (comp.has_key("normal_path")) {
-                const auto& normal_path = comp.at("normal_path").as<nbt::tag_string>().get();
+            if (reader.HasString("normal_path")) {
+                const auto& normal_path = reader.GetString("normal_path");
                 mat_spec.Normal = MaterialCatalog::GetTexture(normal_path);
             }
-            if (comp.has_key("ambient_path")) {
-                const auto& ambient_path = comp.at("ambient_path").as<nbt::tag_string>().get();
+            if (reader.HasString("ambient_path")) {
+                const auto& ambient_path = reader.GetString("ambient_path");
                 mat_spec.Ambient = MaterialCatalog::GetTexture(ambient_path);
             }
-            if (comp.has_key("metalness_path")) {
-                const auto& metalness_path = comp.at("metalness_path").as<nbt::tag_string>().get();
+            if (reader.HasString("metalness_path")) {
+                const auto& metalness_path = reader.GetString("metalness_path");
                 mat_spec.Metalness = MaterialCatalog::GetTexture(metalness_path);
             }
-            if (comp.has_key("roughness_path")) {
-                const auto& roughness_path = comp.at("roughness_path").as<nbt::tag_string>().get();
+            if (reader.HasString("roughness_path")) {
+                const auto& roughness_path = reader.GetString("roughness_path");
                 mat_spec.Roughness = MaterialCatalog::GetTexture(roughness_path);
             }
-            if (comp.has_key("emissive_path")) {
-                const auto& emissive_path = comp.at("emissive_path").as<nbt::tag_string>().get();
+            if (reader.HasString("emissive_path")) {
+                const auto& emissive_path = reader.GetString("emissive_path");
                 mat_spec.Emissive = MaterialCatalog::GetTexture(emissive_path);
             }
                     
@@ -516,6 +619,9 @@ namespace rh {
             auto ib = IndexBuffer::Create(m_Tris.data(), m_Tris.size() * 3); // TODO: make sure this is # if indices
             m_VertexArray->SetIndexBuffer(ib);
 
+            if (!m_hasAnimations)
+                CreateInstanceBuffer();
+
             m_VertexArray->Unbind();
         }
 
@@ -551,7 +657,12 @@ namespace rh {
         }
     }
 
-    void Mesh::OnUpdate(float dt) {
+    void Mesh::OnUpdate(float dt, u64 frame) {
+        // already advanced by another entity using this mesh
+        if (frame == m_lastUpdateFrame)
+            return;
+        m_lastUpdateFrame = frame;
+
         // if has animations, update animation state.
         if (m_hasAnimations && m_currentAnim) {
             m_animTime += dt;
@@ -580,8 +691,23 @@ namespace rh {
             }
         
             //ENGINE_LOG_DEBUG("Interpolating between frames {0} and {1} out of {2} [{3}]", frame1, frame2, m_currentAnim->num_samples, interp);
-        
-            UpdateSkeleton(frame1, frame2, interp);
+
+            // a paused or clamped animation keeps sampling the same pose, skip rebuilding it
+            const PoseKey& key = m_PaletteKey;
+            if (key.anim != m_currentAnim || key.frame1 != frame1 || key.frame2 != frame2 || key.interp != interp) {
+                m_PaletteKey = { m_currentAnim, frame1, frame2, interp };
+
+                UpdateSkeleton(frame1, frame2, interp);
+                UpdateSkinningPalette();
+            }
+        }
+    }
+
+    void Mesh::UpdateSkinningPalette() {
+        m_SkinningPalette.resize(m_Skeleton.bones.size());
+        for (size_t n = 0; n < m_Skeleton.bones.size(); n++) {
+            const SkeleJoint& bone = m_Skeleton.bones[n];
+            m_SkinningPalette[n] = laml::mul(bone.finalTransform, bone.inverse_model_matrix);
         }
     }
 
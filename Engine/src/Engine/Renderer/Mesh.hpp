@@ -10,6 +10,7 @@
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/Frustum.hpp"
 
 namespace rh {
 
@@ -92,6 +93,9 @@ namespace rh {
         u32 IndexCount;
 
         laml::Mat4 Transform;
+
+        // bounds of the submesh vertices, before Transform is applied
+        BoundingVolume Bounds;
     };
 
     class Mesh
@@ -105,7 +109,9 @@ namespace rh {
 
         bool Loaded() { return m_loaded; }
 
-        void OnUpdate(float dt);
+        /// Advance the current animation. Meshes are shared between entities, so
+        /// only the first call for a given frame index does anything.
+        void OnUpdate(float dt, u64 frame);
 
         std::vector<Submesh>& GetSubmeshes() { return m_Submeshes; }
         const std::vector<Submesh>& GetSubmeshes() const { return m_Submeshes; }
@@ -121,15 +127,24 @@ namespace rh {
         void SetCurrentAnimation(const std::string& anim_name);
         inline bool HasAnimations() const { return m_hasAnimations; }
         inline const Skeleton& GetSkeleton() const { return m_Skeleton; }
+        /// Skinning matrices of the current pose, one per bone, ready for the shader
+        inline const std::vector<laml::Mat4>& GetSkinningPalette() const { return m_SkinningPalette; }
     private:
         void populateAnimationData(const std::string& filename);
         //void SampleAnimation(float frame_time);
         void UpdateSkeleton(u32 frame1, u32 frame2, f32 interp);
+        void UpdateSkinningPalette();
+        void ComputeSubmeshBounds(const void* vertices, size_t stride, const u32* indices, u32 numInds);
+        void CreateInstanceBuffer();
 
     private:
         // Hardware buffer of verts
         Ref<VertexArray> m_VertexArray;
 
+        // per-instance transforms for instanced draws, static meshes only
+        Ref<VertexBuffer> m_InstanceBuffer;
+        Ref<Shader> m_InstancedShader;
+
         // submesh info
         std::vector<Submesh> m_Submeshes;
 
@@ -148,6 +163,16 @@ namespace rh {
         Animation* m_currentAnim = nullptr;
         bool m_hasAnimations = false;
         f64 m_animTime = 0.0;
+        u64 m_lastUpdateFrame = ~0ull;
+
+        // finalTransform * inverse_model_matrix per bone, only rebuilt when the sampled pose changes
+        struct PoseKey {
+            const Animation* anim;
+            u32 frame1, frame2;
+            f32 interp;
+        };
+        std::vector<laml::Mat4> m_SkinningPalette;
+        PoseKey m_PaletteKey = { nullptr, 0, 0, 0.0f };
 
         friend class Renderer;
     };
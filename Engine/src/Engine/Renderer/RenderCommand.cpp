@@ -5,4 +5,9 @@
 
 namespace rh {
     RendererAPI* RenderCommand::s_RendererAPI = new OpenGLRendererAPI();
+
+    void RenderCommand::SetAPI(RendererAPI::API api) {
+        delete s_RendererAPI;
+        s_RendererAPI = RendererAPI::Create(api);
+    }
 }
\ No newline at end of file
@@ -21,9 +21,15 @@ namespace rh {
         inline static void DrawSubIndexed_points(u32 startIndex, u32 startVertex, u32 count) {
             s_RendererAPI->DrawSubIndexed_points(startIndex, startVertex, count);
         }
+        inline static void DrawLineArray(u32 startVertex, u32 vertexCount) {
+            s_RendererAPI->DrawLineArray(startVertex, vertexCount);
+        }
         inline static void DrawSubIndexed(u32 startIndex, u32 startVertex, u32 count) {
             s_RendererAPI->DrawSubIndexed(startIndex, startVertex, count);
         }
+        inline static void DrawSubIndexedInstanced(u32 startIndex, u32 startVertex, u32 count, u32 instanceCount) {
+            s_RendererAPI->DrawSubIndexedInstanced(startIndex, startVertex, count, instanceCount);
+        }
         inline static void Init() {
             s_RendererAPI->Init();
         }
@@ -51,6 +57,13 @@ namespace rh {
         inline static void SetWireframe(bool enabled) {
             s_RendererAPI->SetWireframe(enabled);
         }
+        inline static u32 GetMaxTextureSlots() {
+            return s_RendererAPI->GetMaxTextureSlots();
+        }
+
+        /// Switch backends (OpenGL by default). Has to happen before Renderer::Init,
+        /// resources made by the old backend can't be used with the new one.
+        static void SetAPI(RendererAPI::API api);
     private:
         static RendererAPI * s_RendererAPI;
     };
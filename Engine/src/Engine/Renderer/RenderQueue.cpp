@@ -0,0 +1,124 @@
+#include <enpch.hpp>
+#include "RenderQueue.hpp"
+
+namespace rh {
+
+    #define KEY_PASS_BITS     4
+    #define KEY_SHADER_BITS   12
+    #define KEY_MATERIAL_BITS 16
+    #define KEY_VAO_BITS      12
+    #define KEY_DEPTH_BITS    20
+
+    #define KEY_DEPTH_SHIFT    0
+    #define KEY_VAO_SHIFT      (KEY_DEPTH_SHIFT + KEY_DEPTH_BITS)
+    #define KEY_MATERIAL_SHIFT (KEY_VAO_SHIFT + KEY_VAO_BITS)
+    #define KEY_SHADER_SHIFT   (KEY_MATERIAL_SHIFT + KEY_MATERIAL_BITS)
+    #define KEY_PASS_SHIFT     (KEY_SHADER_SHIFT + KEY_SHADER_BITS)
+
+    #define KEY_MASK(bits) ((1ull << (bits)) - 1)
+
+    static_assert(KEY_PASS_SHIFT + KEY_PASS_BITS == 64, "Render key must use all 64 bits");
+
+    /// Positive floats order the same as their bit patterns, so the top bits of a
+    /// non-negative depth make a monotonic fixed-width key without needing a far plane.
+    static u32 QuantizeDepth(f32 depth) {
+        if (!(depth > 0.0f)) // behind the camera or NaN
+            return 0;
+
+        u32 bits;
+        memcpy(&bits, &depth, sizeof(bits));
+        return bits >> (31 - KEY_DEPTH_BITS);
+    }
+
+    RenderQueue::RenderQueue() {
+        m_packets.reserve(256);
+        m_order.reserve(256);
+    }
+
+    u64 RenderQueue::MakeKey(u8 pass, u32 shaderID, u32 materialID, u32 vertexArrayID, f32 depth) {
+        return ((u64(pass)           & KEY_MASK(KEY_PASS_BITS))     << KEY_PASS_SHIFT)
+             | ((u64(shaderID)       & KEY_MASK(KEY_SHADER_BITS))   << KEY_SHADER_SHIFT)
+             | ((u64(materialID)     & KEY_MASK(KEY_MATERIAL_BITS)) << KEY_MATERIAL_SHIFT)
+             | ((u64(vertexArrayID)  & KEY_MASK(KEY_VAO_BITS))      << KEY_VAO_SHIFT)
+             | ((u64(QuantizeDepth(depth)) & KEY_MASK(KEY_DEPTH_BITS)) << KEY_DEPTH_SHIFT);
+    }
+
+    u32 RenderQueue::GetStateID(StateIDTable& table, const void* state, u32 maxIDs) {
+        auto it = table.find(state);
+        if (it != table.end())
+            return it->second;
+
+        // out of IDs until the table is reset in Clear(), share the last one.
+        // draws still replay correctly, they just don't get grouped as well.
+        u32 id = (u32)table.size();
+        if (id >= maxIDs)
+            return maxIDs - 1;
+
+        table.emplace(state, id);
+        return id;
+    }
+
+    void RenderQueue::Submit(u8 pass, const void* shader, const void* material, const void* vertexArray, f32 depth, const DrawPacket& packet) {
+        u32 shaderID   = GetStateID(m_shaderIDs,      shader,      (u32)KEY_MASK(KEY_SHADER_BITS));
+        u32 materialID = GetStateID(m_materialIDs,    material,    (u32)KEY_MASK(KEY_MATERIAL_BITS));
+        u32 vaoID      = GetStateID(m_vertexArrayIDs, vertexArray, (u32)KEY_MASK(KEY_VAO_BITS));
+
+        SortEntry entry;
+        entry.key = MakeKey(pass, shaderID, materialID, vaoID, depth);
+        entry.index = (u32)m_packets.size();
+
+        m_packets.push_back(packet);
+        m_order.push_back(entry);
+    }
+
+    void RenderQueue::Sort() {
+        BENCHMARK_FUNCTION();
+
+        const size_t count = m_order.size();
+        if (count < 2)
+            return;
+
+        m_scratch.resize(count);
+        SortEntry* src = m_order.data();
+        SortEntry* dst = m_scratch.data();
+
+        // LSD radix sort, one byte per pass
+        for (u32 shift = 0; shift < 64; shift += 8) {
+            size_t offsets[256] = { 0 };
+            for (size_t n = 0; n < count; n++) {
+                offsets[(src[n].key >> shift) & 0xFF]++;
+            }
+
+            // every key has the same byte here, nothing to do for this pass
+            if (offsets[(src[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            size_t sum = 0;
+            for (u32 b = 0; b < 256; b++) {
+                size_t c = offsets[b];
+                offsets[b] = sum;
+                sum += c;
+            }
+
+            for (size_t n = 0; n < count; n++) {
+                dst[offsets[(src[n].key >> shift) & 0xFF]++] = src[n];
+            }
+
+            std::swap(src, dst);
+        }
+
+        if (src != m_order.data()) {
+            memcpy(m_order.data(), src, count * sizeof(SortEntry));
+        }
+    }
+
+    void RenderQueue::Clear() {
+        m_packets.clear();
+        m_order.clear();
+
+        // IDs only have to be consistent within a frame, start over once a table gets full
+        if (m_shaderIDs.size()      >= KEY_MASK(KEY_SHADER_BITS))   m_shaderIDs.clear();
+        if (m_materialIDs.size()    >= KEY_MASK(KEY_MATERIAL_BITS)) m_materialIDs.clear();
+        if (m_vertexArrayIDs.size() >= KEY_MASK(KEY_VAO_BITS))      m_vertexArrayIDs.clear();
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Engine/Core/Base.hpp"
+
+namespace rh {
+
+    class Mesh;
+    class Submesh;
+    class MaterialInstance;
+
+    /// One recorded draw: a submesh, its material and its final world transform
+    struct DrawPacket {
+        const Mesh* mesh;
+        const Submesh* submesh;
+        MaterialInstance* material;
+        laml::Mat4 transform;
+    };
+
+    /// State changes and draws made while replaying a queue.
+    /// packets is the draw count without instancing, drawCalls the count actually issued.
+    struct RenderQueueStats {
+        u32 packets;
+        u32 drawCalls;
+        u32 instancedDrawCalls;
+        u32 instances;
+        u32 shaderChanges;
+        u32 materialChanges;
+        u32 vertexArrayChanges;
+    };
+
+    /// Linear per-frame buffer of draw packets. Packets get radix-sorted by a
+    /// 64-bit key before they are replayed, so draws sharing state end up next to each other.
+    /// Key layout, most significant bits first:
+    ///     pass:4 | shader:12 | material:16 | vertex array:12 | depth:20
+    /// The queue never touches the graphics API, state is only used as an opaque pointer.
+    class RenderQueue {
+    public:
+        enum Pass : u8 {
+            Pass_DeferredPrepass = 0
+        };
+
+        RenderQueue();
+
+        /// Record a packet. The state pointers are mapped to small IDs for the sort key,
+        /// depth is the view-space distance (front-to-back within equal state).
+        void Submit(u8 pass, const void* shader, const void* material, const void* vertexArray, f32 depth, const DrawPacket& packet);
+
+        /// Radix sort the packets by key. Stable, so equal keys keep submission order.
+        void Sort();
+
+        /// Drop all packets, keeping the memory for the next frame
+        void Clear();
+
+        size_t GetCount() const { return m_order.size(); }
+
+        /// Packet/key in sorted order (submission order until Sort() is called)
+        const DrawPacket& GetPacket(size_t i) const { return m_packets[m_order[i].index]; }
+        u64 GetKey(size_t i) const { return m_order[i].key; }
+
+        static u64 MakeKey(u8 pass, u32 shaderID, u32 materialID, u32 vertexArrayID, f32 depth);
+
+    private:
+        struct SortEntry {
+            u64 key;
+            u32 index;
+        };
+
+        typedef std::unordered_map<const void*, u32> StateIDTable;
+        static u32 GetStateID(StateIDTable& table, const void* state, u32 maxIDs);
+
+        std::vector<DrawPacket> m_packets;
+        std::vector<SortEntry> m_order;
+        std::vector<SortEntry> m_scratch;
+
+        StateIDTable m_shaderIDs;
+        StateIDTable m_materialIDs;
+        StateIDTable m_vertexArrayIDs;
+    };
+}
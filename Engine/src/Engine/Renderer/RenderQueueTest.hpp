@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Engine/Renderer/RenderQueue.hpp"
+
+#include <cfloat>
+
+// CPU-only checks of the RenderQueue sort keys, no window or GL context needed.
+// Every packet carries the position it should end up at in transform[3][0].
+namespace rh::renderQueueTest {
+
+    static DrawPacket MakePacket(int expected) {
+        DrawPacket packet = {};
+        packet.transform = laml::Mat4(1.0f);
+        packet.transform[3][0] = (f32)expected;
+        return packet;
+    }
+
+    static bool CheckOrder(const RenderQueue& queue, const char* name) {
+        int mismatches = 0;
+        for (size_t n = 0; n < queue.GetCount(); n++) {
+            if ((int)queue.GetPacket(n).transform[3][0] != (int)n)
+                mismatches++;
+            if (n > 0 && queue.GetKey(n - 1) > queue.GetKey(n))
+                mismatches++;
+        }
+
+        ENGINE_LOG_INFO("RenderQueue {0}: {1}", name, mismatches == 0 ? "passed" : "FAILED");
+        return mismatches == 0;
+    }
+
+    // keys order by pass, then shader, material, vertex array, then depth front to back
+    bool test1() {
+        // the IDs come from the order state is first seen, so submit it in ID order once
+        int state[4];
+        RenderQueue queue;
+        DrawPacket unused = MakePacket(-1);
+        queue.Submit(0, &state[0], &state[0], &state[0], 1.0f, unused);
+        queue.Submit(0, &state[1], &state[1], &state[1], 1.0f, unused);
+        queue.Clear();
+
+        struct draw { u8 pass; int shader, material, vao; f32 depth; int expected; };
+        const draw draws[] = {
+            { 1, 0, 0, 0,  1.0f, 8 },
+            { 0, 1, 0, 0,  1.0f, 6 },
+            { 0, 0, 1, 1,  0.5f, 4 },
+            { 0, 0, 0, 1,  2.0f, 3 },
+            { 0, 1, 1, 0,  9.0f, 7 },
+            { 0, 0, 0, 0, 50.0f, 2 },
+            { 0, 0, 0, 0,  0.1f, 0 },
+            { 0, 0, 1, 1,  3.0f, 5 },
+            { 0, 0, 0, 0,  5.0f, 1 },
+        };
+        for (const draw& d : draws) {
+            queue.Submit(d.pass, &state[d.shader], &state[d.material], &state[d.vao], d.depth, MakePacket(d.expected));
+        }
+        queue.Sort();
+
+        return CheckOrder(queue, "state and depth order");
+    }
+
+    // depth has 20 bits: huge, infinite, zero, negative and NaN depths have to
+    // clamp into that field, and never carry into the vertex array ID above it
+    bool test2() {
+        bool passed = true;
+
+        u64 nearest = RenderQueue::MakeKey(0, 0, 0, 0, 0.0f);
+        passed &= RenderQueue::MakeKey(0, 0, 0, 0, -5.0f) == nearest;
+        passed &= RenderQueue::MakeKey(0, 0, 0, 0, NAN) == nearest;
+        passed &= RenderQueue::MakeKey(0, 0, 0, 0, FLT_MAX) < RenderQueue::MakeKey(0, 0, 0, 1, 0.0f);
+        passed &= RenderQueue::MakeKey(0, 0, 0, 0, INFINITY) < RenderQueue::MakeKey(0, 0, 0, 1, 0.0f);
+        passed &= RenderQueue::MakeKey(0, 0, 0, 0, 1.0e30f) <= RenderQueue::MakeKey(0, 0, 0, 0, FLT_MAX);
+
+        // equal keys keep submission order
+        int state = 0;
+        RenderQueue queue;
+        const f32 depths[] = { -1.0f, 0.0f, NAN, 1.0e-3f, 1.0f, 1.0e6f, 1.0e30f, FLT_MAX, INFINITY };
+        for (int n = 0; n < 9; n++) {
+            queue.Submit(0, &state, &state, &state, depths[n], MakePacket(n));
+        }
+        queue.Sort();
+
+        ENGINE_LOG_INFO("RenderQueue depth clamping: {0}", passed ? "passed" : "FAILED");
+        return CheckOrder(queue, "saturated depth order") && passed;
+    }
+
+    // more shaders than the 12 bit field can hold: IDs saturate at the last one
+    // instead of wrapping around to 0, so the overflow still sorts after everything else
+    bool test3() {
+        const int numShaders = 5000;
+        const u64 lastID = (1 << 12) - 2;
+        std::vector<int> shaders(numShaders);
+        int material = 0;
+
+        // IDs are handed out in submission order, so that is also the sorted order
+        RenderQueue queue;
+        for (int n = 0; n < numShaders; n++) {
+            queue.Submit(0, &shaders[n], &material, &material, 1.0f, MakePacket(n));
+        }
+        queue.Sort();
+
+        bool passed = CheckOrder(queue, "saturated shader order");
+        for (size_t n = 0; n < queue.GetCount(); n++) {
+            u64 shaderID = queue.GetKey(n) >> 48 & 0xFFF;
+            passed &= shaderID == std::min((u64)n, lastID);
+        }
+
+        // a full table starts over on the next frame
+        int newShader = 0;
+        queue.Clear();
+        queue.Submit(0, &newShader, &material, &material, 1.0f, MakePacket(0));
+        passed &= (queue.GetKey(0) >> 48 & 0xFFF) == 0;
+
+        ENGINE_LOG_INFO("RenderQueue shader ID saturation: {0}", passed ? "passed" : "FAILED");
+        return passed;
+    }
+
+    bool RunAll() {
+        bool passed = true;
+        passed &= test1();
+        passed &= test2();
+        passed &= test3();
+        return passed;
+    }
+}
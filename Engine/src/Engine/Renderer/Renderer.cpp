@@ -5,9 +5,11 @@
 #include "Engine/Renderer/Framebuffer.hpp"
 #include "Engine/Renderer/Buffer.hpp"
 #include "Engine/Renderer/TextRenderer.hpp"
+#include "Engine/Renderer/RenderQueue.hpp"
 
 #include "Engine/Sound/SoundEngine.hpp"
 #include "Engine/Core/Input.hpp"
+#include "Engine/Core/Utils.hpp"
 
 #include "Engine/Resources/MaterialCatalog.hpp"
 
@@ -24,13 +26,110 @@ namespace rh {
         laml::Mat4 view;
     };
 
+    #define MAX_SHADER_LIGHTS 32
+    #define MAX_SHADER_BONES 128
+
+    // uniform block binding points, have to match layout(binding = n) in the shaders
+    #define CAMERA_BLOCK_BINDING   0
+    #define LIGHTS_BLOCK_BINDING   1
+    #define SETTINGS_BLOCK_BINDING 2
+    #define OBJECT_BLOCK_BINDING   3
+    #define BONE_BLOCK_BINDING     4
+
+    // frames of per-object data in flight before the ring wraps around to a region
+    #define OBJECT_RING_FRAMES 3
+    #define OBJECT_RING_MIN_CAPACITY 256
+    #define BONE_RING_MIN_CAPACITY 8
+
+    /// std140 mirrors of the shader uniform blocks.
+    /// mat4 is column-major like laml::Mat4, vec3 members are padded to 16 bytes.
+    struct CameraBlock {
+        laml::Mat4 Projection;
+        laml::Mat4 View;
+        laml::Mat4 ViewProjection;
+        f32 CamPos[4];
+    };
+
+    struct LightBlockEntry {
+        f32 Position[3];  f32 _pad0;
+        f32 Direction[3]; f32 _pad1;
+        f32 Color[3];     f32 Strength;
+        f32 Inner;
+        f32 Outer;
+        f32 _pad2[2];
+    };
+
+    struct LightsBlock {
+        LightBlockEntry pointLights[MAX_SHADER_LIGHTS];
+        LightBlockEntry spotLights[MAX_SHADER_LIGHTS];
+        LightBlockEntry sun;
+        s32 NumPointLights;
+        s32 NumSpotLights;
+        s32 _pad[2];
+    };
+
+    struct SettingsBlock {
+        f32 AlbedoTexToggle;
+        f32 NormalTexToggle;
+        f32 MetalnessTexToggle;
+        f32 RoughnessTexToggle;
+        f32 AmbientTexToggle;
+        f32 EmissiveTexToggle;
+        f32 GammaCorrect;
+        f32 ToneMap;
+        s32 OutputSwitch;
+        f32 LineFadeStart;
+        f32 LineFadeEnd;
+        f32 LineFadeMaximum;
+        f32 LineFadeMinimum;
+        f32 _pad[3];
+    };
+
+    struct ObjectBlock {
+        laml::Mat4 Transform;
+    };
+
+    struct BoneBlock {
+        laml::Mat4 Bones[MAX_SHADER_BONES];
+    };
+
+    static_assert(sizeof(laml::Mat4) == 64, "Uniform blocks expect a tightly packed Mat4");
+    static_assert(sizeof(CameraBlock) == 208, "CameraBlock does not match std140");
+    static_assert(sizeof(LightBlockEntry) == 64, "LightBlockEntry does not match std140");
+    static_assert(sizeof(SettingsBlock) % 16 == 0, "SettingsBlock does not match std140");
+
+    /// Vertex of the debug line buffer, two per segment
+    struct DebugLineVertex {
+        laml::Vec3 Position;
+        laml::Vec4 Color;
+    };
+
+    // starting size of the debug line buffer, it grows if a frame needs more
+    #define DEBUG_LINE_INITIAL_VERTICES 4096
+
+    // skinned vertices can leave their bind-pose bounds, so grow them before culling
+    #define SKINNED_BOUNDS_SCALE 1.5f
+
+    /// A submesh draw waiting on the culling stage
+    struct DrawCandidate {
+        DrawPacket packet;
+        const Shader* shader;
+        const VertexArray* vao;
+    };
+
     struct RendererData {
         std::unique_ptr<rh::ShaderLibrary> ShaderLibrary;
         TextureCube* Skybox;
 
         Ref<VertexArray> FullscreenQuad;
         Ref<VertexArray> debug_coordinate_axis; //lineRender
-        Ref<VertexArray> Line;
+
+        // debug lines submitted this frame, uploaded and drawn by FlushDebugLines
+        Ref<VertexArray> DebugLines;
+        Ref<VertexBuffer> DebugLineBuffer;
+        std::vector<DebugLineVertex> DebugLinesDepthTested;
+        std::vector<DebugLineVertex> DebugLinesOverlay;
+        u32 DebugLinesLastFlush;
 
         // Render buffers
         Ref<Framebuffer> gBuffer;
@@ -42,6 +141,43 @@ namespace rh {
 
         Lightingdata Lights;
 
+        // camera, lights and settings blocks packed in one buffer, written once per frame
+        Ref<UniformBuffer> FrameUniforms;
+        std::vector<u8> FrameStaging;
+        u32 CameraBlockOffset;
+        u32 LightsBlockOffset;
+        u32 SettingsBlockOffset;
+
+        // per-draw transforms, one region per frame in flight
+        Ref<UniformBuffer> ObjectUniforms;
+        std::vector<u8> ObjectStaging;
+        u32 ObjectStride;
+        u32 ObjectCapacity;
+        u32 ObjectRingFrame;
+
+        // skinning palettes of the meshes drawn this frame, one slot per mesh
+        Ref<UniformBuffer> BoneUniforms;
+        std::vector<u8> BoneStaging;
+        std::vector<const Mesh*> SkinnedMeshes;
+        u32 BoneStride;
+        u32 BoneCapacity;
+        u32 BoneRingFrame;
+
+        // meshes submitted this frame, culled and replayed in BeginDeferredPrepass
+        std::vector<DrawCandidate> DeferredCandidates;
+        CullingSet DeferredBounds;
+        CullingStats DeferredCullingStats;
+        RenderQueue DeferredQueue;
+        RenderQueueStats DeferredQueueStats;
+        std::vector<laml::Mat4> InstanceTransforms;
+        std::vector<const Submesh*> InstanceSubmeshes;
+        laml::Mat4 ViewMatrix;
+        Frustum ViewFrustum;
+
+        // glGetUniformLocation calls made between Begin3DScene and End3DScene
+        u64 UniformLookupsAtFrameStart;
+        u64 UniformLookupsLastFrame;
+
         u32 OutputMode;
         bool ToneMap;
         bool Gamma;
@@ -51,36 +187,92 @@ namespace rh {
 
     RendererData s_Data;
 
-    void InitLights(const Ref<Shader> shader) {
-        // uploads lights to shader in view-space
+    static u32 AlignUp(u32 value, u32 alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
 
-        // set directional light
-        shader->SetVec3("r_sun.Direction", laml::Vec3(0, 0, 0));
-        shader->SetVec3("r_sun.Color", laml::Vec3(0, 0, 0));
-        shader->SetFloat("r_sun.Strength", 0);
+    static void CreateObjectRing(u32 capacity) {
+        s_Data.ObjectCapacity = capacity;
+        s_Data.ObjectRingFrame = 0;
+        s_Data.ObjectUniforms = UniformBuffer::Create(OBJECT_RING_FRAMES * capacity * s_Data.ObjectStride);
+    }
 
-        // set point lights
-        for (int n = 0; n < 32; n++) {
-            shader->SetVec3("r_pointLights[" + std::to_string(n) + "].Position", laml::Vec3(0, 0, 0));
-            shader->SetVec3("r_pointLights[" + std::to_string(n) + "].Color", laml::Vec3(0, 0, 0));
-            shader->SetFloat("r_pointLights[" + std::to_string(n) + "].Strength", 0);
-        }
+    static void CreateBoneRing(u32 capacity) {
+        s_Data.BoneCapacity = capacity;
+        s_Data.BoneRingFrame = 0;
+        s_Data.BoneUniforms = UniformBuffer::Create(OBJECT_RING_FRAMES * capacity * s_Data.BoneStride);
+    }
 
-        // set spot lights
-        for (int n = 0; n < 32; n++) {
-            shader->SetVec3("r_spotLights[" + std::to_string(n) + "].Position", laml::Vec3(0,0,0));
-            shader->SetVec3("r_spotLights[" + std::to_string(n) + "].Direction", laml::Vec3(0, 0, 0));
-            shader->SetVec3("r_spotLights[" + std::to_string(n) + "].Color", laml::Vec3(0, 0, 0));
-            shader->SetFloat("r_spotLights[" + std::to_string(n) + "].Strength", 0);
-            shader->SetFloat("r_spotLights[" + std::to_string(n) + "].Inner", 0);
-            shader->SetFloat("r_spotLights[" + std::to_string(n) + "].Outer", 0);
-        }
+    static void CreateUniformBuffers() {
+        // lay the per-frame blocks out back to back, each range starting on the bind alignment
+        u32 alignment = UniformBuffer::GetOffsetAlignment();
+        s_Data.CameraBlockOffset = 0;
+        s_Data.LightsBlockOffset = AlignUp(s_Data.CameraBlockOffset + sizeof(CameraBlock), alignment);
+        s_Data.SettingsBlockOffset = AlignUp(s_Data.LightsBlockOffset + sizeof(LightsBlock), alignment);
+        u32 frameSize = s_Data.SettingsBlockOffset + sizeof(SettingsBlock);
+
+        s_Data.FrameUniforms = UniformBuffer::Create(frameSize);
+        s_Data.FrameStaging.assign(frameSize, 0);
+        s_Data.FrameUniforms->BindRange(CAMERA_BLOCK_BINDING, s_Data.CameraBlockOffset, sizeof(CameraBlock));
+        s_Data.FrameUniforms->BindRange(LIGHTS_BLOCK_BINDING, s_Data.LightsBlockOffset, sizeof(LightsBlock));
+        s_Data.FrameUniforms->BindRange(SETTINGS_BLOCK_BINDING, s_Data.SettingsBlockOffset, sizeof(SettingsBlock));
+
+        s_Data.ObjectStride = AlignUp(sizeof(ObjectBlock), alignment);
+        CreateObjectRing(OBJECT_RING_MIN_CAPACITY);
+
+        s_Data.BoneStride = AlignUp(sizeof(BoneBlock), alignment);
+        CreateBoneRing(BONE_RING_MIN_CAPACITY);
+    }
+
+    template<typename T>
+    static T* GetFrameBlock(u32 offset) {
+        return reinterpret_cast<T*>(s_Data.FrameStaging.data() + offset);
+    }
+
+    static void SetSamplerSlots() {
+        // texture units never change, set them once per program link
+        auto lightingShader = s_Data.ShaderLibrary->Get("Lighting");
+        lightingShader->Bind();
+        lightingShader->SetInt("u_normal"_sid, 0);
+        lightingShader->SetInt("u_distance"_sid, 1);
+        lightingShader->SetInt("u_amr"_sid, 2);
+
+        auto ssaoShader = s_Data.ShaderLibrary->Get("SSAO");
+        ssaoShader->Bind();
+        ssaoShader->SetInt("u_amr"_sid, 0);
+
+        auto screenShader = s_Data.ShaderLibrary->Get("Screen");
+        screenShader->Bind();
+        screenShader->SetInt("u_albedo"_sid, 0);
+        screenShader->SetInt("u_normal"_sid, 1);
+        screenShader->SetInt("u_amr"_sid, 2);
+        screenShader->SetInt("u_depth"_sid, 3);
+        screenShader->SetInt("u_diffuse"_sid, 4);
+        screenShader->SetInt("u_specular"_sid, 5);
+        screenShader->SetInt("u_emissive"_sid, 6);
+        screenShader->SetInt("u_ssao"_sid, 7);
+
+        auto sobelShader = s_Data.ShaderLibrary->Get("Sobel");
+        sobelShader->Bind();
+        sobelShader->SetInt("r_texture"_sid, 0);
+
+        auto mixShader = s_Data.ShaderLibrary->Get("Mix");
+        mixShader->Bind();
+        mixShader->SetInt("r_tex1"_sid, 0);
+        mixShader->SetInt("r_tex2"_sid, 1);
+
+        auto lineShader = s_Data.ShaderLibrary->Get("Line3D");
+        lineShader->Bind();
+        lineShader->SetInt("u_distance"_sid, 0);
     }
 
     void Renderer::Init() {
         BENCHMARK_FUNCTION();
         RenderCommand::Init();
 
+        s_Data.UniformLookupsAtFrameStart = 0;
+        s_Data.UniformLookupsLastFrame = 0;
+
         s_Data.ShaderLibrary = std::make_unique<ShaderLibrary>();
         //Renderer::GetShaderLibrary()->Load("Data/Shaders/PBR_static.glsl");
         //Renderer::GetShaderLibrary()->Load("Data/Shaders/Skybox.glsl");
@@ -90,12 +282,15 @@ namespace rh {
 
         Renderer::GetShaderLibrary()->Load("Data/Shaders/PrePass.glsl");
         Renderer::GetShaderLibrary()->Load("Data/Shaders/PrePass_Anim.glsl");
+        Renderer::GetShaderLibrary()->Load("Data/Shaders/PrePass_Instanced.glsl");
 
         Renderer::GetShaderLibrary()->Load("Data/Shaders/Lighting.glsl");
         Renderer::GetShaderLibrary()->Load("Data/Shaders/SSAO.glsl");
         Renderer::GetShaderLibrary()->Load("Data/Shaders/Screen.glsl");
         Renderer::GetShaderLibrary()->Load("Data/Shaders/Sobel.glsl");
         Renderer::GetShaderLibrary()->Load("Data/Shaders/Mix.glsl");
+        SetSamplerSlots();
+        CreateUniformBuffers();
 
         //s_Data.Skybox = TextureCube::Create("Data/Images/DebugCubeMap.tga");
         s_Data.Skybox = MaterialCatalog::GetTextureCube("Data/Images/snowbox.png");
@@ -173,31 +368,22 @@ namespace rh {
             s_Data.debug_coordinate_axis->SetIndexBuffer(ebo);
             s_Data.debug_coordinate_axis->Unbind();
         }
-        // create Line
+        // create the debug line buffer
         {
-            struct _vertex
-            {
-                float Position; // can we remove this entirely?
-            };
-
-            _vertex* data = new _vertex[2];
-
-            data[0].Position = 0;
-            data[1].Position = 1;
-
-            u32 indices[2] = { 0, 1 };
-
-            auto vbo = VertexBuffer::Create(data, 2 * sizeof(_vertex));
-            vbo->SetLayout({
-                { ShaderDataType::Float, "a_Position" }
+            s_Data.DebugLineBuffer = VertexBuffer::Create(DEBUG_LINE_INITIAL_VERTICES * sizeof(DebugLineVertex));
+            s_Data.DebugLineBuffer->SetLayout({
+                { ShaderDataType::Float3, "a_Position" },
+                { ShaderDataType::Float4, "a_Color" }
                 });
-            auto ebo = IndexBuffer::Create(indices, 2);
 
-            s_Data.Line = VertexArray::Create();
-            s_Data.Line->Bind();
-            s_Data.Line->AddVertexBuffer(vbo);
-            s_Data.Line->SetIndexBuffer(ebo);
-            s_Data.Line->Unbind();
+            s_Data.DebugLines = VertexArray::Create();
+            s_Data.DebugLines->Bind();
+            s_Data.DebugLines->AddVertexBuffer(s_Data.DebugLineBuffer);
+            s_Data.DebugLines->Unbind();
+
+            s_Data.DebugLinesDepthTested.reserve(DEBUG_LINE_INITIAL_VERTICES);
+            s_Data.DebugLinesOverlay.reserve(DEBUG_LINE_INITIAL_VERTICES);
+            s_Data.DebugLinesLastFlush = 0;
         }
 
         // create the pipeline buffers
@@ -289,7 +475,7 @@ namespace rh {
         // TODO: make this work with a deferred renderer :(
         auto skyboxShader = s_Data.ShaderLibrary->Get("Skybox");
         skyboxShader->Bind();
-        skyboxShader->SetMat4("r_inverseVP", viewProj);
+        skyboxShader->SetMat4("r_inverseVP"_sid, viewProj);
         auto samplers = skyboxShader->GetSamplers();
         for (auto& s : samplers) {
         if (s->GetName().compare("r_skybox") == 0)
@@ -355,29 +541,36 @@ namespace rh {
         ENGINE_LOG_INFO("Showing Controller Debug: {0}", s_Data.controllerDebug);
     }
 
-    void Renderer::UploadLights(const Ref<Shader> shader) {
-        // uploads lights to shader in view-space
+    static void CopyLight(LightBlockEntry& entry, const Light& light) {
+        entry.Position[0] = light.position.x;
+        entry.Position[1] = light.position.y;
+        entry.Position[2] = light.position.z;
+        entry.Direction[0] = light.direction.x;
+        entry.Direction[1] = light.direction.y;
+        entry.Direction[2] = light.direction.z;
+        entry.Color[0] = light.color.x;
+        entry.Color[1] = light.color.y;
+        entry.Color[2] = light.color.z;
+        entry.Strength = light.strength;
+        entry.Inner = light.inner;
+        entry.Outer = light.outer;
+    }
 
-        // set directional light
-        shader->SetVec3("r_sun.Direction", s_Data.Lights.sun.direction);
-        shader->SetVec3("r_sun.Color", s_Data.Lights.sun.color);
-        shader->SetFloat("r_sun.Strength", s_Data.Lights.sun.strength);
+    void Renderer::UploadLights() {
+        // copies the view-space lights into the lights block, unused slots stay zeroed
+        LightsBlock* block = GetFrameBlock<LightsBlock>(s_Data.LightsBlockOffset);
+        memset(block, 0, sizeof(LightsBlock));
 
-        // set point lights
-        for (int n = 0; n < s_Data.Lights.NumPointLights; n++) {
-            shader->SetVec3("r_pointLights[" + std::to_string(n) + "].Position", s_Data.Lights.pointLights[n].position);
-            shader->SetVec3("r_pointLights[" + std::to_string(n) + "].Color", s_Data.Lights.pointLights[n].color);
-            shader->SetFloat("r_pointLights[" + std::to_string(n) + "].Strength", s_Data.Lights.pointLights[n].strength);
+        CopyLight(block->sun, s_Data.Lights.sun);
+
+        block->NumPointLights = (s32)std::min(s_Data.Lights.NumPointLights, (u32)MAX_SHADER_LIGHTS);
+        for (int n = 0; n < block->NumPointLights; n++) {
+            CopyLight(block->pointLights[n], s_Data.Lights.pointLights[n]);
         }
 
-        // set spot lights
-        for (int n = 0; n < s_Data.Lights.NumSpotLights; n++) {
-            shader->SetVec3("r_spotLights[" + std::to_string(n) + "].Position", s_Data.Lights.spotLights[n].position);
-            shader->SetVec3("r_spotLights[" + std::to_string(n) + "].Direction", s_Data.Lights.spotLights[n].direction);
-            shader->SetVec3("r_spotLights[" + std::to_string(n) + "].Color", s_Data.Lights.spotLights[n].color);
-            shader->SetFloat("r_spotLights[" + std::to_string(n) + "].Strength", s_Data.Lights.spotLights[n].strength);
-            shader->SetFloat("r_spotLights[" + std::to_string(n) + "].Inner", s_Data.Lights.spotLights[n].inner);
-            shader->SetFloat("r_spotLights[" + std::to_string(n) + "].Outer", s_Data.Lights.spotLights[n].outer);
+        block->NumSpotLights = (s32)std::min(s_Data.Lights.NumSpotLights, (u32)MAX_SHADER_LIGHTS);
+        for (int n = 0; n < block->NumSpotLights; n++) {
+            CopyLight(block->spotLights[n], s_Data.Lights.spotLights[n]);
         }
     }
 
@@ -387,90 +580,47 @@ namespace rh {
         const Light& sun) {
         BENCHMARK_FUNCTION();
 
+        s_Data.UniformLookupsAtFrameStart = Shader::GetUniformLookupCount();
+
         laml::Mat4 ViewMatrix;
         laml::transform::create_view_matrix_from_transform(ViewMatrix, transform);
         laml::Mat4 ProjectionMatrix = camera.GetProjection();
+        s_Data.ViewMatrix = ViewMatrix;
+        s_Data.ViewFrustum = Frustum::FromMatrix(laml::mul(ProjectionMatrix, ViewMatrix));
+        s_Data.DeferredCandidates.clear();
+        s_Data.DeferredBounds.Clear();
+        s_Data.DeferredQueue.Clear();
         laml::Vec3 camPos(transform.c_14, transform.c_24, transform.c_34);
         UpdateLighting(ViewMatrix, numPointLights, pointLights, numSpotLights, spotLights, sun, ProjectionMatrix);
 
-        // PrePass Shader
-        auto prePassShader = s_Data.ShaderLibrary->Get("PrePass");
-        prePassShader->Bind();
-        prePassShader->SetMat4("r_Projection", ProjectionMatrix);
-        prePassShader->SetMat4("r_View", ViewMatrix);
-        prePassShader->SetFloat("r_AlbedoTexToggle",    1.0f);
-        prePassShader->SetFloat("r_NormalTexToggle",    0.0f);
-        prePassShader->SetFloat("r_MetalnessTexToggle", 1.0f);
-        prePassShader->SetFloat("r_RoughnessTexToggle", 1.0f);
-        prePassShader->SetFloat("r_AmbientTexToggle",   1.0f);
-        prePassShader->SetFloat("r_EmissiveTexToggle",  1.0f);
-        prePassShader->SetFloat("r_gammaCorrect", s_Data.Gamma ? 1.0 : 0.0);
-
-        // PrePass_Anim Shader
-        auto prePassAnimShader = s_Data.ShaderLibrary->Get("PrePass_Anim");
-        prePassAnimShader->Bind();
-        prePassAnimShader->SetMat4("r_Projection", ProjectionMatrix);
-        prePassAnimShader->SetMat4("r_View", ViewMatrix);
-        prePassAnimShader->SetFloat("r_AlbedoTexToggle", 1.0f);
-        prePassAnimShader->SetFloat("r_NormalTexToggle", 0.0f);
-        prePassAnimShader->SetFloat("r_MetalnessTexToggle", 1.0f);
-        prePassAnimShader->SetFloat("r_RoughnessTexToggle", 1.0f);
-        prePassAnimShader->SetFloat("r_AmbientTexToggle", 1.0f);
-        prePassAnimShader->SetFloat("r_EmissiveTexToggle", 1.0f);
-        prePassAnimShader->SetFloat("r_gammaCorrect", s_Data.Gamma ? 1.0 : 0.0);
-
-        // Lighting Pass
-        auto lightingShader = s_Data.ShaderLibrary->Get("Lighting");
-        lightingShader->Bind();
-        lightingShader->SetInt("u_normal", 0);
-        lightingShader->SetInt("u_distance", 1);
-        lightingShader->SetInt("u_amr", 2);
-        UploadLights(lightingShader);
-        lightingShader->SetMat4("r_Projection", s_Data.Lights.projection);
-        lightingShader->SetMat4("r_View", s_Data.Lights.view);
-
-        // SSAO Pass
-        auto ssaoShader = s_Data.ShaderLibrary->Get("SSAO");
-        ssaoShader->Bind();
-        ssaoShader->SetInt("u_amr", 0);
-
-        // Screen Output Pass
-        auto screenShader = s_Data.ShaderLibrary->Get("Screen");
-        screenShader->Bind();
-        screenShader->SetInt("u_albedo", 0);
-        screenShader->SetInt("u_normal", 1);
-        screenShader->SetInt("u_amr", 2);
-        screenShader->SetInt("u_depth", 3);
-        screenShader->SetInt("u_diffuse", 4);
-        screenShader->SetInt("u_specular", 5);
-        screenShader->SetInt("u_emissive", 6);
-        screenShader->SetInt("u_ssao", 7);
-        screenShader->SetInt("r_outputSwitch", s_Data.OutputMode);
-        screenShader->SetFloat("r_toneMap", s_Data.ToneMap ? 1.0 : 0.0);
-        screenShader->SetFloat("r_gammaCorrect", s_Data.Gamma ? 1.0 : 0.0);
-
-        // Line/Simple mesh Pass
-        auto lineShader = s_Data.ShaderLibrary->Get("Line");
-        lineShader->Bind();
-        lineShader->SetMat4("r_VP", laml::mul(ProjectionMatrix, ViewMatrix));
-        lineShader->SetVec3("r_CamPos", camPos);
-        lineShader->SetFloat("r_LineFadeStart", 5);
-        lineShader->SetFloat("r_LineFadeEnd", 20);
-        lineShader->SetFloat("r_LineFadeMaximum", 0.5f);
-        lineShader->SetFloat("r_LineFadeMinimum", 0.25f);
-
-        // 3D Line shader
-        auto line3DShader = s_Data.ShaderLibrary->Get("Line3D");
-        line3DShader->Bind();
-        line3DShader->SetMat4("r_Projection", ProjectionMatrix);
-        line3DShader->SetMat4("r_View", ViewMatrix);
-
-        // Sobel pass
-        auto sobelShader = s_Data.ShaderLibrary->Get("Sobel");
-        sobelShader->SetInt("r_texture", 0);
-        auto mixShader = s_Data.ShaderLibrary->Get("Mix");
-        mixShader->SetInt("r_tex1", 0);
-        mixShader->SetInt("r_tex2", 1);
+        // every per-frame uniform lives in the frame buffer, shared by all shaders that declare the blocks
+        CameraBlock* cameraBlock = GetFrameBlock<CameraBlock>(s_Data.CameraBlockOffset);
+        cameraBlock->Projection = ProjectionMatrix;
+        cameraBlock->View = ViewMatrix;
+        cameraBlock->ViewProjection = laml::mul(ProjectionMatrix, ViewMatrix);
+        cameraBlock->CamPos[0] = camPos.x;
+        cameraBlock->CamPos[1] = camPos.y;
+        cameraBlock->CamPos[2] = camPos.z;
+        cameraBlock->CamPos[3] = 1.0f;
+
+        UploadLights();
+
+        SettingsBlock* settings = GetFrameBlock<SettingsBlock>(s_Data.SettingsBlockOffset);
+        settings->AlbedoTexToggle    = 1.0f;
+        settings->NormalTexToggle    = 0.0f;
+        settings->MetalnessTexToggle = 1.0f;
+        settings->RoughnessTexToggle = 1.0f;
+        settings->AmbientTexToggle   = 1.0f;
+        settings->EmissiveTexToggle  = 1.0f;
+        settings->GammaCorrect = s_Data.Gamma ? 1.0f : 0.0f;
+        settings->ToneMap = s_Data.ToneMap ? 1.0f : 0.0f;
+        settings->OutputSwitch = (s32)s_Data.OutputMode;
+        settings->LineFadeStart = 5.0f;
+        settings->LineFadeEnd = 20.0f;
+        settings->LineFadeMaximum = 0.5f;
+        settings->LineFadeMinimum = 0.25f;
+
+        s_Data.FrameUniforms->SetData(s_Data.FrameStaging.data(), (u32)s_Data.FrameStaging.size());
     }
 
     void Renderer::BeginDeferredPrepass() {
@@ -480,6 +630,12 @@ namespace rh {
         s_Data.gBuffer->ClearBuffers();
         auto prePassShader = s_Data.ShaderLibrary->Get("PrePass");
         prePassShader->Bind();
+
+        // Draw everything submitted so far that the camera can see, sorted by state
+        CullCandidates();
+        s_Data.DeferredQueue.Sort();
+        ReplayQueue(s_Data.DeferredQueue, s_Data.DeferredQueueStats);
+        s_Data.DeferredQueue.Clear();
     }
 
     void Renderer::EndDeferredPrepass() {
@@ -545,6 +701,23 @@ namespace rh {
 
         TextRenderer::SubmitText(outputModes[s_Data.OutputMode], 10, 10, laml::Vec3(.1f, .9f, .75f));
 
+        // draw calls issued vs. one per visible submesh without instancing
+        {
+            const auto& queueStats = s_Data.DeferredQueueStats;
+            char text[96];
+            sprintf_s(text, 96, "Draws: %u/%u, culled: %u, lines: %u, glyphs: %u in %u draws", queueStats.drawCalls, queueStats.packets, 
+                s_Data.DeferredCullingStats.culled, s_Data.DebugLinesLastFlush,
+                TextRenderer::GetGlyphsLastFlush(), TextRenderer::GetDrawCallsLastFlush());
+            TextRenderer::SubmitText(text, 10, 100, laml::Vec3(.1f, .9f, .75f));
+        }
+
+        // uniform names should only be resolved when shaders are linked, flag any per-frame lookups
+        if (s_Data.UniformLookupsLastFrame) {
+            char text[64];
+            sprintf_s(text, 64, "Uniform lookups last frame: %llu", (unsigned long long)s_Data.UniformLookupsLastFrame);
+            TextRenderer::SubmitText(text, 10, 120, laml::Vec3(.9f, .3f, .2f));
+        }
+
         // Render sound debug
         if (s_Data.soundDebug) {
             auto status = SoundEngine::GetStatus();
@@ -625,6 +798,8 @@ namespace rh {
         s_Data.mixBuffer2->BindTexture(0, 1);
         SubmitFullscreenQuad();
 
+        s_Data.UniformLookupsLastFrame = Shader::GetUniformLookupCount() - s_Data.UniformLookupsAtFrameStart;
+
         Flush();
     }
 
@@ -637,6 +812,10 @@ namespace rh {
         RenderCommand::SetViewport(0, 0, width, height);
     }
 
+    u64 Renderer::GetUniformLookupsLastFrame() {
+        return s_Data.UniformLookupsLastFrame;
+    }
+
     const std::unique_ptr<ShaderLibrary>& Renderer::GetShaderLibrary() {
         return s_Data.ShaderLibrary;
     }
@@ -644,7 +823,7 @@ namespace rh {
     void Renderer::Submit(const laml::Mat4& transform) {
         auto shader = s_Data.ShaderLibrary->Get("simple");
         shader->Bind();
-        shader->SetMat4("r_Transform", transform);
+        shader->SetMat4("r_Transform"_sid, transform);
 
         //s_Data.VertexArray->Bind();
         //RenderCommand::DrawIndexed(s_Data.VertexArray);
@@ -655,8 +834,8 @@ namespace rh {
 
         auto shader = s_Data.ShaderLibrary->Get("Line");
         shader->Bind();
-        shader->SetMat4("r_Transform", transform);
-        shader->SetVec3("r_LineColor", color);
+        shader->SetMat4("r_Transform"_sid, transform);
+        shader->SetVec3("r_LineColor"_sid, color);
 
         vao->Bind();
         //RenderCommand::SetWireframe(true);
@@ -667,34 +846,200 @@ namespace rh {
     void Renderer::SubmitMesh(const Mesh* mesh, const laml::Mat4& transform) {
         BENCHMARK_FUNCTION();
 
-        mesh->GetVertexArray()->Bind();
-        auto shader = mesh->GetMeshShader();
-        shader->Bind();
+        f32 boundsScale = mesh->HasAnimations() ? SKINNED_BOUNDS_SCALE : 1.0f;
 
         auto& materials = mesh->GetMaterials();
         for (const Submesh& submesh : mesh->GetSubmeshes()) {
-            auto material = materials[submesh.MaterialIndex];
-            material->Bind();
+            DrawCandidate candidate;
+            candidate.shader = mesh->m_MeshShader.get();
+            candidate.vao = mesh->m_VertexArray.get();
+            candidate.packet.mesh = mesh;
+            candidate.packet.submesh = &submesh;
+            candidate.packet.material = materials[submesh.MaterialIndex].get();
+            candidate.packet.transform = laml::mul(transform, submesh.Transform);
+
+            s_Data.DeferredBounds.Add(submesh.Bounds.sphereCenter, submesh.Bounds.sphereRadius * boundsScale, candidate.packet.transform);
+            s_Data.DeferredCandidates.push_back(candidate);
+        }
+    }
+
+    void Renderer::CullCandidates() {
+        BENCHMARK_FUNCTION();
+
+        CullingSet& bounds = s_Data.DeferredBounds;
+        int numVisible = CullSpheres(s_Data.ViewFrustum, bounds);
+
+        CullingStats& stats = s_Data.DeferredCullingStats;
+        stats.candidates = (u32)bounds.count;
+        stats.visible = (u32)numVisible;
+        stats.culled = stats.candidates - stats.visible;
+
+        const laml::Mat4& view = s_Data.ViewMatrix;
+        for (int n = 0; n < bounds.count; n++) {
+            if (!bounds.visible[n])
+                continue;
+
+            // view-space distance to the bounding sphere
+            f32 depth = -(view.c_31*bounds.x[n] + view.c_32*bounds.y[n] + view.c_33*bounds.z[n] + view.c_34);
+
+            const DrawCandidate& candidate = s_Data.DeferredCandidates[n];
+            s_Data.DeferredQueue.Submit(RenderQueue::Pass_DeferredPrepass, candidate.shader, candidate.packet.material, candidate.vao, depth, candidate.packet);
+        }
+
+        s_Data.DeferredCandidates.clear();
+        bounds.Clear();
+    }
 
-            shader->SetMat4("r_Transform", laml::mul(transform, submesh.Transform));
+    void Renderer::ReplayQueue(const RenderQueue& queue, RenderQueueStats& stats) {
+        BENCHMARK_FUNCTION();
+
+        memset(&stats, 0, sizeof(stats));
+        stats.packets = (u32)queue.GetCount();
 
-            // set bone transforms
-            const auto& skeleton = mesh->GetSkeleton();
-            for (int n = 0; n < skeleton.bones.size(); n++) {
-                const auto& bone = skeleton.bones[n];
+        // Write every transform into this frame's region of the object ring in one upload,
+        // the draws below only move the range bound to the ObjectData block
+        const size_t count = queue.GetCount();
+        if (count > s_Data.ObjectCapacity)
+            CreateObjectRing(std::max((u32)count, s_Data.ObjectCapacity * 2));
 
-                laml::Mat4 fix(1.0f);
+        const u32 stride = s_Data.ObjectStride;
+        const u32 regionBase = s_Data.ObjectRingFrame * s_Data.ObjectCapacity * stride;
+        s_Data.ObjectStaging.resize(count * stride);
+        for (size_t i = 0; i < count; i++) {
+            memcpy(s_Data.ObjectStaging.data() + i * stride, &queue.GetPacket(i).transform, sizeof(ObjectBlock));
+        }
+        if (count)
+            s_Data.ObjectUniforms->SetData(s_Data.ObjectStaging.data(), (u32)(count * stride), regionBase);
+        s_Data.ObjectRingFrame = (s_Data.ObjectRingFrame + 1) % OBJECT_RING_FRAMES;
+
+        // Same for skinning palettes: each skinned mesh gets one slot, shared by all of its
+        // submeshes, and Mesh only rebuilds the palette when its pose changed
+        auto& skinned = s_Data.SkinnedMeshes;
+        skinned.clear();
+        for (size_t i = 0; i < count; i++) {
+            const Mesh* mesh = queue.GetPacket(i).mesh;
+            if (mesh->HasAnimations() && std::find(skinned.begin(), skinned.end(), mesh) == skinned.end())
+                skinned.push_back(mesh);
+        }
+        if (skinned.size() > s_Data.BoneCapacity)
+            CreateBoneRing(std::max((u32)skinned.size(), s_Data.BoneCapacity * 2));
+
+        const u32 boneStride = s_Data.BoneStride;
+        const u32 boneBase = s_Data.BoneRingFrame * s_Data.BoneCapacity * boneStride;
+        s_Data.BoneStaging.resize(skinned.size() * boneStride);
+        for (size_t m = 0; m < skinned.size(); m++) {
+            const auto& palette = skinned[m]->GetSkinningPalette();
+            size_t numBones = std::min(palette.size(), (size_t)MAX_SHADER_BONES);
+            memcpy(s_Data.BoneStaging.data() + m * boneStride, palette.data(), numBones * sizeof(laml::Mat4));
+        }
+        if (skinned.size())
+            s_Data.BoneUniforms->SetData(s_Data.BoneStaging.data(), (u32)(skinned.size() * boneStride), boneBase);
+        s_Data.BoneRingFrame = (s_Data.BoneRingFrame + 1) % OBJECT_RING_FRAMES;
+
+        const Mesh* lastMesh = nullptr;
+        const Shader* lastShader = nullptr;
+        const VertexArray* lastVAO = nullptr;
+        const MaterialInstance* lastMaterial = nullptr;
+
+        // Binds shader + material only when they differ from the last draw
+        auto bindState = [&](Shader* shader, MaterialInstance* material) {
+            if (shader != lastShader) {
+                lastShader = shader;
+                shader->Bind();
+                stats.shaderChanges++;
+
+                // new program, material uniforms have to go up again
+                lastMaterial = nullptr;
+            }
+
+            if (material != lastMaterial) {
+                lastMaterial = material;
+                material->Bind(shader);
+                stats.materialChanges++;
+            }
+        };
 
-                //shader->SetMat4("r_Bones[" + std::to_string(n) + "]", bone1.transform * bone0.invTransform);
-                shader->SetMat4("r_Bones[" + std::to_string(n) + "]", laml::mul(bone.finalTransform, bone.inverse_model_matrix));
-                //shader->SetMat4("r_Bones[" + std::to_string(n) + "]", laml::Mat4());
+        size_t begin = 0;
+        while (begin < count) {
+            // packets are sorted by shader, material and vertex array, so all draws
+            // of one mesh with one material form a contiguous run
+            const DrawPacket& first = queue.GetPacket(begin);
+            const Mesh* mesh = first.mesh;
+            size_t end = begin + 1;
+            while (end < count && queue.GetPacket(end).mesh == mesh && queue.GetPacket(end).material == first.material)
+                end++;
+
+            if (mesh->m_VertexArray.get() != lastVAO) {
+                lastVAO = mesh->m_VertexArray.get();
+                lastVAO->Bind();
+                stats.vertexArrayChanges++;
             }
 
-            //RenderCommand::DrawIndexed(mesh->GetVertexArray());
-            RenderCommand::DrawSubIndexed(submesh.BaseIndex, 0, submesh.IndexCount);
+            // each distinct submesh in the run becomes one instanced draw
+            auto& submeshes = s_Data.InstanceSubmeshes;
+            submeshes.clear();
+            if (mesh->m_InstanceBuffer) {
+                for (size_t i = begin; i < end; i++) {
+                    const Submesh* submesh = queue.GetPacket(i).submesh;
+                    if (std::find(submeshes.begin(), submeshes.end(), submesh) == submeshes.end())
+                        submeshes.push_back(submesh);
+                }
+            }
+
+            bool instanced = submeshes.size() && submeshes.size() < (end - begin);
+            if (instanced) {
+                Shader* shader = mesh->m_InstancedShader.get();
+                bindState(shader, first.material);
+
+                auto& transforms = s_Data.InstanceTransforms;
+                for (const Submesh* submesh : submeshes) {
+                    transforms.clear();
+                    for (size_t i = begin; i < end; i++) {
+                        const DrawPacket& packet = queue.GetPacket(i);
+                        if (packet.submesh == submesh)
+                            transforms.push_back(packet.transform);
+                    }
+
+                    mesh->m_InstanceBuffer->SetData(transforms.data(), (u32)(transforms.size() * sizeof(laml::Mat4)));
+                    RenderCommand::DrawSubIndexedInstanced(submesh->BaseIndex, 0, submesh->IndexCount, (u32)transforms.size());
+                    stats.drawCalls++;
+                    stats.instancedDrawCalls++;
+                    stats.instances += (u32)transforms.size();
+                }
+            } else {
+                Shader* shader = mesh->m_MeshShader.get();
+                for (size_t i = begin; i < end; i++) {
+                    const DrawPacket& packet = queue.GetPacket(i);
+                    bindState(shader, packet.material);
+
+                    s_Data.ObjectUniforms->BindRange(OBJECT_BLOCK_BINDING, regionBase + (u32)i * stride, sizeof(ObjectBlock));
+
+                    // point the bone block at this mesh's palette, shared by every submesh of the mesh
+                    if (mesh != lastMesh) {
+                        lastMesh = mesh;
+                        if (mesh->HasAnimations()) {
+                            u32 slot = (u32)(std::find(skinned.begin(), skinned.end(), mesh) - skinned.begin());
+                            s_Data.BoneUniforms->BindRange(BONE_BLOCK_BINDING, boneBase + slot * boneStride, sizeof(BoneBlock));
+                        }
+                    }
+
+                    RenderCommand::DrawSubIndexed(packet.submesh->BaseIndex, 0, packet.submesh->IndexCount);
+                    stats.drawCalls++;
+                }
+            }
+
+            begin = end;
         }
     }
 
+    const RenderQueueStats& Renderer::GetDeferredQueueStats() {
+        return s_Data.DeferredQueueStats;
+    }
+
+    const CullingStats& Renderer::GetCullingStats() {
+        return s_Data.DeferredCullingStats;
+    }
+
     // Animation variant
     // ANIM_HOOK
     //void Renderer::SubmitMesh(const Mesh* mesh, const laml::Mat4& transform, md5::Animation* anim) {
@@ -721,7 +1066,7 @@ namespace rh {
     //        auto material = materials[submesh.MaterialIndex];
     //        material->Bind();
     //
-    //        shader->SetMat4("r_Transform", transform * submesh.Transform);
+    //        shader->SetMat4("r_Transform"_sid, transform * submesh.Transform);
     //
     //        //RenderCommand::DrawIndexed(mesh->GetVertexArray());
     //        RenderCommand::DrawSubIndexed(submesh.BaseIndex, 0, submesh.IndexCount);
@@ -734,22 +1079,92 @@ namespace rh {
         shader->Bind();
 
         for (Submesh& submesh : mesh->GetSubmeshes()) {
-            shader->SetMat4("r_Transform", laml::mul(transform, submesh.Transform));
+            shader->SetMat4("r_Transform"_sid, laml::mul(transform, submesh.Transform));
 
             RenderCommand::DrawSubIndexed_points(submesh.BaseIndex, 0, submesh.IndexCount);
         }
     }
 
-    void Renderer::SubmitLine(const laml::Vec3& v0, const laml::Vec3& v1, const laml::Vec4& color) {
+    void Renderer::SubmitLine(const laml::Vec3& v0, const laml::Vec3& v1, const laml::Vec4& color, bool depthTest) {
+        auto& lines = depthTest ? s_Data.DebugLinesDepthTested : s_Data.DebugLinesOverlay;
+        lines.push_back({ v0, color });
+        lines.push_back({ v1, color });
+    }
+
+    void Renderer::SubmitAABB(const laml::Vec3& boxMin, const laml::Vec3& boxMax, const laml::Vec4& color, bool depthTest) {
+        // corner n takes max along x/y/z where bit 0/1/2 of n is set
+        laml::Vec3 corners[8];
+        for (int n = 0; n < 8; n++) {
+            corners[n] = laml::Vec3((n & 1) ? boxMax.x : boxMin.x,
+                                    (n & 2) ? boxMax.y : boxMin.y,
+                                    (n & 4) ? boxMax.z : boxMin.z);
+        }
+
+        // an edge joins two corners that differ in exactly one bit
+        for (int n = 0; n < 8; n++) {
+            for (int bit = 1; bit < 8; bit <<= 1) {
+                if (!(n & bit))
+                    SubmitLine(corners[n], corners[n | bit], color, depthTest);
+            }
+        }
+    }
+
+    void Renderer::SubmitWireframe(const laml::Vec3* vertices, const u16* indices, u32 numTriangles, 
+                                   const laml::Mat4& transform, const laml::Vec4& color, bool depthTest) {
+        // edges shared by two triangles get drawn twice, cheaper than finding them for debug output
+        for (u32 t = 0; t < numTriangles; t++) {
+            laml::Vec3 p0 = laml::transform::transform_point(transform, vertices[indices[3*t + 0]], 1.0f);
+            laml::Vec3 p1 = laml::transform::transform_point(transform, vertices[indices[3*t + 1]], 1.0f);
+            laml::Vec3 p2 = laml::transform::transform_point(transform, vertices[indices[3*t + 2]], 1.0f);
+
+            SubmitLine(p0, p1, color, depthTest);
+            SubmitLine(p1, p2, color, depthTest);
+            SubmitLine(p2, p0, color, depthTest);
+        }
+    }
+
+    void Renderer::FlushDebugLines() {
+        BENCHMARK_FUNCTION();
+
+        u32 numDepthTested = (u32)s_Data.DebugLinesDepthTested.size();
+        u32 numOverlay = (u32)s_Data.DebugLinesOverlay.size();
+        s_Data.DebugLinesLastFlush = (numDepthTested + numOverlay) / 2;
+        if (numDepthTested + numOverlay == 0)
+            return;
+
+        // one upload for both lists, depth-tested vertices first
+        auto& vertices = s_Data.DebugLinesDepthTested;
+        vertices.insert(vertices.end(), s_Data.DebugLinesOverlay.begin(), s_Data.DebugLinesOverlay.end());
+        s_Data.DebugLineBuffer->SetData(vertices.data(), (u32)(vertices.size() * sizeof(DebugLineVertex)));
+
+        s_Data.screenBuffer->Bind();
+        RenderCommand::DisableDepthTest();
+
         auto shader = s_Data.ShaderLibrary->Get("Line3D");
         shader->Bind();
+        s_Data.DebugLines->Bind();
+
+        if (numDepthTested) {
+            // the screen buffer has no scene depth, the shader tests against the gBuffer distance instead
+            s_Data.gBuffer->BindTexture(3, 0);
+            shader->SetInt("r_depthTest"_sid, 1);
+            RenderCommand::DrawLineArray(0, numDepthTested);
+        }
+        if (numOverlay) {
+            shader->SetInt("r_depthTest"_sid, 0);
+            RenderCommand::DrawLineArray(numDepthTested, numOverlay);
+        }
+
+        s_Data.DebugLines->Unbind();
+        RenderCommand::EnableDepthTest();
+        s_Data.screenBuffer->Unbind();
 
-        shader->SetVec3("r_verts[0]", v0);
-        shader->SetVec3("r_verts[1]", v1);
-        shader->SetVec4("r_Color", color);
+        s_Data.DebugLinesDepthTested.clear();
+        s_Data.DebugLinesOverlay.clear();
+    }
 
-        s_Data.Line->Bind();
-        RenderCommand::DrawLines(s_Data.Line, false);
+    u32 Renderer::GetDebugLinesLastFlush() {
+        return s_Data.DebugLinesLastFlush;
     }
 
     void Renderer::SubmitFullscreenQuad() {
@@ -759,6 +1174,7 @@ namespace rh {
 
     void Renderer::RecompileShaders() {
         s_Data.ShaderLibrary->ReloadAll();
+        SetSamplerSlots();
     }
 
     void Renderer::Draw3DText(const std::string& text, const laml::Vec3& pos, const laml::Vec3& color) {
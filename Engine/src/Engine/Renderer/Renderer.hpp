@@ -5,6 +5,8 @@
 #include "Shader.hpp"
 #include "Mesh.hpp"
 #include "Light.hpp"
+#include "RenderQueue.hpp"
+#include "Frustum.hpp"
 
 //#include "TextRenderer.hpp"
 #include "Engine/GameObject/Components.hpp"
@@ -21,8 +23,9 @@ namespace rh {
         - Once lighting and camera data has been determined:
         Begin3DScene(camera, lights)
 
-            BeginDeferedPrepass();
-                - Render all 3d meshes to fill the G-Buffer
+            SubmitMesh(); - record all 3d meshes as draw candidates
+
+            BeginDeferedPrepass(); - frustum cull the candidates, sort the survivors and draw them to fill the G-Buffer
             EndDeferedPrepass(); - perform lighting pipeline on G-Buffer
 
             RenderSkybox();
@@ -39,14 +42,14 @@ namespace rh {
         RenderDebugUI();
         */
 
-        // Set all shader constants and save for later
+        // Fill the per-frame uniform blocks (camera, lights, settings) shared by every shader
         static void Begin3DScene(const Camera& camera, const laml::Mat4& transform, 
             u32 numPointLights, const Light pointLights[32],
             u32 numSpotLights,  const Light spotLights[32],
             const Light& sun);
         static void End3DScene();
 
-        // start writing to pre-pass buffers
+        // start writing to pre-pass buffers, draws all meshes submitted since Begin3DScene
         static void BeginDeferredPrepass();
         // End pre-pass, and perform lighting stages
         static void EndDeferredPrepass();
@@ -64,7 +67,6 @@ namespace rh {
             u32 numPointLights, const Light pointLights[32],
             u32 numSpotLights, const Light spotLights[32],
             const Light& sun, const laml::Mat4& projection);
-        static void UploadLights(const Ref<Shader> shader);
         static void Flush();
         static void Precompute();
 
@@ -77,6 +79,7 @@ namespace rh {
 
         static void Submit(const laml::Mat4& transform = laml::Mat4(1.0f));
         static void Submit(const Ref<VertexArray>& vao, const laml::Mat4& transform, const laml::Vec3& color);
+        // records the mesh as a draw candidate, culled and drawn in BeginDeferredPrepass
         static void SubmitMesh(const Mesh* mesh, const laml::Mat4& transform);
         // ANIM_HOOK static void SubmitMesh(const Mesh* mesh, const laml::Mat4& transform, md5::Animation* anim); // For animation
         static void SubmitMesh_drawNormals(const Ref<Mesh>& mesh, const laml::Mat4& transform);
@@ -89,7 +92,16 @@ namespace rh {
             const laml::Vec3& text_color,
             bool bind_pose = false);
 
-        static void SubmitLine(const laml::Vec3& v0, const laml::Vec3& v1, const laml::Vec4& color);
+        /// Debug lines are gathered on the CPU and drawn in one go by FlushDebugLines().
+        /// depthTest hides them behind the 3D scene, otherwise they are drawn on top of it.
+        static void SubmitLine(const laml::Vec3& v0, const laml::Vec3& v1, const laml::Vec4& color, bool depthTest = false);
+        static void SubmitAABB(const laml::Vec3& boxMin, const laml::Vec3& boxMax, const laml::Vec4& color, bool depthTest = false);
+        /// Edges of an indexed triangle list (3 indices per triangle), e.g. a collision hull
+        static void SubmitWireframe(const laml::Vec3* vertices, const u16* indices, u32 numTriangles, 
+                                    const laml::Mat4& transform, const laml::Vec4& color, bool depthTest = false);
+        /// Upload and draw the debug lines submitted this frame, then clear them
+        static void FlushDebugLines();
+        static u32 GetDebugLinesLastFlush();
 
         static void SubmitFullscreenQuad();
 
@@ -99,6 +111,21 @@ namespace rh {
         static inline RendererAPI::API GetAPI() { return RendererAPI::GetAPI(); }
 
         static const std::unique_ptr<ShaderLibrary>& GetShaderLibrary();
+
+        /// State changes made drawing the last deferred prepass
+        static const RenderQueueStats& GetDeferredQueueStats();
+
+        /// Visible/culled submeshes of the last deferred prepass
+        static const CullingStats& GetCullingStats();
+
+        /// Uniform name lookups sent to the graphics API during the last 3D frame, should be 0
+        static u64 GetUniformLookupsLastFrame();
+
+    private:
+        // copy the view-space lights into the lights block
+        static void UploadLights();
+        static void CullCandidates();
+        static void ReplayQueue(const RenderQueue& queue, RenderQueueStats& stats);
     };
 
 }
\ No newline at end of file
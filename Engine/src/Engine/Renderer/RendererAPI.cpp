@@ -1,6 +1,29 @@
 #include <enpch.hpp>
 #include "RendererAPI.hpp"
 
+#include "Engine/Platform/OpenGL/OpenGLRendererAPI.hpp"
+#include "Engine/Platform/Null/NullRendererAPI.hpp"
+
 namespace rh {
     RendererAPI::API RendererAPI::s_API = RendererAPI::API::OpenGL;
+
+    RendererAPI* RendererAPI::Create(API api) {
+        switch (api) {
+        case RendererAPI::API::None:
+            ENGINE_LOG_ASSERT(false, "No API selected when creating rendererAPI");
+            return nullptr;
+            break;
+        case RendererAPI::API::OpenGL:
+            s_API = api;
+            return new OpenGLRendererAPI();
+            break;
+        case RendererAPI::API::Null:
+            s_API = api;
+            return new NullRendererAPI();
+            break;
+        }
+
+        ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
+        return nullptr;
+    }
 }
\ No newline at end of file
@@ -7,10 +7,12 @@ namespace rh {
     class RendererAPI {
     public:
         enum class API {
-            None = 0, OpenGL = 1
+            None = 0, OpenGL = 1, Null = 2
         };
 
     public:
+        virtual ~RendererAPI() = default;
+
         virtual void SetClearColor(const laml::Vec4& color) = 0;
         virtual void Clear() = 0;
 
@@ -20,15 +22,24 @@ namespace rh {
         virtual void DrawLines(const Ref<VertexArray>& vertexArray, bool depth_test) = 0;
         virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, bool depth_test) = 0;
         virtual void DrawSubIndexed(u32 startIndex, u32 startVertex, u32 count) = 0;
+        virtual void DrawSubIndexedInstanced(u32 startIndex, u32 startVertex, u32 count, u32 instanceCount) = 0;
         virtual void DrawSubIndexed_points(u32 startIndex, u32 startVertex, u32 count) = 0;
+        // non-indexed line list from the bound vertex array, two vertices per line
+        virtual void DrawLineArray(u32 startVertex, u32 vertexCount) = 0;
         virtual void SetViewport(u32 x, u32 y, u32 width, u32 height) = 0;
 
         virtual void SetCullFace(int face) = 0;
         virtual void SetDepthTest(bool enabled) = 0;
         virtual void SetWireframe(bool enabled) = 0;
 
+        // texture units a fragment shader can sample from at once
+        virtual u32 GetMaxTextureSlots() = 0;
+
         static inline API GetAPI() { return s_API; }
 
+        /// Make the backend for api and select it for every resource created afterwards
+        static RendererAPI* Create(API api);
+
     private:
         static API s_API;
     };
@@ -0,0 +1,194 @@
+#include <enpch.hpp>
+#include "RendererBenchmark.hpp"
+
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Platform/Null/NullRendererAPI.hpp"
+#include "Engine/Resources/MaterialCatalog.hpp"
+#include "Engine/Resources/MeshCatalog.hpp"
+#include "Engine/Resources/ResourceManager.hpp"
+#include "Engine/Renderer/TextRenderer.hpp"
+#include "Engine/Renderer/SpriteRenderer.hpp"
+#include "Engine/Scene/Scene3D.hpp"
+#include "Engine/GameObject/GameObject.hpp"
+#include "Engine/GameObject/Components.hpp"
+#include "Engine/Resources/DynamicFont.hpp"
+
+#include <stb_truetype.h>
+
+namespace rh {
+
+    using bench_clock = std::chrono::steady_clock;
+
+    static double ElapsedMicroseconds(bench_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count();
+    }
+
+    void RunNullRendererBenchmark() {
+        const int gridSide = 32;
+        const int numFrames = 100;
+        const double dt = 1.0 / 60.0;
+
+        // same startup order as the Application, minus the window, sound and GUI
+        RenderCommand::SetAPI(RendererAPI::API::Null);
+        ResourceManager::CreateBuffers();
+        Renderer::Init();
+        TextRenderer::Init();
+        SpriteRenderer::Init();
+        MaterialCatalog::Create();
+        MeshCatalog::Create();
+        MeshCatalog::Register("bench_cube", "Data/Models/cube.nbt", FileFormat::NBT_Basic);
+        MeshCatalog::Register("bench_dancer", "Data/Models/dance.mesh", FileFormat::MESH_File);
+
+        Mesh* cubeMesh = MeshCatalog::Get("bench_cube");
+        Mesh* dancerMesh = MeshCatalog::Get("bench_dancer");
+        if (!cubeMesh || !dancerMesh) {
+            ENGINE_LOG_ERROR("Null renderer benchmark: could not load the meshes in Data/Models, run from the run_tree directory");
+        } else {
+            Scene3D scene;
+            CollisionWorld& cWorld = scene.GetCollisionWorld();
+
+            // a grid of cubes on the xz plane, each with a static hull, some of them off screen
+            for (int n = 0; n < gridSide * gridSide; n++) {
+                laml::Vec3 position((f32)(n % gridSide - gridSide / 2) * 3.0f, 0.0f, (f32)(n / gridSide - gridSide / 2) * 3.0f);
+
+                auto cube = scene.CreateGameObject("cube");
+                cube.AddComponent<MeshRendererComponent>(cubeMesh);
+                laml::transform::create_transform_translate(cube.GetComponent<TransformComponent>().Transform, position);
+                cube.AddComponent<ColliderComponent>(cWorld.CreateNewCubeHull(position, 2.0f));
+            }
+
+            // one skinned mesh, and a character falling onto the grid for the dynamic hull
+            {
+                auto dancer = scene.CreateGameObject("dancer");
+                dancer.AddComponent<MeshRendererComponent>(dancerMesh);
+                laml::transform::create_transform_translate(dancer.GetComponent<TransformComponent>().Transform, 0.0f, 1.0f, 0.0f);
+
+                CharacterMotion character;
+                character.hullOffset = laml::Vec3(0.0f, 0.5f, 0.0f);
+                character.position = laml::Vec3(3.0f, 6.0f, 3.0f);
+                character.floorUp = laml::Vec3(0.0f, 1.0f, 0.0f);
+                character.hullID = cWorld.CreateNewCapsule(character.position + character.hullOffset, 1.0f, 0.5f);
+                cWorld.AddCharacter(character);
+            }
+
+            {
+                auto light = scene.CreateGameObject("Sun");
+                light.AddComponent<LightComponent>(LightType::Directional, laml::Vec3(1.0f, 1.0f, 1.0f), 5, 0, 0);
+                laml::transform::create_transform_rotation(light.GetComponent<TransformComponent>().Transform, 45.0f, -80.0f, 0.0f);
+            }
+
+            {
+                auto cameraObject = scene.CreateGameObject("Camera");
+                auto& camera = cameraObject.AddComponent<CameraComponent>().camera;
+                camera.SetViewportSize(1280, 720);
+                camera.SetPerspective(75, .01, 100);
+
+                auto& trans = cameraObject.GetComponent<TransformComponent>().Transform;
+                laml::transform::create_transform_translate(trans, 0.0f, 20.0f, 25.0f);
+                laml::Mat4 rotM;
+                laml::transform::create_transform_rotation(rotM, 0.0f, -40.0f, 0.0f);
+                trans = laml::mul(trans, rotM);
+            }
+
+            // hull wireframes and AABBs go through the debug lines
+            scene.ToggleCollisionHulls();
+            scene.OnRuntimeStart();
+
+            double frameTime = 0.0;
+            for (int frame = 0; frame < numFrames; frame++) {
+                NullRendererAPI::ResetStats();
+
+                // the rest of an Application frame: a HUD from the game scene, then the flushes
+                auto start = bench_clock::now();
+                scene.OnUpdate(dt);
+
+                SpriteRect dst = { 1100, 20, 1260, 180 };
+                SpriteRenderer::SubmitSprite("Data/Images/frog.png", &dst, nullptr, ALIGN_TOP_LEFT, SPRITE_LAYER_OVERLAY);
+                TextRenderer::SubmitText("font_big", "Null renderer benchmark", 640, 20, laml::Vec3(.5f, .25f, .7f), ALIGN_TOP_MID);
+                TextRenderer::SubmitText("Score: 123456   Time: 01:23", 10, 690, laml::Vec3(.6f, .8f, .75f));
+
+                Renderer::FlushDebugLines();
+                SpriteRenderer::Flush(SPRITE_LAYER_BACKGROUND);
+                TextRenderer::Flush();
+                SpriteRenderer::Flush(SPRITE_LAYER_OVERLAY);
+                frameTime += ElapsedMicroseconds(start);
+            }
+
+            scene.Destroy();
+
+            // counters hold the last frame only
+            const NullRendererStats& stats = NullRendererAPI::GetStats();
+            const RenderQueueStats& queue = Renderer::GetDeferredQueueStats();
+            ENGINE_LOG_INFO("Null renderer benchmark: {0} cubes + 1 skinned mesh, {1} frames, {2:.1f} us/frame on the CPU",
+                            gridSide * gridSide, numFrames, frameTime / numFrames);
+            ENGINE_LOG_INFO("  per frame: {0} draw calls ({1} instanced, {2} instances), {3} packets after culling",
+                            stats.drawCalls, stats.instancedDrawCalls, stats.instances, queue.packets);
+            ENGINE_LOG_INFO("  {0} debug lines, {1} glyphs in {2} text draws",
+                            Renderer::GetDebugLinesLastFlush(), TextRenderer::GetGlyphsLastFlush(), TextRenderer::GetDrawCallsLastFlush());
+            ENGINE_LOG_INFO("  binds: {0} shader, {1} vertex array, {2} framebuffer, {3} texture, {4} uniform range",
+                            stats.shaderBinds, stats.vertexArrayBinds, stats.framebufferBinds, stats.textureBinds, stats.bufferRangeBinds);
+            ENGINE_LOG_INFO("  {0} uniform sets, {1} state changes, {2} bytes uploaded",
+                            stats.uniformSets, stats.stateChanges, stats.bufferBytesUploaded + stats.textureBytesUploaded);
+            ENGINE_LOG_ASSERT(stats.drawCalls > 0 && queue.packets > 0, "Null renderer frame drew nothing");
+            ENGINE_LOG_ASSERT(Renderer::GetDebugLinesLastFlush() > 0 && TextRenderer::GetGlyphsLastFlush() > 0, "Null renderer frame drew no lines or text");
+        }
+
+        MeshCatalog::Destroy();
+        MaterialCatalog::Destroy();
+        SpriteRenderer::Shutdown();
+        TextRenderer::Shutdown();
+        Renderer::Shutdown();
+        ResourceManager::DestroyBuffers();
+    }
+
+    void RunTextLayoutBenchmark() {
+        const int iterations = 2000;
+        const char* fontFile = "Data/Fonts/UbuntuMono-Regular.ttf";
+
+        // the same glyph data DynamicFont::create bakes, minus the atlas upload
+        std::ifstream file(fontFile, std::ios::binary);
+        std::vector<unsigned char> ttf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        DynamicFont font;
+        font.m_fontSize = 20.0f;
+        font.m_bitmapRes = 512;
+        font.m_ftex = nullptr;
+        std::vector<unsigned char> bitmap(font.m_bitmapRes * font.m_bitmapRes);
+        if (ttf.empty() || stbtt_BakeFontBitmap(ttf.data(), 0, font.m_fontSize, bitmap.data(), font.m_bitmapRes, font.m_bitmapRes,
+                                                32, 96, reinterpret_cast<stbtt_bakedchar*>(font.cdata)) == -1) {
+            ENGINE_LOG_ERROR("Text layout benchmark: could not bake {0}, run from the run_tree directory", fontFile);
+            return;
+        }
+        font.initialized = true;
+
+        // what a frame of debug UI and menus looks like
+        const char* strings[] = {
+            "Combined Output",
+            "Draws: 412/1024, culled: 612, lines: 3077",
+            "Uniform lookups last frame: 0",
+            "TOI solves: 12, skipped: 340, substeps: 2",
+            "Sound Engine Status:",
+            "  channel 3: Data/Sounds/ahhh.ogg [playing]",
+            "Gamepad Status: disconnected",
+            "New Game",
+            "Options",
+            "Quit",
+            "A longer block of text that wraps\nover a few lines, like a dialog box\nor a tooltip would.",
+        };
+        const TextAlignment aligns[] = { ALIGN_TOP_LEFT, ALIGN_MID_MID, ALIGN_BOT_RIGHT };
+
+        std::vector<GlyphVertex> vertices;
+        vertices.reserve(4096 * 4);
+        u64 glyphs = 0;
+        auto start = bench_clock::now();
+        for (int n = 0; n < iterations; n++) {
+            vertices.clear();
+            for (int s = 0; s < (int)(sizeof(strings) / sizeof(strings[0])); s++) {
+                glyphs += TextRenderer::LayoutText(font, strings[s], 10.0f, 20.0f * s, laml::Vec3(1.0f, 1.0f, 1.0f), aligns[s % 3], vertices);
+            }
+        }
+        double layoutTime = ElapsedMicroseconds(start);
+
+        ENGINE_LOG_INFO("Text layout benchmark: {0} glyphs per pass, {1:.4f} us/glyph, {2:.2f} us/pass",
+                        glyphs / iterations, layoutTime / (double)glyphs, layoutTime / iterations);
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef RENDERER_BENCHMARK_H
+#define RENDERER_BENCHMARK_H
+
+namespace rh {
+
+    /// Runs full Scene3D::OnUpdate frames plus the debug line, sprite and text flushes
+    /// on the null backend, and logs the work each frame hands to the graphics API.
+    /// The only headless path through the renderer: no window, GL context or sound,
+    /// but it loads shaders, meshes and fonts from Data/
+    void RunNullRendererBenchmark();
+
+    /// TextRenderer::LayoutText alone on the CPU, over a fixed set of strings.
+    /// Bakes the glyph data itself, so no font texture or graphics API is needed
+    void RunTextLayoutBenchmark();
+}
+
+#endif
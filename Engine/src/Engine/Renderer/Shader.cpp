@@ -2,10 +2,14 @@
 #include "Shader.hpp"
 #include "Renderer.hpp"
 
+#include "Engine/Renderer/GLSLShader.hpp"
 #include "Engine/Platform/OpenGL/OpenGLShader.hpp"
+#include "Engine/Platform/Null/NullShader.hpp"
 
 namespace rh {
 
+    u64 Shader::s_UniformLookupCount = 0;
+
     Ref<Shader> Shader::Create(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc) {
         switch (Renderer::GetAPI()) {
             case RendererAPI::API::None:
@@ -15,6 +19,9 @@ namespace rh {
             case RendererAPI::API::OpenGL:
                 return std::make_shared<OpenGLShader>(name, vertexSrc, fragmentSrc);
                 break;
+            case RendererAPI::API::Null:
+                return std::make_shared<NullShader>(name, vertexSrc, fragmentSrc);
+                break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -30,6 +37,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return std::make_shared<OpenGLShader>(path);
             break;
+        case RendererAPI::API::Null:
+            return std::make_shared<NullShader>(path);
+            break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -94,8 +104,9 @@ namespace rh {
             ENGINE_LOG_ASSERT(false, "No API selected when creating vertexArray");
             return;
         case RendererAPI::API::OpenGL:
+        case RendererAPI::API::Null: // both backends reflect through GLSLShader
             for (auto field : m_Fields) {
-                auto fieldCast = static_cast<OpenGLShaderUniformDeclaration*>(field);
+                auto fieldCast = static_cast<GLSLShaderUniformDeclaration*>(field);
                 delete fieldCast;
                 fieldCast = nullptr;
             }
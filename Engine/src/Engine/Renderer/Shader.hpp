@@ -7,7 +7,8 @@ namespace rh {
     enum class ShaderDomain {
         None = 0,
         Vertex = 1,
-        Fragment = 2
+        Fragment = 2,
+        Geometry = 3
     };
 
     class ShaderUniformDeclaration {
@@ -94,8 +95,24 @@ namespace rh {
         virtual void SetVec3(const std::string &name, const laml::Vec3& value) const = 0;
         virtual void SetVec4(const std::string &name, const laml::Vec4& value) const = 0;
 
+        /// Same setters keyed by a hashed name, e.g. SetMat4("r_View"_sid, view).
+        /// These never touch a string at runtime.
+        virtual void SetMat4(stringID name, const laml::Mat4& value) const = 0;
+        virtual void SetFloat(stringID name, f32 value) const = 0;
+        virtual void SetInt(stringID name, s32 value) const = 0;
+        virtual void SetVec2(stringID name, const laml::Vec2& value) const = 0;
+        virtual void SetVec3(stringID name, const laml::Vec3& value) const = 0;
+        virtual void SetVec4(stringID name, const laml::Vec4& value) const = 0;
+
+        /// Number of uniform name lookups sent to the graphics API so far.
+        /// These should only happen when a shader is linked or reloaded.
+        static u64 GetUniformLookupCount() { return s_UniformLookupCount; }
+
         static Ref<Shader> Create(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
         static Ref<Shader> Create(const std::string& path);
+
+    protected:
+        static u64 s_UniformLookupCount;
     };
 
     class ShaderLibrary {
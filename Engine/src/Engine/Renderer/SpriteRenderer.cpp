@@ -3,16 +3,43 @@
 #include "SpriteRenderer.hpp"
 
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Core/Utils.hpp"
 #include "Engine/Resources/MaterialCatalog.hpp"
 
 namespace rh {
 
+    // quads per draw call, the batch flushes early when it fills up
+    #define MAX_SPRITE_QUADS 8192
+    // has to match the r_spriteTex array in Sprite.glsl
+    #define MAX_SPRITE_TEXTURE_SLOTS 16
+    // texture index the shader treats as plain white
+    #define SPRITE_UNTEXTURED -1.0f
+
+    struct SpriteVertex {
+        laml::Vec2 Position;
+        laml::Vec2 TexCoord;
+        laml::Vec4 Color;
+        f32 TexIndex;
+    };
+
+    /// Quads waiting to be drawn for one layer, 4 vertices per quad
+    struct SpriteBatch {
+        std::vector<SpriteVertex> vertices;
+        std::vector<const Texture2D*> textureSlots;
+    };
+
     struct SpriteRendererData {
         std::unique_ptr<ShaderLibrary> ShaderLibrary;
 
-        Ref<VertexArray> Quad;
-        Ref<VertexArray> Line;
+        Ref<VertexArray> Quads;
+        Ref<VertexBuffer> QuadBuffer;
         laml::Mat4 orthoMat;
+
+        SpriteBatch batches[SPRITE_LAYER_COUNT];
+        u32 maxTextureSlots;
+
+        SpriteBatchStats stats;
+        SpriteBatchStats lastStats;
     };
 
     static SpriteRendererData s_SpriteData;
@@ -21,75 +48,54 @@ namespace rh {
         BENCHMARK_FUNCTION();
 
         s_SpriteData.ShaderLibrary = std::make_unique<ShaderLibrary>();
-        auto textShader = GetShaderLibrary()->Load("Data/Shaders/Sprite.glsl");
-        auto line2DShader = GetShaderLibrary()->Load("Data/Shaders/Line2D.glsl");
+        auto spriteShader = GetShaderLibrary()->Load("Data/Shaders/Sprite.glsl");
 
         // create font-rendering globals
         laml::transform::create_projection_orthographic(s_SpriteData.orthoMat, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f, -1.0f);
 
-        // initialize texture shader values
-        textShader->Bind();
-        textShader->SetMat4("r_orthoProjection", s_SpriteData.orthoMat);
-        textShader->SetFloat("r_spriteTex", 0);
-        // initialize line shader values
-        line2DShader->Bind();
-        line2DShader->SetMat4("r_orthoProjection", s_SpriteData.orthoMat);
-
-        // create Text quad
-        {
-            struct _vertex
-            {
-                laml::Vec2 Position;
-            };
-
-            _vertex* data = new _vertex[4];
-
-            data[0].Position = laml::Vec2(0, 1);
-            data[1].Position = laml::Vec2(0, 0);
-            data[2].Position = laml::Vec2(1, 0);
-            data[3].Position = laml::Vec2(1, 1);
-
-            u32 indices[6] = { 0, 2, 1, 0, 3, 2 };
+        s_SpriteData.maxTextureSlots = std::min(RenderCommand::GetMaxTextureSlots(), (u32)MAX_SPRITE_TEXTURE_SLOTS);
 
-            auto vbo = VertexBuffer::Create(data, 4 * sizeof(_vertex));
-            vbo->SetLayout({
-                { ShaderDataType::Float2, "a_Position" }
-                });
-            auto ebo = IndexBuffer::Create(indices, 6);
-
-            s_SpriteData.Quad = VertexArray::Create();
-            s_SpriteData.Quad->Bind();
-            s_SpriteData.Quad->AddVertexBuffer(vbo);
-            s_SpriteData.Quad->SetIndexBuffer(ebo);
-            s_SpriteData.Quad->Unbind();
+        // initialize texture shader values
+        spriteShader->Bind();
+        spriteShader->SetMat4("r_orthoProjection"_sid, s_SpriteData.orthoMat);
+        for (u32 n = 0; n < MAX_SPRITE_TEXTURE_SLOTS; n++) {
+            std::string name = "r_spriteTex[" + std::to_string(n) + "]";
+            spriteShader->SetInt(name, (s32)n);
         }
 
-        // create Line
+        // create the streaming quad buffer
         {
-            struct _vertex
-            {
-                float Position; // can we remove this entirely?
-            };
-
-            _vertex* data = new _vertex[2];
-
-            data[0].Position = 0;
-            data[1].Position = 1;
-
-            u32 indices[2] = { 0, 1 };
-
-            auto vbo = VertexBuffer::Create(data, 2 * sizeof(_vertex));
-            vbo->SetLayout({
-                { ShaderDataType::Float, "a_Position" }
+            u32* indices = new u32[MAX_SPRITE_QUADS * 6];
+            for (u32 n = 0; n < MAX_SPRITE_QUADS; n++) {
+                u32 v = n * 4;
+                indices[n*6 + 0] = v + 0;
+                indices[n*6 + 1] = v + 2;
+                indices[n*6 + 2] = v + 1;
+                indices[n*6 + 3] = v + 0;
+                indices[n*6 + 4] = v + 3;
+                indices[n*6 + 5] = v + 2;
+            }
+
+            s_SpriteData.QuadBuffer = VertexBuffer::Create(MAX_SPRITE_QUADS * 4 * sizeof(SpriteVertex));
+            s_SpriteData.QuadBuffer->SetLayout({
+                { ShaderDataType::Float2, "a_Position" },
+                { ShaderDataType::Float2, "a_TexCoord" },
+                { ShaderDataType::Float4, "a_Color" },
+                { ShaderDataType::Float,  "a_TexIndex" }
                 });
-            auto ebo = IndexBuffer::Create(indices, 2);
-
-            s_SpriteData.Line = VertexArray::Create();
-            s_SpriteData.Line->Bind();
-            s_SpriteData.Line->AddVertexBuffer(vbo);
-            s_SpriteData.Line->SetIndexBuffer(ebo);
-            s_SpriteData.Line->Unbind();
+            auto ebo = IndexBuffer::Create(indices, MAX_SPRITE_QUADS * 6);
+            delete[] indices;
+
+            s_SpriteData.Quads = VertexArray::Create();
+            s_SpriteData.Quads->Bind();
+            s_SpriteData.Quads->AddVertexBuffer(s_SpriteData.QuadBuffer);
+            s_SpriteData.Quads->SetIndexBuffer(ebo);
+            s_SpriteData.Quads->Unbind();
         }
+
+        s_SpriteData.batches[SPRITE_LAYER_BACKGROUND].vertices.reserve(MAX_SPRITE_QUADS * 4);
+        memset(&s_SpriteData.stats, 0, sizeof(SpriteBatchStats));
+        memset(&s_SpriteData.lastStats, 0, sizeof(SpriteBatchStats));
     }
 
     void SpriteRenderer::Shutdown() {
@@ -148,16 +154,66 @@ namespace rh {
         return std::make_pair(xOff, yOff);
     }
 
-    void SpriteRenderer::SubmitSprite(const std::string& spriteFilename, u32 screenX, u32 screenY, TextAlignment anchor) {
+    void SpriteRenderer::SubmitSprite(const std::string& spriteFilename, u32 screenX, u32 screenY, TextAlignment anchor, SpriteLayer layer) {
         //SpriteRect src{ 1,1,0,0 };
         SpriteRect dst{ screenX, screenY, -1,-1 };
-        SubmitSprite(spriteFilename, &dst, nullptr, anchor);
+        SubmitSprite(spriteFilename, &dst, nullptr, anchor, layer);
     }
 
-    void SpriteRenderer::SubmitSprite(const std::string& spriteFilename, SpriteRect* dst, SpriteRect* src, TextAlignment anchor) {
+    /// Draw the batch and start a new one
+    static void DrawBatch(SpriteBatch& batch) {
+        u32 numQuads = (u32)(batch.vertices.size() / 4);
+        if (numQuads == 0)
+            return;
+
         auto shader = s_SpriteData.ShaderLibrary->Get("Sprite");
         shader->Bind();
+        shader->SetMat4("r_orthoProjection"_sid, s_SpriteData.orthoMat);
+
+        for (u32 n = 0; n < batch.textureSlots.size(); n++) {
+            batch.textureSlots[n]->Bind(n);
+        }
+
+        s_SpriteData.Quads->Bind();
+        s_SpriteData.QuadBuffer->SetData(batch.vertices.data(), numQuads * 4 * sizeof(SpriteVertex));
+
+        RenderCommand::DisableDepthTest();
+        RenderCommand::DrawSubIndexed(0, 0, numQuads * 6);
+        RenderCommand::EnableDepthTest();
+
+        s_SpriteData.stats.batches++;
+        s_SpriteData.stats.quads += numQuads;
+
+        batch.vertices.clear();
+        batch.textureSlots.clear();
+    }
+
+    /// Slot of tex in the batch, flushing first if every slot is taken
+    static f32 GetTextureSlot(SpriteBatch& batch, const Texture2D* tex) {
+        auto& slots = batch.textureSlots;
+        for (u32 n = 0; n < slots.size(); n++) {
+            if (slots[n] == tex)
+                return (f32)n;
+        }
+
+        if (slots.size() >= s_SpriteData.maxTextureSlots) {
+            DrawBatch(batch);
+            s_SpriteData.stats.flushes++;
+        }
+
+        slots.push_back(tex);
+        return (f32)(slots.size() - 1);
+    }
+
+    /// Make room for one more quad
+    static void ReserveQuad(SpriteBatch& batch) {
+        if (batch.vertices.size() >= MAX_SPRITE_QUADS * 4) {
+            DrawBatch(batch);
+            s_SpriteData.stats.flushes++;
+        }
+    }
 
+    void SpriteRenderer::SubmitSprite(const std::string& spriteFilename, SpriteRect* dst, SpriteRect* src, TextAlignment anchor, SpriteLayer layer) {
         auto tex = MaterialCatalog::GetTexture(spriteFilename);
         auto texWidth = (f32)tex->GetWidth();
         auto texHeight = (f32)tex->GetHeight();
@@ -185,32 +241,63 @@ namespace rh {
             _src.w = src->y0;
         }
 
-        shader->SetVec4("r_transform", _dst);
-        shader->SetVec4("r_transformUV", _src);
-        shader->SetMat4("r_orthoProjection", s_SpriteData.orthoMat);
-        shader->SetVec3("r_textColor", laml::Vec3(1, 1, 1));
-
-        tex->Bind(0);
-        s_SpriteData.Quad->Bind();
+        SpriteBatch& batch = s_SpriteData.batches[layer];
+        ReserveQuad(batch);
+        f32 slot = GetTextureSlot(batch, tex);
+        laml::Vec4 white(1.0f, 1.0f, 1.0f, 1.0f);
+
+        // corners of the old unit quad (0,1) (0,0) (1,0) (1,1), uv v is flipped
+        f32 x0 = _dst.z, x1 = _dst.z + _dst.x;
+        f32 y0 = _dst.w, y1 = _dst.w + _dst.y;
+        f32 u0 = _src.z, u1 = _src.z + _src.x;
+        f32 v0 = _src.w, v1 = _src.w + _src.y;
+
+        auto& verts = batch.vertices;
+        verts.push_back({ laml::Vec2(x0, y1), laml::Vec2(u0, v0), white, slot });
+        verts.push_back({ laml::Vec2(x0, y0), laml::Vec2(u0, v1), white, slot });
+        verts.push_back({ laml::Vec2(x1, y0), laml::Vec2(u1, v1), white, slot });
+        verts.push_back({ laml::Vec2(x1, y1), laml::Vec2(u1, v0), white, slot });
+    }
 
-        //RenderCommand::DisableDepthTest();
-        RenderCommand::DrawIndexed(s_SpriteData.Quad, false);
-        //RenderCommand::EnableDepthTest();
+    void SpriteRenderer::SubmitLine(u32 screenX0, u32 screenY0, u32 screenX1, u32 screenY1, laml::Vec4 color, SpriteLayer layer) {
+        // lines go in the same batch as a one pixel wide untextured quad
+        f32 dx = (f32)screenX1 - (f32)screenX0;
+        f32 dy = (f32)screenY1 - (f32)screenY0;
+        f32 len = sqrtf(dx*dx + dy*dy);
+        if (len <= 0.0f)
+            return;
+
+        f32 nx = -dy / len * 0.5f;
+        f32 ny =  dx / len * 0.5f;
+        laml::Vec2 p0((f32)screenX0, (f32)screenY0);
+        laml::Vec2 p1((f32)screenX1, (f32)screenY1);
+
+        SpriteBatch& batch = s_SpriteData.batches[layer];
+        ReserveQuad(batch);
+
+        // same winding as the sprite quads whichever way the line points
+        auto& verts = batch.vertices;
+        verts.push_back({ laml::Vec2(p0.x + nx, p0.y + ny), laml::Vec2(0.0f, 0.0f), color, SPRITE_UNTEXTURED });
+        verts.push_back({ laml::Vec2(p0.x - nx, p0.y - ny), laml::Vec2(0.0f, 0.0f), color, SPRITE_UNTEXTURED });
+        verts.push_back({ laml::Vec2(p1.x - nx, p1.y - ny), laml::Vec2(0.0f, 0.0f), color, SPRITE_UNTEXTURED });
+        verts.push_back({ laml::Vec2(p1.x + nx, p1.y + ny), laml::Vec2(0.0f, 0.0f), color, SPRITE_UNTEXTURED });
+        s_SpriteData.stats.lines++;
     }
 
-    void SpriteRenderer::SubmitLine(u32 screenX0, u32 screenY0, u32 screenX1, u32 screenY1, laml::Vec4 color) {
-        auto shader = s_SpriteData.ShaderLibrary->Get("Line2D");
-        shader->Bind();
+    void SpriteRenderer::Flush(SpriteLayer layer) {
+        BENCHMARK_FUNCTION();
 
-        // defaults
-        laml::Vec2 verts[2] { { (f32)screenX0, (f32)screenY0}, {(f32)screenX1, (f32)screenY1 } };
+        DrawBatch(s_SpriteData.batches[layer]);
 
-        shader->SetVec2("r_verts[0]", verts[0]);
-        shader->SetVec2("r_verts[1]", verts[1]);
-        shader->SetMat4("r_orthoProjection", s_SpriteData.orthoMat);
-        shader->SetVec4("r_Color", color);
+        // the last layer ends the frame
+        if (layer != SPRITE_LAYER_COUNT - 1)
+            return;
+
+        s_SpriteData.lastStats = s_SpriteData.stats;
+        memset(&s_SpriteData.stats, 0, sizeof(SpriteBatchStats));
+    }
 
-        s_SpriteData.Line->Bind();
-        RenderCommand::DrawLines(s_SpriteData.Line, false);
+    const SpriteBatchStats& SpriteRenderer::GetStats() {
+        return s_SpriteData.lastStats;
     }
 }
\ No newline at end of file
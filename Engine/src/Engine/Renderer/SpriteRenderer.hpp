@@ -9,16 +9,37 @@ namespace rh {
         float x0, y0, x1=-1, y1=-1;
     };
 
+    /// Sprites are batched per layer. Background sprites get drawn before the text,
+    /// overlays (cursors and the like) after it
+    enum SpriteLayer : u8 {
+        SPRITE_LAYER_BACKGROUND = 0,
+        SPRITE_LAYER_OVERLAY,
+        SPRITE_LAYER_COUNT
+    };
+
+    /// Work done by the sprite batch during the last frame
+    struct SpriteBatchStats {
+        u32 batches; // draw calls issued
+        u32 quads;   // sprites + lines
+        u32 lines;
+        u32 flushes; // batches drawn early because texture slots or vertex space ran out
+    };
+
     class SpriteRenderer
     {
     public:
         static void Init();
         static void Shutdown();
 
-        static void SubmitSprite(const std::string& spriteFilename, u32 screenX, u32 screenY, TextAlignment anchor = TextAlignment::ALIGN_TOP_LEFT);
-        static void SubmitSprite(const std::string& spriteFilename, SpriteRect* dst = nullptr, SpriteRect* src = nullptr, TextAlignment anchor = TextAlignment::ALIGN_TOP_LEFT);
+        /// Draw everything submitted to a layer since its last flush, in submission order
+        static void Flush(SpriteLayer layer);
+        static const SpriteBatchStats& GetStats();
+
+        // Sprites and lines are only queued here, they get drawn by Flush()
+        static void SubmitSprite(const std::string& spriteFilename, u32 screenX, u32 screenY, TextAlignment anchor = TextAlignment::ALIGN_TOP_LEFT, SpriteLayer layer = SPRITE_LAYER_BACKGROUND);
+        static void SubmitSprite(const std::string& spriteFilename, SpriteRect* dst = nullptr, SpriteRect* src = nullptr, TextAlignment anchor = TextAlignment::ALIGN_TOP_LEFT, SpriteLayer layer = SPRITE_LAYER_BACKGROUND);
 
-        static void SubmitLine(u32 screenX0, u32 screenY0, u32 screenX1, u32 screenY1, laml::Vec4 color);
+        static void SubmitLine(u32 screenX0, u32 screenY0, u32 screenX1, u32 screenY1, laml::Vec4 color, SpriteLayer layer = SPRITE_LAYER_BACKGROUND);
 
         static void OnWindowResize(uint32_t width, uint32_t height);
 
@@ -2,19 +2,34 @@
 #include "TextRenderer.hpp"
 
 #include "Engine/Renderer/Texture.hpp"
+#include "Engine/Core/Utils.hpp"
 #include "Engine/Resources/DynamicFont.hpp"
 
 #include <stb_truetype.h>
 
 namespace rh {
 
+    // glyphs per draw call, batches larger than this get split
+    #define MAX_GLYPHS_PER_DRAW 4096
+
+    /// Glyph quads waiting to be drawn with one font atlas
+    struct TextBatch {
+        const DynamicFont* font;
+        std::vector<GlyphVertex> vertices;
+    };
+
     struct TextRendererData {
         std::unique_ptr<ShaderLibrary> ShaderLibrary;
 
-        Ref<VertexArray> TextQuad;
+        Ref<VertexArray> TextQuads;
+        Ref<VertexBuffer> GlyphBuffer;
         laml::Mat4 orthoMat;
 
         std::unordered_map<std::string, DynamicFont*> fonts;
+        std::vector<TextBatch> batches;
+
+        u32 GlyphsLastFlush;
+        u32 DrawCallsLastFlush;
     };
 
     static TextRendererData s_Data;
@@ -30,37 +45,39 @@ namespace rh {
 
         // initialize texture shader values
         textShader->Bind();
-        textShader->SetMat4("r_orthoProjection", s_Data.orthoMat);
-        textShader->SetFloat("r_fontTex", 0);
+        textShader->SetMat4("r_orthoProjection"_sid, s_Data.orthoMat);
+        textShader->SetInt("r_fontTex"_sid, 0);
 
-        // create Text quad
+        // create the glyph buffers, vertices get rewritten every flush
         {
-            struct _vertex
-            {
-                laml::Vec2 Position;
-            };
-
-            _vertex* data = new _vertex[4];
-
-            data[0].Position = laml::Vec2(0, 1);
-            data[1].Position = laml::Vec2(0, 0);
-            data[2].Position = laml::Vec2(1, 0);
-            data[3].Position = laml::Vec2(1, 1);
-
-            u32 indices[6] = { 0, 1, 2, 0, 2, 3 };
+            u32* indices = new u32[MAX_GLYPHS_PER_DRAW * 6];
+            for (u32 n = 0; n < MAX_GLYPHS_PER_DRAW; n++) {
+                u32 v = n * 4;
+                indices[n*6 + 0] = v + 0;
+                indices[n*6 + 1] = v + 1;
+                indices[n*6 + 2] = v + 2;
+                indices[n*6 + 3] = v + 0;
+                indices[n*6 + 4] = v + 2;
+                indices[n*6 + 5] = v + 3;
+            }
 
-            auto vbo = VertexBuffer::Create(data, 4 * sizeof(_vertex));
-            vbo->SetLayout({
-                { ShaderDataType::Float2, "a_Position" }
+            s_Data.GlyphBuffer = VertexBuffer::Create(MAX_GLYPHS_PER_DRAW * 4 * sizeof(GlyphVertex));
+            s_Data.GlyphBuffer->SetLayout({
+                { ShaderDataType::Float2, "a_Position" },
+                { ShaderDataType::Float2, "a_TexCoord" },
+                { ShaderDataType::Float3, "a_Color" }
                 });
-            auto ebo = IndexBuffer::Create(indices, 6);
-
-            s_Data.TextQuad = VertexArray::Create();
-            s_Data.TextQuad->Bind();
-            s_Data.TextQuad->AddVertexBuffer(vbo);
-            s_Data.TextQuad->SetIndexBuffer(ebo);
-            s_Data.TextQuad->Unbind();
+            auto ebo = IndexBuffer::Create(indices, MAX_GLYPHS_PER_DRAW * 6);
+            delete[] indices;
+
+            s_Data.TextQuads = VertexArray::Create();
+            s_Data.TextQuads->Bind();
+            s_Data.TextQuads->AddVertexBuffer(s_Data.GlyphBuffer);
+            s_Data.TextQuads->SetIndexBuffer(ebo);
+            s_Data.TextQuads->Unbind();
         }
+        s_Data.GlyphsLastFlush = 0;
+        s_Data.DrawCallsLastFlush = 0;
 
         // load fonts
         s_Data.fonts.emplace("font_big", new DynamicFont());
@@ -78,16 +95,12 @@ namespace rh {
     //void TextRenderer::BeginTextRendering() {
     //    auto textShader = s_Data.ShaderLibrary->Get("Text");
     //    textShader->Bind();
-    //    textShader->SetMat4("r_orthoProjection", s_Data.orthoMat);
+    //    textShader->SetMat4("r_orthoProjection"_sid, s_Data.orthoMat);
     //}
     //
     //void TextRenderer::EndTextRendering() {
     //    Flush();
     //}
-    //
-    //void TextRenderer::Flush() {
-    //    // currently doing nothing ^_^
-    //}
 
     void TextRenderer::OnWindowResize(uint32_t width, uint32_t height)
     {
@@ -104,64 +117,117 @@ namespace rh {
     }
 
     void TextRenderer::SubmitText(const std::string& fontName, const std::string& text, float startX, float startY, laml::Vec3 color, TextAlignment align) {
+        auto it = s_Data.fonts.find(fontName);
+        if (it == s_Data.fonts.end()) {
+            ENGINE_LOG_WARN("Could not draw text using font [{0}]", fontName);
+            return;
+        }
+        const DynamicFont* font = it->second;
+        if (!font->initialized)
+            return;
+
+        TextBatch* batch = nullptr;
+        for (auto& b : s_Data.batches) {
+            if (b.font == font) {
+                batch = &b;
+                break;
+            }
+        }
+        if (!batch) {
+            s_Data.batches.push_back({ font, {} });
+            batch = &s_Data.batches.back();
+        }
+
+        LayoutText(*font, text.c_str(), startX, startY, color, align, batch->vertices);
+    }
+
+    u32 TextRenderer::LayoutText(const DynamicFont& font, const char* text, float startX, float startY, const laml::Vec3& color, TextAlignment align, std::vector<GlyphVertex>& out) {
         BENCHMARK_FUNCTION();
 
+        float x = startX;
+        float y = startY;
+
+        float hOff, vOff;
+        font.getTextOffset(&hOff, &vOff, align, font.getLength(text), font.m_fontSize);
+
+        u32 numGlyphs = 0;
+        while (*text) {
+            if (*text == '\n') {
+                //Increase y by one line,
+                //reset x to start
+                x = startX;
+                y += font.m_fontSize;
+            }
+            if (*text >= 32 && *text < 128) {
+                stbtt_aligned_quad q;
+                stbtt_GetBakedQuad(reinterpret_cast<const stbtt_bakedchar*>(font.cdata), font.m_bitmapRes, font.m_bitmapRes, *text - 32, &x, &y, &q, 1);//1=opengl & d3d10+,0=d3d9
+
+                float x0 = q.x0 + hOff, x1 = q.x1 + hOff;
+                float y0 = q.y0 + vOff, y1 = q.y1 + vOff;
+
+                // same corner order the old unit quad used: (0,1) (0,0) (1,0) (1,1)
+                out.push_back({ laml::Vec2(x0, y1), laml::Vec2(q.s0, q.t1), color });
+                out.push_back({ laml::Vec2(x0, y0), laml::Vec2(q.s0, q.t0), color });
+                out.push_back({ laml::Vec2(x1, y0), laml::Vec2(q.s1, q.t0), color });
+                out.push_back({ laml::Vec2(x1, y1), laml::Vec2(q.s1, q.t1), color });
+                numGlyphs++;
+            }
+            ++text;
+        }
+
+        return numGlyphs;
+    }
+
+    void TextRenderer::Flush() {
+        BENCHMARK_FUNCTION();
+
+        s_Data.GlyphsLastFlush = 0;
+        s_Data.DrawCallsLastFlush = 0;
+
+        bool empty = true;
+        for (const auto& batch : s_Data.batches) {
+            if (batch.vertices.size()) {
+                empty = false;
+                break;
+            }
+        }
+        if (empty)
+            return;
+
         auto shader = s_Data.ShaderLibrary->Get("Text");
         shader->Bind();
-        s_Data.TextQuad->Bind();
-        if (s_Data.fonts.find(fontName) == s_Data.fonts.end()) {
-            ENGINE_LOG_WARN("Could not draw text using font [{0}]", fontName);
-            return;
-        }
-        auto font = s_Data.fonts.at(fontName);
-        font->m_ftex->Bind();
+        shader->SetMat4("r_orthoProjection"_sid, s_Data.orthoMat);
+        s_Data.TextQuads->Bind();
 
         RenderCommand::SetCullFront();
         RenderCommand::DisableDepthTest();
 
-        const char* _text = text.c_str();
-
-        if (font->initialized) {
-            float x = startX;
-            float y = startY;
-
-            float hOff, vOff;
-            font->getTextOffset(&hOff, &vOff, align, font->getLength(_text), font->m_fontSize);
-
-            shader->SetVec3("r_textColor", color);
-            shader->SetMat4("r_orthoProjection", s_Data.orthoMat); // TODO: don't need these always
-
-            while (*_text) {
-                if (*_text == '\n') {
-                    //Increase y by one line,
-                    //reset x to start
-                    x = startX;
-                    y += font->m_fontSize;
-                }
-                if (*_text >= 32 && *_text < 128) {
-                    stbtt_aligned_quad q;
-                    char c = *_text - 32;
-                    stbtt_GetBakedQuad(reinterpret_cast<stbtt_bakedchar*>(font->cdata), font->m_bitmapRes, font->m_bitmapRes, *_text - 32, &x, &y, &q, 1);//1=opengl & d3d10+,0=d3d9
-
-                    float scaleX = q.x1 - q.x0;
-                    float scaleY = q.y1 - q.y0;
-                    float transX = q.x0;
-                    float transY = q.y0;
-                    shader->SetVec4("r_transform", laml::Vec4(scaleX, scaleY, transX + hOff, transY + vOff));
-
-                    scaleX = q.s1 - q.s0;
-                    scaleY = q.t1 - q.t0;
-                    transX = q.s0;
-                    transY = q.t0;
-                    shader->SetVec4("r_transformUV", laml::Vec4(scaleX, scaleY, transX, transY));
-
-                    RenderCommand::DrawIndexed(s_Data.TextQuad, false);
-                }
-                ++_text;
+        for (auto& batch : s_Data.batches) {
+            u32 numGlyphs = (u32)(batch.vertices.size() / 4);
+            if (numGlyphs == 0)
+                continue;
+
+            batch.font->m_ftex->Bind();
+            for (u32 first = 0; first < numGlyphs; first += MAX_GLYPHS_PER_DRAW) {
+                u32 count = std::min(numGlyphs - first, (u32)MAX_GLYPHS_PER_DRAW);
+                s_Data.GlyphBuffer->SetData(&batch.vertices[first * 4], count * 4 * sizeof(GlyphVertex));
+                RenderCommand::DrawSubIndexed(0, 0, count * 6);
+                s_Data.DrawCallsLastFlush++;
             }
+
+            s_Data.GlyphsLastFlush += numGlyphs;
+            batch.vertices.clear();
         }
 
         RenderCommand::EnableDepthTest();
         RenderCommand::SetCullBack();
     }
+
+    u32 TextRenderer::GetGlyphsLastFlush() {
+        return s_Data.GlyphsLastFlush;
+    }
+
+    u32 TextRenderer::GetDrawCallsLastFlush() {
+        return s_Data.DrawCallsLastFlush;
+    }
 }
\ No newline at end of file
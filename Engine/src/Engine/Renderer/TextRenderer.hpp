@@ -5,6 +5,15 @@
 
 namespace rh {
 
+    class DynamicFont;
+
+    /// One corner of a glyph quad in screen pixels
+    struct GlyphVertex {
+        laml::Vec2 Position;
+        laml::Vec2 TexCoord;
+        laml::Vec3 Color;
+    };
+
     class TextRenderer
     {
     public:
@@ -13,11 +22,22 @@ namespace rh {
 
         //static void BeginTextRendering();
         //static void EndTextRendering();
-        //static void Flush();
 
+        /// Draw all text submitted since the last flush, one batch per font atlas
+        static void Flush();
+
+        /// Queue text for the next Flush(). Nothing is drawn here.
         static void SubmitText(const std::string& text, float startX, float startY, laml::Vec3 color, TextAlignment align = TextAlignment::ALIGN_TOP_LEFT);
         static void SubmitText(const std::string& fontName, const std::string& text, float startX, float startY, laml::Vec3 color, TextAlignment align = TextAlignment::ALIGN_TOP_LEFT);
 
+        /// Append 4 vertices per printable character to out, no graphics API calls.
+        /// Returns the number of glyphs written.
+        static u32 LayoutText(const DynamicFont& font, const char* text, float startX, float startY, const laml::Vec3& color, TextAlignment align, std::vector<GlyphVertex>& out);
+
+        /// Glyphs and draw calls of the last Flush()
+        static u32 GetGlyphsLastFlush();
+        static u32 GetDrawCallsLastFlush();
+
         static void OnWindowResize(uint32_t width, uint32_t height);
 
         static const std::unique_ptr<ShaderLibrary>& GetShaderLibrary();
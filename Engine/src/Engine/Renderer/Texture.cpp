@@ -3,6 +3,7 @@
 
 #include "Renderer.hpp"
 #include "Engine/Platform/OpenGL/OpenGLTexture.hpp"
+#include "Engine/Platform/Null/NullTexture.hpp"
 
 namespace rh {
 
@@ -15,6 +16,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return new(ptr) OpenGLTexture2D(path);
             break;
+        case RendererAPI::API::Null:
+            return new(ptr) NullTexture2D(path);
+            break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -30,6 +34,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return new(ptr) OpenGLTexture2D(bitmap, res);
             break;
+        case RendererAPI::API::Null:
+            return new(ptr) NullTexture2D(bitmap, res);
+            break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -45,6 +52,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return new(ptr) OpenGLTextureCube(path);
             break;
+        case RendererAPI::API::Null:
+            return new(ptr) NullTextureCube(path);
+            break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -61,6 +71,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return new OpenGLTexture2D(path);
             break;
+        case RendererAPI::API::Null:
+            return new NullTexture2D(path);
+            break;
         }
     
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -76,6 +89,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return new OpenGLTexture2D(bitmap, res);
             break;
+        case RendererAPI::API::Null:
+            return new NullTexture2D(bitmap, res);
+            break;
         }
     
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -91,6 +107,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return new OpenGLTextureCube(path);
             break;
+        case RendererAPI::API::Null:
+            return new NullTextureCube(path);
+            break;
         }
     
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
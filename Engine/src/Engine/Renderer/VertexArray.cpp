@@ -3,6 +3,7 @@
 
 #include "Renderer.hpp"
 #include "Engine/Platform/OpenGL/OpenGLVertexArray.hpp"
+#include "Engine/Platform/Null/NullVertexArray.hpp"
 
 namespace rh {
 
@@ -15,6 +16,9 @@ namespace rh {
         case RendererAPI::API::OpenGL:
             return std::make_shared<OpenGLVertexArray>();
             break;
+        case RendererAPI::API::Null:
+            return std::make_shared<NullVertexArray>();
+            break;
         }
 
         ENGINE_LOG_ASSERT(false, "Unknown rendererAPI selected");
@@ -52,7 +52,7 @@ namespace rh {
         }
     }
 
-    float DynamicFont::getLength(const char* text) {
+    float DynamicFont::getLength(const char* text) const {
         float length = 0;
         while (*text && *text != '\n') {
             if (*text >= 32 && *text < 128) {
@@ -63,7 +63,7 @@ namespace rh {
         return length;
     }
 
-    void DynamicFont::getTextOffset(float* hOffset, float *vOffset, TextAlignment align, float textLength, float textHeight) {
+    void DynamicFont::getTextOffset(float* hOffset, float *vOffset, TextAlignment align, float textLength, float textHeight) const {
         switch (align) {
         case ALIGN_TOP_LEFT: {
             *hOffset = 0;
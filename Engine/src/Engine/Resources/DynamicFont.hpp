@@ -17,8 +17,8 @@ namespace rh {
         void create(std::string filename, float fontSize, int res = 512);
         void printFontData();
 
-        float getLength(const char* text);
-        void getTextOffset(float* hOffset, float *vOffset, TextAlignment align, float textLength, float textHeight);
+        float getLength(const char* text) const;
+        void getTextOffset(float* hOffset, float *vOffset, TextAlignment align, float textLength, float textHeight) const;
 
     //private:
         bool initialized = false;
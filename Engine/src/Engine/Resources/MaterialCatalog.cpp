@@ -2,6 +2,7 @@
 
 #include "MaterialCatalog.hpp"
 #include "nbt\nbt.hpp"
+#include "nbt\view.hpp"
 
 namespace rh {
 
@@ -38,33 +39,33 @@ namespace rh {
             return newTexture;
         }
 
-        void RegisterMaterial(const std::string& mat_name, const nbt::tag_compound& data) {
+        void RegisterMaterial(const std::string& mat_name, const nbt::tag_view& data) {
             if (MaterialMap.find(mat_name) != MaterialMap.end()) return; // already loaded thia material, don't bother
 
             MaterialSpec spec;
-            spec.Name = data.at("name").as<nbt::tag_string>().get();
+            spec.Name = data.at("name").as_string();
             if (data.has_key("albedo_path")) {
-                auto albedo_path = data.at("albedo_path").as<nbt::tag_string>().get();
+                std::string albedo_path(data.at("albedo_path").as_string());
                 spec.Albedo = GetTexture(albedo_path);
             }
             if (data.has_key("normal_path")) {
-                auto normal_path = data.at("normal_path").as<nbt::tag_string>().get();
+                std::string normal_path(data.at("normal_path").as_string());
                 spec.Normal = GetTexture(normal_path);
             }
             if (data.has_key("ambient_path")) {
-                auto ambient_path = data.at("ambient_path").as<nbt::tag_string>().get();
+                std::string ambient_path(data.at("ambient_path").as_string());
                 spec.Ambient = GetTexture(ambient_path);
             }
             if (data.has_key("metalness_path")) {
-                auto metalness_path = data.at("metalness_path").as<nbt::tag_string>().get();
+                std::string metalness_path(data.at("metalness_path").as_string());
                 spec.Metalness = GetTexture(metalness_path);
             }
             if (data.has_key("roughness_path")) {
-                auto roughness_path = data.at("roughness_path").as<nbt::tag_string>().get();
+                std::string roughness_path(data.at("roughness_path").as_string());
                 spec.Roughness = GetTexture(roughness_path);
             }
             if (data.has_key("emissive_path")) {
-                auto emissive_path = data.at("emissive_path").as<nbt::tag_string>().get();
+                std::string emissive_path(data.at("emissive_path").as_string());
                 spec.Emissive = GetTexture(emissive_path);
             }
 
@@ -74,15 +75,13 @@ namespace rh {
         void Create() {
             BENCHMARK_FUNCTION();
 
-            nbt::file_data data;
-            nbt::nbt_byte major, minor;
-            endian::endian endianness;
-            bool result = nbt::read_from_file("Data/Materials/materials.nbt", data, major, minor, endianness);
+            nbt::view file;
+            bool result = file.open("Data/Materials/materials.nbt");
             ENGINE_LOG_ASSERT(result, "Failed to load material catalog");
 
-            for (const auto& material : data.second->as<nbt::tag_compound>()) {
-                const auto& material_name = material.first;
-                const auto& material_data = material.second.as<nbt::tag_compound>();
+            for (const auto& material : file.root()) {
+                std::string material_name(material.name);
+                const auto& material_data = material.value;
 
                 RegisterMaterial(material_name, material_data);
                 ENGINE_LOG_INFO("Material [{0}] loaded.", material_name);
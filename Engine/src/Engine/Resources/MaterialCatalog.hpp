@@ -3,6 +3,7 @@
 #include "Engine/Core/Base.hpp"
 #include "Engine/Renderer/Mesh.hpp"
 #include "Engine/Resources/nbt/nbt.hpp"
+#include "Engine/Resources/nbt/view.hpp"
 
 namespace rh {
 
@@ -30,7 +31,7 @@ namespace rh {
         Texture2D* GetTexture(const unsigned char* bitmap, u32 res);
         TextureCube* GetTextureCube(const std::string& texture_path);
 
-        void RegisterMaterial(const std::string& mat_name, const nbt::tag_compound& data);
+        void RegisterMaterial(const std::string& mat_name, const nbt::tag_view& data);
         // ANIM_HOOK void RegisterMaterial(const std::unordered_map<std::string, md5::Material>& materialMap);
     };
 }
\ No newline at end of file
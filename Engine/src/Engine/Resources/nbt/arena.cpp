@@ -0,0 +1,138 @@
+#include <enpch.hpp>
+#include "Engine/Resources/nbt/arena.hpp"
+
+namespace rh::nbt {
+
+    arena::arena(size_t block_size) : block_size_(block_size) {}
+
+    arena::~arena() {
+        reset();
+    }
+
+    arena::arena(arena&& rhs) noexcept : block_size_(rhs.block_size_) {
+        *this = std::move(rhs);
+    }
+
+    arena& arena::operator=(arena&& rhs) noexcept {
+        if (this != &rhs) {
+            reset();
+            block_size_ = rhs.block_size_;
+            std::swap(head_, rhs.head_);
+            std::swap(cursor_, rhs.cursor_);
+            std::swap(end_, rhs.end_);
+            std::swap(used_, rhs.used_);
+            std::swap(reserved_, rhs.reserved_);
+            std::swap(num_blocks_, rhs.num_blocks_);
+            std::swap(intern_table_, rhs.intern_table_);
+            std::swap(intern_capacity_, rhs.intern_capacity_);
+            std::swap(intern_count_, rhs.intern_count_);
+        }
+        return *this;
+    }
+
+    void arena::new_block(size_t min_size) {
+        // big requests get a block of their own size instead of wasting the rest of a normal one
+        size_t size = std::max(block_size_, min_size + sizeof(block) + alignof(std::max_align_t));
+
+        block* b = static_cast<block*>(::operator new(size));
+        b->next = head_;
+        b->size = size;
+        head_ = b;
+
+        cursor_ = reinterpret_cast<u8*>(b) + sizeof(block);
+        end_ = reinterpret_cast<u8*>(b) + size;
+        reserved_ += size;
+        num_blocks_++;
+    }
+
+    void* arena::allocate(size_t size, size_t align) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(cursor_) + (align - 1)) & ~(uintptr_t)(align - 1);
+        if (cursor_ == nullptr || p + size > reinterpret_cast<uintptr_t>(end_)) {
+            new_block(size + align);
+            p = (reinterpret_cast<uintptr_t>(cursor_) + (align - 1)) & ~(uintptr_t)(align - 1);
+        }
+
+        cursor_ = reinterpret_cast<u8*>(p + size);
+        used_ += size;
+        return reinterpret_cast<void*>(p);
+    }
+
+    std::string_view arena::copy(std::string_view str) {
+        if (str.empty())
+            return std::string_view();
+
+        char* dst = allocate_array<char>(str.size());
+        memcpy(dst, str.data(), str.size());
+        return std::string_view(dst, str.size());
+    }
+
+    namespace { //anonymous
+        size_t hash_string(std::string_view str) {
+            // FNV-1a
+            u64 h = 14695981039346656037ull;
+            for (char c : str) {
+                h ^= (u8)c;
+                h *= 1099511628211ull;
+            }
+            return (size_t)h;
+        }
+    }
+
+    void arena::grow_intern_table() {
+        // the old table is left behind in the arena, doubling keeps that waste bounded
+        size_t capacity = intern_capacity_ ? intern_capacity_ * 2 : 64;
+        std::string_view* table = allocate_array<std::string_view>(capacity);
+        for (size_t i = 0; i < capacity; i++)
+            new (&table[i]) std::string_view();
+
+        for (size_t i = 0; i < intern_capacity_; i++) {
+            const std::string_view& str = intern_table_[i];
+            if (str.data() == nullptr)
+                continue;
+
+            size_t slot = hash_string(str) & (capacity - 1);
+            while (table[slot].data() != nullptr)
+                slot = (slot + 1) & (capacity - 1);
+            table[slot] = str;
+        }
+
+        intern_table_ = table;
+        intern_capacity_ = capacity;
+    }
+
+    std::string_view arena::intern(std::string_view str) {
+        if (str.empty())
+            return std::string_view();
+
+        // keep the load factor under 1/2
+        if ((intern_count_ + 1) * 2 > intern_capacity_)
+            grow_intern_table();
+
+        size_t slot = hash_string(str) & (intern_capacity_ - 1);
+        while (intern_table_[slot].data() != nullptr) {
+            if (intern_table_[slot] == str)
+                return intern_table_[slot];
+            slot = (slot + 1) & (intern_capacity_ - 1);
+        }
+
+        std::string_view interned = copy(str);
+        intern_table_[slot] = interned;
+        intern_count_++;
+        return interned;
+    }
+
+    void arena::reset() {
+        block* b = head_;
+        while (b) {
+            block* next = b->next;
+            ::operator delete(b);
+            b = next;
+        }
+
+        head_ = nullptr;
+        cursor_ = end_ = nullptr;
+        used_ = reserved_ = num_blocks_ = 0;
+        intern_table_ = nullptr;
+        intern_capacity_ = intern_count_ = 0;
+    }
+}
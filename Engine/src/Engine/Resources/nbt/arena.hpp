@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+#include "Engine/Core/Base.hpp"
+
+namespace rh::nbt {
+
+    // monotonic allocator: hands out memory from large blocks and frees
+    // everything at once when reset or destroyed. nothing is freed individually,
+    // and no destructors are run, so only trivially destructible data belongs here.
+    class arena {
+    public:
+        explicit arena(size_t block_size = 64 * 1024);
+        ~arena();
+
+        arena(arena&& rhs) noexcept;
+        arena& operator=(arena&& rhs) noexcept;
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        void* allocate(size_t size, size_t align);
+
+        template<typename T>
+        T* allocate_array(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "arena never runs destructors");
+            return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        // copy of str inside the arena
+        std::string_view copy(std::string_view str);
+        // same as copy, but equal strings share one copy. used for compound keys
+        std::string_view intern(std::string_view str);
+
+        // free every block
+        void reset();
+
+        size_t bytes_used() const { return used_; }
+        size_t bytes_reserved() const { return reserved_; }
+        size_t num_blocks() const { return num_blocks_; }
+
+    private:
+        struct block {
+            block* next;
+            size_t size;
+        };
+
+        void new_block(size_t min_size);
+        void grow_intern_table();
+
+        size_t block_size_;
+        block* head_ = nullptr;
+        u8* cursor_ = nullptr;
+        u8* end_ = nullptr;
+
+        size_t used_ = 0;
+        size_t reserved_ = 0;
+        size_t num_blocks_ = 0;
+
+        // open-addressing set of interned strings, lives in the arena as well
+        std::string_view* intern_table_ = nullptr;
+        size_t intern_capacity_ = 0;
+        size_t intern_count_ = 0;
+    };
+}
@@ -0,0 +1,341 @@
+#include <enpch.hpp>
+#include "Engine/Resources/nbt/compress.hpp"
+
+namespace rh::nbt {
+
+    namespace { //anonymous
+        const size_t min_match = 4;
+        // the format wants the last 5 bytes as literals, and no match starting in the last 12
+        const size_t last_literals = 5;
+        const size_t match_find_limit = 12;
+
+        const int hash_log = 12;
+
+        // most raw bytes one stored byte can stand for: a long match costs a byte per 255
+        const size_t max_expansion = 255;
+
+        u32 read32(const u8* p) {
+            u32 x;
+            memcpy(&x, p, 4);
+            return x;
+        }
+
+        u32 hash(u32 x) {
+            return (x * 2654435761u) >> (32 - hash_log);
+        }
+
+        // lengths over 15 continue in bytes of 255 and a final remainder
+        u8* write_length(u8* op, size_t len) {
+            while (len >= 255) {
+                *op++ = 255;
+                len -= 255;
+            }
+            *op++ = (u8)len;
+            return op;
+        }
+
+        bool read_length(const u8*& ip, const u8* end, size_t& len) {
+            u8 b;
+            do {
+                if (ip == end)
+                    return false;
+                b = *ip++;
+                len += b;
+            } while (b == 255);
+            return true;
+        }
+
+        // token, literals, and room for the offset and match length
+        size_t max_sequence_size(size_t literals, size_t match) {
+            return 1 + literals + literals / 255 + 1 + 2 + match / 255 + 1;
+        }
+    }
+
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * lz codec  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    size_t lz::compress(const u8* src, size_t size, u8* dst, size_t capacity) {
+        const u8* ip = src;
+        const u8* anchor = src;
+        const u8* end = src + size;
+        u8* op = dst;
+        u8* op_end = dst + capacity;
+
+        if (size > match_find_limit) {
+            // last position seen for each hash, relative to src
+            u32 table[1 << hash_log] = {};
+            const u8* find_limit = end - match_find_limit;
+            const u8* match_limit = end - last_literals;
+
+            while (ip < find_limit) {
+                u32 h = hash(read32(ip));
+                const u8* ref = src + table[h];
+                table[h] = (u32)(ip - src);
+
+                if (ref >= ip || ip - ref > 0xFFFF || read32(ref) != read32(ip)) {
+                    // skip faster through data that doesn't compress
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                // grow the match both ways
+                while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                    ip--;
+                    ref--;
+                }
+                const u8* match_end = ip + min_match;
+                const u8* ref_end = ref + min_match;
+                while (match_end < match_limit && *match_end == *ref_end) {
+                    match_end++;
+                    ref_end++;
+                }
+
+                size_t literals = ip - anchor;
+                size_t match = (match_end - ip) - min_match;
+                if ((size_t)(op_end - op) < max_sequence_size(literals, match))
+                    return 0;
+
+                u8* token = op++;
+                *token = (u8)((literals < 15 ? literals : 15) << 4);
+                if (literals >= 15)
+                    op = write_length(op, literals - 15);
+                memcpy(op, anchor, literals);
+                op += literals;
+
+                u16 offset = (u16)(ip - ref);
+                *op++ = (u8)(offset & 0xFF);
+                *op++ = (u8)(offset >> 8);
+
+                *token |= (u8)(match < 15 ? match : 15);
+                if (match >= 15)
+                    op = write_length(op, match - 15);
+
+                // remember a position inside the match too, helps with runs
+                table[hash(read32(match_end - 2))] = (u32)(match_end - 2 - src);
+                ip = anchor = match_end;
+            }
+        }
+
+        // whatever is left goes out as literals
+        size_t literals = end - anchor;
+        if ((size_t)(op_end - op) < 1 + literals + literals / 255 + 1)
+            return 0;
+
+        u8* token = op++;
+        *token = (u8)((literals < 15 ? literals : 15) << 4);
+        if (literals >= 15)
+            op = write_length(op, literals - 15);
+        if (literals)
+            memcpy(op, anchor, literals);
+        op += literals;
+
+        return op - dst;
+    }
+
+    bool lz::decompress(const u8* src, size_t size, u8* dst, size_t raw_size) {
+        const u8* ip = src;
+        const u8* end = src + size;
+        u8* op = dst;
+        u8* op_end = dst + raw_size;
+
+        while (ip < end) {
+            u8 token = *ip++;
+
+            size_t literals = token >> 4;
+            if (literals == 15 && !read_length(ip, end, literals))
+                return false;
+            if ((size_t)(end - ip) < literals || (size_t)(op_end - op) < literals)
+                return false;
+            // short runs are copied as a fixed 16 bytes when both buffers have room,
+            // the extra bytes get overwritten by what comes next
+            if (literals <= 16 && end - ip >= 16 && op_end - op >= 16)
+                memcpy(op, ip, 16);
+            else if (literals)
+                memcpy(op, ip, literals);
+            op += literals;
+            ip += literals;
+
+            // the last sequence has no match
+            if (ip == end)
+                break;
+
+            if (end - ip < 2)
+                return false;
+            size_t offset = ip[0] | (ip[1] << 8);
+            ip += 2;
+            if (offset == 0 || offset > (size_t)(op - dst))
+                return false;
+
+            size_t match = token & 15;
+            if (match == 15 && !read_length(ip, end, match))
+                return false;
+            match += min_match;
+            if ((size_t)(op_end - op) < match)
+                return false;
+
+            const u8* ref = op - offset;
+            if (offset >= 16 && (size_t)(op_end - op) >= match + 16) {
+                // 16 byte chunks never overlap at this distance
+                for (size_t n = 0; n < match; n += 16)
+                    memcpy(op + n, ref + n, 16);
+                op += match;
+            } else if (offset >= match) {
+                memcpy(op, ref, match);
+                op += match;
+            } else {
+                // overlapping copy repeats the last offset bytes
+                for (size_t n = 0; n < match; n++)
+                    *op++ = *ref++;
+            }
+        }
+
+        return op == op_end;
+    }
+
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * blocks  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    void write_blocks(std::ostream& os, const u8* data, size_t size, compression c, endian::endian e) {
+        endian::write(os, (u32)size, e);
+
+        std::vector<u8> packed(c == compression::lz ? block_size : 0);
+        for (size_t pos = 0; pos < size; pos += block_size) {
+            u32 raw_size = (u32)std::min(block_size, size - pos);
+
+            // only keep the packed block if it is actually smaller
+            size_t packed_size = 0;
+            if (c == compression::lz)
+                packed_size = lz::compress(data + pos, raw_size, packed.data(), raw_size - 1);
+
+            u32 stored_size = packed_size ? (u32)packed_size : raw_size;
+            endian::write(os, raw_size, e);
+            endian::write(os, stored_size, e);
+            if (packed_size)
+                os.write(reinterpret_cast<const char*>(packed.data()), stored_size);
+            else
+                os.write(reinterpret_cast<const char*>(data + pos), stored_size);
+        }
+    }
+
+    bool read_blocks(std::istream& is, endian::endian e, std::vector<u8>& out) {
+        u32 size;
+        endian::read(is, size, e);
+        if (!is)
+            return false;
+
+        // the total comes from the file, so only grow as far as the blocks actually read
+        out.clear();
+        std::vector<u8> packed;
+        size_t pos = 0;
+        while (pos < size) {
+            u32 raw_size, stored_size;
+            endian::read(is, raw_size, e);
+            endian::read(is, stored_size, e);
+            if (!is || raw_size == 0 || raw_size > block_size || raw_size > size - pos || stored_size > raw_size)
+                return false;
+            out.resize(pos + raw_size);
+
+            if (stored_size == raw_size) {
+                is.read(reinterpret_cast<char*>(out.data() + pos), raw_size);
+                if (!is)
+                    return false;
+            } else {
+                packed.resize(stored_size);
+                is.read(reinterpret_cast<char*>(packed.data()), stored_size);
+                if (!is || !lz::decompress(packed.data(), stored_size, out.data() + pos, raw_size))
+                    return false;
+            }
+            pos += raw_size;
+        }
+        return true;
+    }
+
+    bool read_blocks(const u8* data, size_t size, endian::endian e, std::vector<u8>& out) {
+        const u8* p = data;
+        const u8* end = data + size;
+
+        if (end - p < 4)
+            return false;
+        u32 total = endian::load<u32>(p, e);
+        p += 4;
+
+        // a corrupt total shouldn't allocate more than the input could ever unpack to
+        if (total > (size_t)(end - p) * max_expansion)
+            return false;
+        out.resize(total);
+        size_t pos = 0;
+        while (pos < total) {
+            if (end - p < 8)
+                return false;
+            u32 raw_size = endian::load<u32>(p, e);
+            u32 stored_size = endian::load<u32>(p + 4, e);
+            p += 8;
+            if (raw_size == 0 || raw_size > block_size || raw_size > total - pos || stored_size > raw_size || (size_t)(end - p) < stored_size)
+                return false;
+
+            if (stored_size == raw_size)
+                memcpy(out.data() + pos, p, raw_size);
+            else if (!lz::decompress(p, stored_size, out.data() + pos, raw_size))
+                return false;
+
+            p += stored_size;
+            pos += raw_size;
+        }
+        return true;
+    }
+
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * block_istream * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    block_istream::block_istream(std::istream& is, endian::endian e) : std::istream(this), is_(is), endian_(e) {
+        u32 size;
+        endian::read(is_, size, endian_);
+        if (!is_) {
+            setstate(std::ios::failbit);
+            return;
+        }
+
+        remaining_ = size;
+        block_.reserve(std::min(block_size, remaining_));
+    }
+
+    block_istream::int_type block_istream::underflow() {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        if (remaining_ == 0)
+            return traits_type::eof();
+
+        u32 raw_size, stored_size;
+        endian::read(is_, raw_size, endian_);
+        endian::read(is_, stored_size, endian_);
+        if (!is_ || raw_size == 0 || raw_size > block_size || raw_size > remaining_ || stored_size > raw_size) {
+            remaining_ = 0;
+            return traits_type::eof();
+        }
+
+        block_.resize(raw_size);
+        if (stored_size == raw_size) {
+            is_.read(reinterpret_cast<char*>(block_.data()), raw_size);
+        } else {
+            packed_.resize(stored_size);
+            is_.read(reinterpret_cast<char*>(packed_.data()), stored_size);
+            if (is_ && !lz::decompress(packed_.data(), stored_size, block_.data(), raw_size))
+                is_.setstate(std::ios::failbit);
+        }
+        if (!is_) {
+            remaining_ = 0;
+            return traits_type::eof();
+        }
+
+        remaining_ -= raw_size;
+        char* p = reinterpret_cast<char*>(block_.data());
+        setg(p, p, p + raw_size);
+        return traits_type::to_int_type(*gptr());
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "Engine\Resources\nbt\data.hpp"
+#include "Engine\Resources\nbt\endian.hpp"
+
+namespace rh::nbt {
+
+    // how the body of a version 0.2 file is stored, kept in header byte 7
+    enum class compression : nbt_byte {
+        none = 0,
+        lz = 1
+    };
+
+    // uncompressed size of one block. matches are never further back than 64K,
+    // so every block is packed and unpacked on its own
+    constexpr size_t block_size = 64 * 1024;
+
+    // byte-oriented LZ77 codec in the LZ4 block format: no entropy stage,
+    // so unpacking is little more than memcpy
+    namespace lz {
+        // pack size bytes of src into dst. returns the packed size, or 0 if it
+        // doesn't fit in capacity bytes (so the block should be stored as is)
+        size_t compress(const u8* src, size_t size, u8* dst, size_t capacity);
+        // unpack src into exactly raw_size bytes of dst, false if the data is malformed
+        bool decompress(const u8* src, size_t size, u8* dst, size_t raw_size);
+    }
+
+    /* body of a version 0.2 file, right after the header:
+    [raw_size(4bytes)]
+    blocks until raw_size bytes are unpacked:
+        [block_raw_size(4bytes)][block_stored_size(4bytes)][data(block_stored_size)]
+    a block is stored uncompressed when both sizes are equal.
+    sizes use the endianness of the file
+    */
+    void write_blocks(std::ostream& os, const u8* data, size_t size, compression c, endian::endian e);
+    bool read_blocks(std::istream& is, endian::endian e, std::vector<u8>& out);
+    bool read_blocks(const u8* data, size_t size, endian::endian e, std::vector<u8>& out);
+
+    // istream over a block of memory, so the stream readers can parse an unpacked body in place
+    class memory_istream : private std::streambuf, public std::istream {
+    public:
+        memory_istream(const u8* data, size_t size) : std::istream(this) {
+            char* p = const_cast<char*>(reinterpret_cast<const char*>(data));
+            setg(p, p, p + size);
+        }
+    };
+
+    // istream over a version 0.2 body that unpacks one block at a time as it is read,
+    // so a streaming reader never holds more than a block of it in memory.
+    // a malformed block ends the stream early, which fails whatever read hit it
+    class block_istream : private std::streambuf, public std::istream {
+    public:
+        block_istream(std::istream& is, endian::endian e);
+
+    private:
+        // istream and streambuf both define these
+        typedef std::streambuf::int_type int_type;
+        typedef std::streambuf::traits_type traits_type;
+
+        int_type underflow() override;
+
+        std::istream& is_;
+        endian::endian endian_;
+        size_t remaining_ = 0; // raw bytes in the blocks not read yet
+        std::vector<u8> block_;
+        std::vector<u8> packed_;
+    };
+}
@@ -1,6 +1,15 @@
 #include <enpch.hpp>
 #include "Engine/Resources/nbt/endian.hpp"
 
+// Pick the widest array swap kernel the compiler is allowed to emit
+#if defined(__SSSE3__) || defined(__AVX__)
+    #define ENDIAN_SWAP_SSSE3 1
+    #include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define ENDIAN_SWAP_SSE2 1
+    #include <emmintrin.h>
+#endif
+
 static_assert(CHAR_BIT == 8, "Assuming that a byte has 8 bits");
 static_assert(sizeof(float) == 4, "Assuming that a float is 4 byte long");
 static_assert(sizeof(double) == 8, "Assuming that a double is 8 byte long");
@@ -555,4 +564,58 @@ namespace rh::endian
         write_big(os, put_float_to_int(x[3][3]));
     }
 
-}
+    //------------------------------------------------------------------------------
+
+    namespace //anonymous
+    {
+        // swap the bytes of every 16/32/64-bit lane of a 128-bit register
+#if defined(ENDIAN_SWAP_SSSE3)
+        inline __m128i swap_lanes16(__m128i x) {
+            return _mm_shuffle_epi8(x, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+        }
+        inline __m128i swap_lanes32(__m128i x) {
+            return _mm_shuffle_epi8(x, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+        }
+        inline __m128i swap_lanes64(__m128i x) {
+            return _mm_shuffle_epi8(x, _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8));
+        }
+#elif defined(ENDIAN_SWAP_SSE2)
+        // no byte shuffle without SSSE3: reverse the 16-bit words of a lane, then the bytes of each word
+        inline __m128i swap_lanes16(__m128i x) {
+            return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+        }
+        inline __m128i swap_lanes32(__m128i x) {
+            x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+            x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+            return swap_lanes16(x);
+        }
+        inline __m128i swap_lanes64(__m128i x) {
+            x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+            x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+            return swap_lanes16(x);
+        }
+#endif
+    }
+
+    // 16 bytes at a time with the SIMD kernel, the remainder with bswap
+#if defined(ENDIAN_SWAP_SSSE3) || defined(ENDIAN_SWAP_SSE2)
+    #define SWAP_ARRAY(data, count, lanes, kernel)                                  \
+        size_t i = 0;                                                             \
+        for (; i + (lanes) <= (count); i += (lanes)) {                            \
+            __m128i* p = reinterpret_cast<__m128i*>((data) + i);                  \
+            _mm_storeu_si128(p, kernel(_mm_loadu_si128(p)));                      \
+        }                                                                         \
+        for (; i < (count); ++i)                                                  \
+            (data)[i] = byte_swap((data)[i]);
+#else
+    #define SWAP_ARRAY(data, count, lanes, kernel)                                  \
+        for (size_t i = 0; i < (count); ++i)                                      \
+            (data)[i] = byte_swap((data)[i]);
+#endif
+
+    void byte_swap_array(uint16_t* data, size_t count) { SWAP_ARRAY(data, count, 8, swap_lanes16) }
+    void byte_swap_array(uint32_t* data, size_t count) { SWAP_ARRAY(data, count, 4, swap_lanes32) }
+    void byte_swap_array(uint64_t* data, size_t count) { SWAP_ARRAY(data, count, 2, swap_lanes64) }
+
+    #undef SWAP_ARRAY
+}
\ No newline at end of file
@@ -1,12 +1,22 @@
 #pragma once
 
 #include <fstream>
+#include <cstring>
+#include <type_traits>
+#include <stdlib.h>
 #include "Engine/Core/Base.hpp"
 
 namespace rh::endian {
 	enum endian { little, big };
 	constexpr endian default_endian = endian::big;
 
+	///Byte order of the machine we are running on
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	constexpr endian native_endian = endian::big;
+#else
+	constexpr endian native_endian = endian::little;
+#endif
+
 	///Writes number to stream in little endian
 	void write_little(std::ostream& os, uint8_t x);
 	void write_little(std::ostream& os, uint16_t x);
@@ -98,4 +108,86 @@ namespace rh::endian {
 		else
 			read_big(is, x);
 	}
+
+	///Reverses the byte order of a number
+	inline uint8_t byte_swap(uint8_t x) { return x; }
+#if defined(_MSC_VER)
+	inline uint16_t byte_swap(uint16_t x) { return _byteswap_ushort(x); }
+	inline uint32_t byte_swap(uint32_t x) { return _byteswap_ulong(x); }
+	inline uint64_t byte_swap(uint64_t x) { return _byteswap_uint64(x); }
+#else
+	inline uint16_t byte_swap(uint16_t x) { return __builtin_bswap16(x); }
+	inline uint32_t byte_swap(uint32_t x) { return __builtin_bswap32(x); }
+	inline uint64_t byte_swap(uint64_t x) { return __builtin_bswap64(x); }
+#endif
+
+	///Reverses the byte order of count numbers in place, several at a time where SIMD is available
+	inline void byte_swap_array(uint8_t*, size_t) {}
+	void byte_swap_array(uint16_t* data, size_t count);
+	void byte_swap_array(uint32_t* data, size_t count);
+	void byte_swap_array(uint64_t* data, size_t count);
+
+	///Unsigned integer with the same size as T, used to swap floats bitwise
+	template<class T>
+	struct bits_of {
+		typedef typename std::conditional<sizeof(T) == 1, uint8_t,
+			typename std::conditional<sizeof(T) == 2, uint16_t,
+			typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::type type;
+	};
+
+	///Reads number from memory in specified endian, src does not have to be aligned
+	template<class T>
+	T load(const void* src, endian e)
+	{
+		static_assert(std::is_arithmetic<T>::value, "Can only load numbers");
+		typename bits_of<T>::type bits;
+		memcpy(&bits, src, sizeof(T));
+		if (e != native_endian)
+			bits = byte_swap(bits);
+
+		T x;
+		memcpy(&x, &bits, sizeof(T));
+		return x;
+	}
+
+	///Copies count numbers stored in specified endian from src into dst
+	template<class T>
+	void load_array(T* dst, const void* src, size_t count, endian e)
+	{
+		static_assert(std::is_arithmetic<T>::value, "Can only load numbers");
+		memcpy(dst, src, count * sizeof(T));
+		if (e != native_endian)
+			byte_swap_array(reinterpret_cast<typename bits_of<T>::type*>(dst), count);
+	}
+
+	///Reads count numbers from stream in specified endian, with one read for the whole array
+	template<class T>
+	void read_array(std::istream& is, T* data, size_t count, endian e)
+	{
+		static_assert(std::is_arithmetic<T>::value, "Can only read arrays of numbers");
+		is.read(reinterpret_cast<char*>(data), count * sizeof(T));
+		if (e != native_endian)
+			byte_swap_array(reinterpret_cast<typename bits_of<T>::type*>(data), count);
+	}
+
+	///Writes count numbers to stream in specified endian.
+	///Written straight from data if no swap is needed, through a small swap buffer otherwise
+	template<class T>
+	void write_array(std::ostream& os, const T* data, size_t count, endian e)
+	{
+		static_assert(std::is_arithmetic<T>::value, "Can only write arrays of numbers");
+		if (sizeof(T) == 1 || e == native_endian) {
+			os.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+			return;
+		}
+
+		const size_t chunk = 1024;
+		typename bits_of<T>::type buffer[chunk];
+		for (size_t i = 0; i < count; i += chunk) {
+			size_t n = (count - i < chunk) ? count - i : chunk;
+			memcpy(buffer, data + i, n * sizeof(T));
+			byte_swap_array(buffer, n);
+			os.write(reinterpret_cast<const char*>(buffer), n * sizeof(T));
+		}
+	}
 }
\ No newline at end of file
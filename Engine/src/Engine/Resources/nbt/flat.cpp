@@ -0,0 +1,277 @@
+#include <enpch.hpp>
+#include "Engine/Resources/nbt/flat.hpp"
+#include "Engine/Resources/nbt/view.hpp"
+
+namespace rh::nbt {
+
+    namespace { //anonymous
+        const flat_tag null_tag;
+
+        // vectors and matrices are kept as plain floats, matrices column by column
+        void from_floats(const f32* f, laml::Vec2& x) { x.x = f[0]; x.y = f[1]; }
+        void from_floats(const f32* f, laml::Vec3& x) { x.x = f[0]; x.y = f[1]; x.z = f[2]; }
+        void from_floats(const f32* f, laml::Vec4& x) { x.x = f[0]; x.y = f[1]; x.z = f[2]; x.w = f[3]; }
+
+        template<int N, typename M>
+        void matrix_from_floats(const f32* f, M& x) {
+            for (int col = 0; col < N; col++)
+                for (int row = 0; row < N; row++)
+                    x[col][row] = f[col * N + row];
+        }
+
+        template<int N, typename M>
+        void matrix_to_floats(const M& x, f32* f) {
+            for (int col = 0; col < N; col++)
+                for (int row = 0; row < N; row++)
+                    f[col * N + row] = x[col][row];
+        }
+
+        void from_floats(const f32* f, laml::Mat2& x) { matrix_from_floats<2>(f, x); }
+        void from_floats(const f32* f, laml::Mat3& x) { matrix_from_floats<3>(f, x); }
+        void from_floats(const f32* f, laml::Mat4& x) { matrix_from_floats<4>(f, x); }
+
+        template<typename T>
+        flat_array<T> make_array(const void* data, size_t size) {
+            flat_array<T> arr;
+            arr.data = static_cast<const T*>(data);
+            arr.size = size;
+            return arr;
+        }
+    }
+
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * flat_tag  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    template<typename T>
+    T flat_tag::get() const {
+        ENGINE_LOG_ASSERT(type_ == utils::get_primitive_type<T>::value, "nbt tag is not of the requested type");
+        T x;
+        if constexpr (std::is_integral<T>::value) {
+            x = static_cast<T>(integer_);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            x = static_cast<T>(real_);
+        } else {
+            from_floats(floats_, x);
+        }
+        return x;
+    }
+
+    template nbt_byte   flat_tag::get<nbt_byte>() const;
+    template nbt_short  flat_tag::get<nbt_short>() const;
+    template nbt_int    flat_tag::get<nbt_int>() const;
+    template nbt_long   flat_tag::get<nbt_long>() const;
+    template nbt_float  flat_tag::get<nbt_float>() const;
+    template nbt_double flat_tag::get<nbt_double>() const;
+    template laml::Vec2 flat_tag::get<laml::Vec2>() const;
+    template laml::Vec3 flat_tag::get<laml::Vec3>() const;
+    template laml::Vec4 flat_tag::get<laml::Vec4>() const;
+    template laml::Mat2 flat_tag::get<laml::Mat2>() const;
+    template laml::Mat3 flat_tag::get<laml::Mat3>() const;
+    template laml::Mat4 flat_tag::get<laml::Mat4>() const;
+
+    std::string_view flat_tag::as_string() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::String, "nbt tag is not a string");
+        return std::string_view(string_, size_);
+    }
+
+    flat_array<nbt_byte> flat_tag::as_byte_array() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Byte_Array, "nbt tag is not a byte array");
+        return make_array<nbt_byte>(array_, size_);
+    }
+
+    flat_array<nbt_int> flat_tag::as_int_array() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Int_Array, "nbt tag is not an int array");
+        return make_array<nbt_int>(array_, size_);
+    }
+
+    flat_array<nbt_long> flat_tag::as_long_array() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Long_Array, "nbt tag is not a long array");
+        return make_array<nbt_long>(array_, size_);
+    }
+
+    const flat_tag& flat_tag::at(std::string_view key) const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Compound, "nbt tag is not a compound");
+        const flat_entry* it = std::lower_bound(begin(), end(), key,
+            [](const flat_entry& entry, std::string_view key) { return entry.name < key; });
+
+        if (it != end() && it->name == key)
+            return it->value;
+        return null_tag;
+    }
+
+    bool flat_tag::has_key(std::string_view key) const {
+        return (bool)at(key);
+    }
+
+    bool flat_tag::has_key(std::string_view key, tag_type type) const {
+        return at(key).get_type() == type;
+    }
+
+    tag_type flat_tag::el_type() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::List, "nbt tag is not a list");
+        return el_type_;
+    }
+
+    const flat_tag& flat_tag::operator[](size_t i) const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::List, "nbt tag is not a list");
+        ENGINE_LOG_ASSERT(i < size_, "nbt list index out of range");
+        return elements_[i];
+    }
+
+    const flat_entry* flat_tag::begin() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Compound, "nbt tag is not a compound");
+        return entries_;
+    }
+
+    const flat_entry* flat_tag::end() const {
+        return entries_ + size_;
+    }
+
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * flat_document * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    bool flat_document::read_from_file(const std::string& filename) {
+        view source;
+        if (!source.open(filename))
+            return false;
+
+        build(source);
+        return true;
+    }
+
+    void flat_document::build(const view& source) {
+        clear();
+
+        major_ = source.version_major();
+        minor_ = source.version_minor();
+        endian_ = source.endianness();
+        name_ = arena_.copy(source.name());
+        build_tag(root_, source.root());
+    }
+
+    void flat_document::clear() {
+        arena_.reset();
+        major_ = minor_ = 0;
+        name_ = std::string_view();
+        root_ = flat_tag();
+    }
+
+    void flat_document::build_tag(flat_tag& out, const tag_view& in) {
+        out.type_ = in.get_type();
+
+        switch (in.get_type()) {
+        case tag_type::Byte:   out.integer_ = in.get<nbt_byte>();  break;
+        case tag_type::Short:  out.integer_ = in.get<nbt_short>(); break;
+        case tag_type::Int:    out.integer_ = in.get<nbt_int>();   break;
+        case tag_type::Long:   out.integer_ = in.get<nbt_long>();  break;
+        case tag_type::Float:  out.real_ = in.get<nbt_float>();    break;
+        case tag_type::Double: out.real_ = in.get<nbt_double>();   break;
+
+        case tag_type::Vector2: {
+            f32* f = arena_.allocate_array<f32>(2);
+            laml::Vec2 v = in.get<laml::Vec2>();
+            f[0] = v.x; f[1] = v.y;
+            out.floats_ = f;
+        } break;
+        case tag_type::Vector3: {
+            f32* f = arena_.allocate_array<f32>(3);
+            laml::Vec3 v = in.get<laml::Vec3>();
+            f[0] = v.x; f[1] = v.y; f[2] = v.z;
+            out.floats_ = f;
+        } break;
+        case tag_type::Vector4: {
+            f32* f = arena_.allocate_array<f32>(4);
+            laml::Vec4 v = in.get<laml::Vec4>();
+            f[0] = v.x; f[1] = v.y; f[2] = v.z; f[3] = v.w;
+            out.floats_ = f;
+        } break;
+        case tag_type::Matrix2: {
+            f32* f = arena_.allocate_array<f32>(2 * 2);
+            matrix_to_floats<2>(in.get<laml::Mat2>(), f);
+            out.floats_ = f;
+        } break;
+        case tag_type::Matrix3: {
+            f32* f = arena_.allocate_array<f32>(3 * 3);
+            matrix_to_floats<3>(in.get<laml::Mat3>(), f);
+            out.floats_ = f;
+        } break;
+        case tag_type::Matrix4: {
+            f32* f = arena_.allocate_array<f32>(4 * 4);
+            matrix_to_floats<4>(in.get<laml::Mat4>(), f);
+            out.floats_ = f;
+        } break;
+
+        case tag_type::String: {
+            std::string_view str = arena_.copy(in.as_string());
+            out.string_ = str.data();
+            out.size_ = (u32)str.size();
+        } break;
+
+        case tag_type::Byte_Array: {
+            auto arr = in.as_byte_array();
+            nbt_byte* data = arena_.allocate_array<nbt_byte>(arr.size());
+            arr.copy_to(data);
+            out.array_ = data;
+            out.size_ = (u32)arr.size();
+        } break;
+        case tag_type::Int_Array: {
+            auto arr = in.as_int_array();
+            nbt_int* data = arena_.allocate_array<nbt_int>(arr.size());
+            arr.copy_to(data);
+            out.array_ = data;
+            out.size_ = (u32)arr.size();
+        } break;
+        case tag_type::Long_Array: {
+            auto arr = in.as_long_array();
+            nbt_long* data = arena_.allocate_array<nbt_long>(arr.size());
+            arr.copy_to(data);
+            out.array_ = data;
+            out.size_ = (u32)arr.size();
+        } break;
+
+        case tag_type::List: {
+            size_t count = in.size();
+            out.el_type_ = count ? in.el_type() : tag_type::Null;
+            out.size_ = (u32)count;
+
+            flat_tag* elements = arena_.allocate_array<flat_tag>(count);
+            // walk the elements in order, in[i] would rescan variable-size lists from the start
+            tag_view element = count ? in[0] : tag_view();
+            for (size_t i = 0; i < count; i++) {
+                new (&elements[i]) flat_tag();
+                build_tag(elements[i], element);
+                element = tag_view(out.el_type_, element.payload_end(), element.endianness());
+            }
+            out.elements_ = elements;
+        } break;
+
+        case tag_type::Compound: {
+            size_t count = 0;
+            for (auto it = in.begin(); it != in.end(); ++it)
+                count++;
+            out.size_ = (u32)count;
+
+            flat_entry* entries = arena_.allocate_array<flat_entry>(count);
+            size_t n = 0;
+            for (const auto& entry : in) {
+                new (&entries[n]) flat_entry();
+                entries[n].name = arena_.intern(entry.name);
+                build_tag(entries[n].value, entry.value);
+                n++;
+            }
+            // stable, so a duplicate key resolves to the first one in file order like tag_view::at
+            std::stable_sort(entries, entries + count,
+                [](const flat_entry& a, const flat_entry& b) { return a.name < b.name; });
+            out.entries_ = entries;
+        } break;
+
+        default:
+            out.type_ = tag_type::Null;
+            break;
+        }
+    }
+}
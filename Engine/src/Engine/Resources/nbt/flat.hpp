@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "Engine\Resources\nbt\data.hpp"
+#include "Engine\Resources\nbt\utils.hpp"
+#include "Engine\Resources\nbt\endian.hpp"
+#include "Engine\Resources\nbt\arena.hpp"
+
+namespace rh::nbt {
+    class view;
+    class tag_view;
+    struct flat_entry;
+
+    // array payload copied into the arena, already in native endian
+    template<typename T>
+    struct flat_array {
+        const T* data = nullptr;
+        size_t size = 0;
+
+        const T* begin() const { return data; }
+        const T* end() const { return data + size; }
+        T operator[](size_t i) const { return data[i]; }
+    };
+
+    // read-only tag of a flat_document. everything it points to lives in the
+    // document's arena: compounds are arrays of entries sorted by key,
+    // lists are arrays of tags, keys are interned.
+    class flat_tag {
+    public:
+        flat_tag() noexcept : integer_(0) {}
+
+        tag_type get_type() const { return type_; }
+        // false for missing keys
+        explicit operator bool() const { return type_ != tag_type::Null; }
+
+        // primitives, the tag has to be exactly of type T
+        template<typename T>
+        T get() const;
+
+        std::string_view as_string() const;
+
+        flat_array<nbt_byte> as_byte_array() const;
+        flat_array<nbt_int>  as_int_array() const;
+        flat_array<nbt_long> as_long_array() const;
+
+        // access tag by name (compound only), binary search.
+        // returns a Null tag if there is no such key
+        const flat_tag& at(std::string_view key) const;
+        bool has_key(std::string_view key) const;
+        bool has_key(std::string_view key, tag_type type) const;
+
+        // element type (list only)
+        tag_type el_type() const;
+        // number of entries/elements (compound, list and arrays)
+        size_t size() const { return size_; }
+        // access tag by index (list only)
+        const flat_tag& operator[](size_t i) const;
+
+        // iterate the entries of a compound, in key order
+        const flat_entry* begin() const;
+        const flat_entry* end() const;
+
+    private:
+        friend class flat_document;
+
+        tag_type type_ = tag_type::Null;
+        tag_type el_type_ = tag_type::Null;
+        u32 size_ = 0;
+        union {
+            nbt_long integer_;          // byte, short, int, long
+            nbt_double real_;           // float, double
+            const f32* floats_;         // vectors, matrices (column-major)
+            const char* string_;
+            const void* array_;
+            const flat_tag* elements_;  // list
+            const flat_entry* entries_; // compound
+        };
+    };
+
+    // named tag inside a compound
+    struct flat_entry {
+        std::string_view name;
+        flat_tag value;
+    };
+
+    // whole .nbt document parsed into a flat_tag tree inside one arena.
+    // the file is only needed while reading, and the tree is freed in one go
+    // with the document instead of tag by tag.
+    class flat_document {
+    public:
+        explicit flat_document(size_t block_size = 64 * 1024) : arena_(block_size) {}
+
+        // read a whole .nbt file (header included)
+        bool read_from_file(const std::string& filename);
+        // copy an already open view into the arena
+        void build(const view& source);
+        void clear();
+
+        nbt_byte version_major() const { return major_; }
+        nbt_byte version_minor() const { return minor_; }
+        endian::endian endianness() const { return endian_; }
+
+        std::string_view name() const { return name_; }
+        const flat_tag& root() const { return root_; }
+
+        const arena& memory() const { return arena_; }
+
+    private:
+        void build_tag(flat_tag& out, const tag_view& in);
+
+        arena arena_;
+        nbt_byte major_ = 0, minor_ = 0;
+        endian::endian endian_ = endian::default_endian;
+        std::string_view name_;
+        flat_tag root_;
+    };
+}
@@ -27,6 +27,12 @@ namespace rh::nbt {
 			endian::read(is, x, e);
 		}
 
+		template<typename T>
+		void read_array(std::istream& is, T* data, size_t count, endian::endian e = endian::default_endian)
+		{
+			endian::read_array(is, data, count, e);
+		}
+
 
 		void write_type(std::ostream& os, tag_type type);
 		void write_string(std::ostream& os, const std::string& text, endian::endian e);
@@ -38,5 +44,11 @@ namespace rh::nbt {
 		{
 			endian::write(os, x, e);
 		}
+
+		template<typename T>
+		void write_array(std::ostream& os, const T* data, size_t count, endian::endian e = endian::default_endian)
+		{
+			endian::write_array(os, data, count, e);
+		}
 	}
 }
\ No newline at end of file
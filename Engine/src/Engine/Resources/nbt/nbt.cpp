@@ -1,5 +1,6 @@
 #include <enpch.hpp>
 #include "Engine/Resources/nbt/nbt.hpp"
+#include "Engine/Resources/nbt/compress.hpp"
 
 #include <assert.h>
 
@@ -37,7 +38,8 @@ namespace rh::nbt {
         [version_major(1byte)]
         [version_minor(1byte)]
         [endianness(1byte)]
-        [padding(25bytes)]
+        [compression(1byte), 0.2 and up]
+        [padding(24bytes)]
         */
         nbt_byte header[32];
         memset(header, 0, 32);
@@ -55,20 +57,31 @@ namespace rh::nbt {
 
         // padding
         char pad[] = "this data isn't read...";
-        memcpy(header + 7, pad, sizeof(pad));
-
-        file_out.write(reinterpret_cast<char*>(header), 32);
-
-        // write data normally
-        write_compound_raw(file_out, data, endianness);
 
         switch (version_major) {
         case 0:
             switch (version_minor) {
             case 1:
-                // nothing yet
+                memcpy(header + 7, pad, sizeof(pad));
+                file_out.write(reinterpret_cast<char*>(header), 32);
+
+                // write data normally
+                write_compound_raw(file_out, data, endianness);
+
+                return true;
+            case 2: {
+                header[7] = (nbt_byte)compression::lz;
+                memcpy(header + 8, pad, sizeof(pad));
+                file_out.write(reinterpret_cast<char*>(header), 32);
+
+                // write data to memory, then pack it in blocks
+                std::ostringstream body;
+                write_compound_raw(body, data, endianness);
+                std::string raw = body.str();
+                write_blocks(file_out, reinterpret_cast<const u8*>(raw.data()), raw.size(), compression::lz, endianness);
 
                 return true;
+            }
             default:
                 std::cout << "Writing version " << version_major << "." << version_minor << " not supported yet" << std::endl;
                 return false;
@@ -117,6 +130,25 @@ namespace rh::nbt {
                 data = read_compound_raw(file_in, endianness);
 
                 return true;
+            case 2: {
+                // unpack the whole body, then read it like 0.1.
+                // pad starts at header byte 7, which holds the compression from 0.2 on
+                if (pad[0] != (char)compression::none && pad[0] != (char)compression::lz) {
+                    std::cout << "Unknown nbt compression " << (int)pad[0] << std::endl;
+                    return false;
+                }
+
+                std::vector<u8> body;
+                if (!read_blocks(file_in, endianness, body)) {
+                    std::cout << "Malformed nbt body" << std::endl;
+                    return false;
+                }
+
+                memory_istream body_in(body.data(), body.size());
+                data = read_compound_raw(body_in, endianness);
+
+                return true;
+            }
             default:
                 std::cout << "Reading version " << version_major << "." << version_minor << " not supported yet" << std::endl;
                 return false;
@@ -142,7 +174,8 @@ namespace rh::nbt {
             [version_major(1byte)]
             [version_minor(1byte)]
             [endianness(1byte)]
-            [padding(25bytes)]
+            [compression(1byte), 0.2 and up]
+            [padding(24bytes)]
             */
             nbt_byte header[32];
             file_in.read(reinterpret_cast<char*>(header), 32);
@@ -9,14 +9,15 @@ namespace rh::nbt {
 	file_data read_compound_raw(std::istream& is, endian::endian e = endian::default_endian);
 	void write_compound_raw(std::ostream& os, file_data& data, endian::endian e = endian::default_endian);
 	
-    // write to file
+    // write to file. version 0.1 stores the compound as is,
+    // 0.2 packs it in compressed blocks (see compress.hpp)
     bool write_to_file(
         const std::string& filename, 
         file_data& data,
         nbt_byte major, nbt_byte minor,
         endian::endian e = endian::default_endian);
 
-    // read from file
+    // read from file, compressed bodies are unpacked transparently
     bool read_from_file(
         const std::string& filename,
         file_data& data,
@@ -0,0 +1,204 @@
+#include <enpch.hpp>
+#include "Engine/Resources/nbt/sax.hpp"
+#include "Engine/Resources/nbt/compress.hpp"
+
+namespace rh::nbt {
+
+    namespace { //anonymous
+        const int max_depth = 512;
+
+        size_t array_element_size(tag_type type) {
+            switch (type) {
+            case tag_type::Byte_Array: return 1;
+            case tag_type::Int_Array:  return 4;
+            case tag_type::Long_Array: return 8;
+            default:                   return 0;
+            }
+        }
+
+        class sax_parser {
+        public:
+            sax_parser(std::istream& is, sax_handler& handler, endian::endian e) : is_(is), handler_(handler), endian_(e) {}
+
+            const std::string& scratch() const { return scratch_; }
+
+            bool read_type(tag_type& type) {
+                nbt_byte t;
+                endian::read(is_, t, endian_);
+                type = (tag_type)t;
+                return (bool)is_;
+            }
+
+            // reads into the scratch string, so no allocation once it has grown
+            bool read_string() {
+                u16 len;
+                endian::read(is_, len, endian_);
+                if (!is_)
+                    return false;
+
+                scratch_.resize(len);
+                is_.read(&scratch_[0], len);
+                return (bool)is_;
+            }
+
+            template<typename T>
+            bool read_value() {
+                T x;
+                endian::read(is_, x, endian_);
+                if (!is_)
+                    return false;
+                handler_.value(x);
+                return true;
+            }
+
+            bool read_array(tag_type type) {
+                nbt_int length;
+                endian::read(is_, length, endian_);
+                if (!is_ || length < 0)
+                    return false;
+
+                void* dst = handler_.array(type, (size_t)length);
+                if (dst == nullptr) {
+                    is_.ignore((std::streamsize)length * array_element_size(type));
+                    return (bool)is_;
+                }
+
+                switch (type) {
+                case tag_type::Byte_Array: endian::read_array(is_, static_cast<nbt_byte*>(dst), length, endian_); break;
+                case tag_type::Int_Array:  endian::read_array(is_, static_cast<nbt_int*>(dst), length, endian_);  break;
+                case tag_type::Long_Array: endian::read_array(is_, static_cast<nbt_long*>(dst), length, endian_); break;
+                default: return false;
+                }
+                return (bool)is_;
+            }
+
+            bool read_payload(tag_type type, int depth) {
+                if (depth > max_depth)
+                    return false;
+
+                switch (type) {
+                case tag_type::Byte:    return read_value<nbt_byte>();
+                case tag_type::Short:   return read_value<nbt_short>();
+                case tag_type::Int:     return read_value<nbt_int>();
+                case tag_type::Long:    return read_value<nbt_long>();
+                case tag_type::Float:   return read_value<nbt_float>();
+                case tag_type::Double:  return read_value<nbt_double>();
+                case tag_type::Vector2: return read_value<laml::Vec2>();
+                case tag_type::Vector3: return read_value<laml::Vec3>();
+                case tag_type::Vector4: return read_value<laml::Vec4>();
+                case tag_type::Matrix2: return read_value<laml::Mat2>();
+                case tag_type::Matrix3: return read_value<laml::Mat3>();
+                case tag_type::Matrix4: return read_value<laml::Mat4>();
+
+                case tag_type::String:
+                    if (!read_string())
+                        return false;
+                    handler_.string(scratch_);
+                    return true;
+
+                case tag_type::Byte_Array:
+                case tag_type::Int_Array:
+                case tag_type::Long_Array:
+                    return read_array(type);
+
+                case tag_type::List: {
+                    tag_type lt;
+                    nbt_int length;
+                    if (!read_type(lt))
+                        return false;
+                    endian::read(is_, length, endian_);
+                    if (!is_ || length < 0)
+                        return false;
+
+                    // tag_end lists are empty whatever their length says
+                    if (lt == tag_type::End)
+                        length = 0;
+
+                    handler_.begin_list(lt, (size_t)length);
+                    for (nbt_int i = 0; i < length; ++i) {
+                        if (!read_payload(lt, depth + 1))
+                            return false;
+                    }
+                    handler_.end_list();
+                    return true;
+                }
+
+                case tag_type::Compound: {
+                    handler_.begin_compound();
+                    tag_type tt;
+                    while (read_type(tt) && tt != tag_type::End) {
+                        if (!read_string())
+                            return false;
+                        handler_.key(scratch_);
+                        if (!read_payload(tt, depth + 1))
+                            return false;
+                    }
+                    if (!is_)
+                        return false;
+                    handler_.end_compound();
+                    return true;
+                }
+
+                default:
+                    return false;
+                }
+            }
+
+        private:
+            std::istream& is_;
+            sax_handler& handler_;
+            endian::endian endian_;
+            std::string scratch_;
+        };
+    }
+
+    bool sax_read_compound_raw(std::istream& is, sax_handler& handler, endian::endian e) {
+        sax_parser parser(is, handler, e);
+
+        tag_type type;
+        if (!parser.read_type(type) || type != tag_type::Compound)
+            return false;
+        if (!parser.read_string())
+            return false;
+
+        handler.key(parser.scratch());
+        return parser.read_payload(tag_type::Compound, 0);
+    }
+
+    bool sax_read_from_file(
+        const std::string& filename,
+        sax_handler& handler,
+        nbt_byte& major, nbt_byte& minor,
+        endian::endian& endianness) {
+
+        std::ifstream file_in(filename, std::ios::binary);
+        if (!file_in)
+            return false;
+
+        // same 32 byte header as read_from_file
+        nbt_byte header[32];
+        file_in.read(reinterpret_cast<char*>(header), 32);
+        if (!file_in || strncmp(reinterpret_cast<const char*>(header), "1234", 4) != 0)
+            return false;
+
+        major = header[4];
+        minor = header[5];
+        endianness = (header[6] == 1 ? endian::big : endian::little);
+
+        if (major != 0 || (minor != 1 && minor != 2)) {
+            std::cout << "Reading version " << (int)major << "." << (int)minor << " not supported yet" << std::endl;
+            return false;
+        }
+
+        if (minor == 1)
+            return sax_read_compound_raw(file_in, handler, endianness);
+
+        // block body: unpacked a block at a time while the handler takes the data
+        if (header[7] != (nbt_byte)compression::none && header[7] != (nbt_byte)compression::lz) {
+            std::cout << "Unknown nbt compression " << (int)header[7] << std::endl;
+            return false;
+        }
+        block_istream body_in(file_in, endianness);
+        return (bool)body_in && sax_read_compound_raw(body_in, handler, endianness);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <istream>
+#include <string>
+#include <string_view>
+
+#include "Engine\Resources\nbt\data.hpp"
+#include "Engine\Resources\nbt\endian.hpp"
+
+namespace rh::nbt {
+
+    // receives the tags of a file one by one while it is streamed in.
+    // override only what is needed, everything defaults to ignoring the tag.
+    // strings are only valid during the call.
+    class sax_handler {
+    public:
+        virtual ~sax_handler() {}
+
+        // name of the next value inside a compound (and of the root compound)
+        virtual void key(std::string_view name) {}
+
+        virtual void begin_compound() {}
+        virtual void end_compound() {}
+        virtual void begin_list(tag_type el_type, size_t size) {}
+        virtual void end_list() {}
+
+        virtual void value(nbt_byte x) {}
+        virtual void value(nbt_short x) {}
+        virtual void value(nbt_int x) {}
+        virtual void value(nbt_long x) {}
+        virtual void value(nbt_float x) {}
+        virtual void value(nbt_double x) {}
+        virtual void value(const laml::Vec2& x) {}
+        virtual void value(const laml::Vec3& x) {}
+        virtual void value(const laml::Vec4& x) {}
+        virtual void value(const laml::Mat2& x) {}
+        virtual void value(const laml::Mat3& x) {}
+        virtual void value(const laml::Mat4& x) {}
+        virtual void string(std::string_view str) {}
+
+        // byte/int/long array of count elements is next. return where the payload should go
+        // (room for count elements, filled in native endian), or nullptr to skip it
+        virtual void* array(tag_type type, size_t count) { return nullptr; }
+    };
+
+    // stream a raw compound (no header) into handler, returns false if the data is malformed
+    bool sax_read_compound_raw(std::istream& is, sax_handler& handler, endian::endian e = endian::default_endian);
+
+    // stream a .nbt file into handler without building a tag tree
+    bool sax_read_from_file(
+        const std::string& filename,
+        sax_handler& handler,
+        nbt_byte& major, nbt_byte& minor,
+        endian::endian& endianness);
+}
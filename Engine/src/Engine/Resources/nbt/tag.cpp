@@ -892,13 +892,9 @@ namespace rh::nbt
         if (!is)
             __debugbreak();
 
-        data.clear();
-        data.reserve(length);
-        for (int32_t i = 0; i < length; ++i) {
-            T val;
-            io::read_num(is, val, e);
-            data.push_back(val);
-        }
+        // whole payload in one read, swapped in place if the file isn't in native endian
+        data.resize(length);
+        io::read_array(is, data.data(), data.size(), e);
         if (!is)
             __debugbreak();
     }
@@ -922,7 +918,6 @@ namespace rh::nbt
         }
         nbt_int _size = size();
         io::write_num(os, _size, e);
-        for (T i : data)
-            io::write_num(os, i, e);
+        io::write_array(os, data.data(), data.size(), e);
     }
 }
\ No newline at end of file
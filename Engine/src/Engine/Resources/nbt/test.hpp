@@ -1,6 +1,14 @@
 #pragma once
 
 #include "Engine\Resources\nbt\NBT.hpp"
+#include "Engine\Resources\nbt\view.hpp"
+#include "Engine\Resources\nbt\flat.hpp"
+#include "Engine\Resources\nbt\sax.hpp"
+#include "Engine\Resources\nbt\compress.hpp"
+#include "Engine\Core\MemoryTrack.hpp"
+
+#include <filesystem>
+#include <random>
 
 #ifdef ROHIN_GAME
     #include "Engine/Renderer/Mesh.hpp"
@@ -198,4 +206,331 @@ namespace rh::nbtTest {
 
         system("pause");
     }
+
+    // time read_from_file against nbt::view on every shipped model.
+    // both get the mesh arrays out into vectors, like Mesh does.
+    void test6() {
+        const int iterations = 50;
+
+        for (const auto& file : std::filesystem::directory_iterator("Data/Models")) {
+            if (file.path().extension() != ".nbt")
+                continue;
+            std::string filename = file.path().string();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int n = 0; n < iterations; n++) {
+                nbt::file_data data;
+                nbt::nbt_byte version_major, version_minor;
+                endian::endian endianness;
+                if (!nbt::read_from_file(filename, data, version_major, version_minor, endianness)) {
+                    std::cout << "failed to read " << filename << std::endl;
+                    break;
+                }
+
+                auto& comp = *data.second;
+                const auto& vert_bytes = comp["vertices"].as<nbt::tag_byte_array>().get();
+                std::vector<nbt::nbt_byte> vertices(vert_bytes.begin(), vert_bytes.end());
+                std::vector<nbt::nbt_int> indices = comp["indices"].as<nbt::tag_int_array>().get();
+            }
+            auto mid = std::chrono::high_resolution_clock::now();
+            for (int n = 0; n < iterations; n++) {
+                nbt::view file_view;
+                if (!file_view.open(filename)) {
+                    std::cout << "failed to view " << filename << std::endl;
+                    break;
+                }
+
+                auto vert_bytes = file_view.root().at("vertices").as_byte_array();
+                std::vector<nbt::nbt_byte> vertices(vert_bytes.size());
+                vert_bytes.copy_to(vertices.data());
+
+                auto index_ints = file_view.root().at("indices").as_int_array();
+                std::vector<nbt::nbt_int> indices(index_ints.size());
+                index_ints.copy_to(indices.data());
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double reader_ms = std::chrono::duration<double, std::milli>(mid - start).count() / iterations;
+            double view_ms = std::chrono::duration<double, std::milli>(end - mid).count() / iterations;
+            std::cout << filename << ": read_from_file " << reader_ms << "ms, view " << view_ms << "ms" << std::endl;
+        }
+
+        system("pause");
+    }
+
+    // count the heap allocations it takes to load and free a file as a tag tree,
+    // as an arena-backed flat_document, and through a plain view.
+    // needs TRACK_NEW_AND_DELETE set to 1 in MemoryTrack.hpp, otherwise every count is 0
+    void test7() {
+        const char* files[] = { "Data/Materials/all_materials.nbt", "Data/Models/helmet.nbt" };
+
+        for (const char* filename : files) {
+            u64 start = MemoryTracker::GetNumAllocations();
+            {
+                nbt::file_data data;
+                nbt::nbt_byte version_major, version_minor;
+                endian::endian endianness;
+                nbt::read_from_file(filename, data, version_major, version_minor, endianness);
+            }
+            u64 tree_allocs = MemoryTracker::GetNumAllocations() - start;
+
+            start = MemoryTracker::GetNumAllocations();
+            size_t arena_bytes = 0;
+            {
+                nbt::flat_document doc;
+                doc.read_from_file(filename);
+                arena_bytes = doc.memory().bytes_used();
+            }
+            u64 flat_allocs = MemoryTracker::GetNumAllocations() - start;
+
+            start = MemoryTracker::GetNumAllocations();
+            {
+                nbt::view file_view;
+                file_view.open(filename);
+            }
+            u64 view_allocs = MemoryTracker::GetNumAllocations() - start;
+
+            std::cout << filename << ": tag tree " << tree_allocs << " allocations, flat_document " << flat_allocs
+                << " (" << arena_bytes << " bytes of arena), view " << view_allocs << std::endl;
+        }
+
+        system("pause");
+    }
+
+    // peak heap use while getting a mesh's vertices and indices into vectors,
+    // through a whole tag tree and streamed with the sax reader.
+    // needs TRACK_NEW_AND_DELETE set to 1 in MemoryTrack.hpp
+    void test8() {
+        struct mesh_arrays : public nbt::sax_handler {
+            std::vector<nbt::nbt_byte> vertices;
+            std::vector<nbt::nbt_int> indices;
+            std::string last_key;
+
+            void key(std::string_view name) override { last_key = name; }
+            void* array(nbt::tag_type type, size_t count) override {
+                if (type == nbt::tag_type::Byte_Array && last_key == "vertices") {
+                    vertices.resize(count);
+                    return vertices.data();
+                }
+                if (type == nbt::tag_type::Int_Array && last_key == "indices") {
+                    indices.resize(count);
+                    return indices.data();
+                }
+                return nullptr;
+            }
+        };
+
+        const char* filename = "Data/Models/helmet.nbt";
+        nbt::nbt_byte version_major, version_minor;
+        endian::endian endianness;
+
+        u64 base = MemoryTracker::GetBytesAllocated() - MemoryTracker::GetBytesFreed();
+        MemoryTracker::ResetPeakBytes();
+        size_t mesh_bytes = 0;
+        {
+            nbt::file_data data;
+            nbt::read_from_file(filename, data, version_major, version_minor, endianness);
+
+            auto& comp = *data.second;
+            const auto& vert_bytes = comp["vertices"].as<nbt::tag_byte_array>().get();
+            std::vector<nbt::nbt_byte> vertices(vert_bytes.begin(), vert_bytes.end());
+            std::vector<nbt::nbt_int> indices = comp["indices"].as<nbt::tag_int_array>().get();
+            mesh_bytes = vertices.size() + indices.size() * sizeof(nbt::nbt_int);
+        }
+        u64 tree_peak = MemoryTracker::GetPeakBytes() - base;
+
+        MemoryTracker::ResetPeakBytes();
+        {
+            mesh_arrays mesh;
+            nbt::sax_read_from_file(filename, mesh, version_major, version_minor, endianness);
+        }
+        u64 sax_peak = MemoryTracker::GetPeakBytes() - base;
+
+        std::cout << filename << ": mesh data " << mesh_bytes << " bytes, peak with tag tree "
+            << tree_peak << " bytes, peak with sax reader " << sax_peak << " bytes" << std::endl;
+
+        system("pause");
+    }
+
+    // load time and bytes read for each model as written (0.1) and
+    // recompressed as version 0.2, through read_from_file and the view
+    void test9() {
+        const int iterations = 50;
+
+        auto time_loads = [](const std::string& filename, double& reader_ms, double& view_ms) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int n = 0; n < iterations; n++) {
+                nbt::file_data data;
+                nbt::nbt_byte version_major, version_minor;
+                endian::endian endianness;
+                nbt::read_from_file(filename, data, version_major, version_minor, endianness);
+            }
+            auto mid = std::chrono::high_resolution_clock::now();
+            for (int n = 0; n < iterations; n++) {
+                nbt::view file_view;
+                file_view.open(filename);
+
+                auto vert_bytes = file_view.root().at("vertices").as_byte_array();
+                std::vector<nbt::nbt_byte> vertices(vert_bytes.size());
+                vert_bytes.copy_to(vertices.data());
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+
+            reader_ms = std::chrono::duration<double, std::milli>(mid - start).count() / iterations;
+            view_ms = std::chrono::duration<double, std::milli>(end - mid).count() / iterations;
+        };
+
+        for (const auto& file : std::filesystem::directory_iterator("Data/Models")) {
+            if (file.path().extension() != ".nbt")
+                continue;
+            std::string filename = file.path().string();
+            std::string packed_name = (std::filesystem::temp_directory_path() / file.path().filename()).string();
+
+            nbt::file_data data;
+            nbt::nbt_byte version_major, version_minor;
+            endian::endian endianness;
+            if (!nbt::read_from_file(filename, data, version_major, version_minor, endianness) ||
+                !nbt::write_to_file(packed_name, data, 0, 2, endianness)) {
+                std::cout << "failed to recompress " << filename << std::endl;
+                continue;
+            }
+
+            double raw_reader_ms, raw_view_ms, packed_reader_ms, packed_view_ms;
+            time_loads(filename, raw_reader_ms, raw_view_ms);
+            time_loads(packed_name, packed_reader_ms, packed_view_ms);
+
+            std::cout << filename << ": raw " << std::filesystem::file_size(filename) << " bytes, "
+                << raw_reader_ms << "ms read_from_file, " << raw_view_ms << "ms view | compressed "
+                << std::filesystem::file_size(packed_name) << " bytes, "
+                << packed_reader_ms << "ms read_from_file, " << packed_view_ms << "ms view" << std::endl;
+
+            std::filesystem::remove(packed_name);
+        }
+
+        system("pause");
+    }
+
+    // lz codec and block round trips on the inputs most likely to break it:
+    // the short inputs around the 12 byte match limit, overlapping matches,
+    // data that doesn't compress, exact block sizes, and broken streams
+    void test10() {
+        int failures = 0;
+        auto check = [&failures](bool ok, const std::string& what) {
+            if (!ok) {
+                std::cout << "FAILED: " << what << std::endl;
+                failures++;
+            }
+        };
+
+        std::mt19937 rng(1234);
+        auto random_bytes = [&rng](size_t size) {
+            std::vector<u8> data(size);
+            for (auto& b : data)
+                b = (u8)(rng() & 0xFF);
+            return data;
+        };
+        // repeats the first period bytes, so every match overlaps itself when period < 16
+        auto run_of = [&random_bytes](size_t size, size_t period) {
+            std::vector<u8> data = random_bytes(size);
+            for (size_t n = period; n < size; n++)
+                data[n] = data[n - period];
+            return data;
+        };
+
+        std::vector<std::pair<std::string, std::vector<u8>>> inputs = {
+            { "empty", {} },
+            { "1 byte", random_bytes(1) },
+            { "12 bytes", run_of(12, 1) },
+            { "13 bytes", run_of(13, 1) },
+            { "13 random bytes", random_bytes(13) },
+            { "incompressible", random_bytes(10000) },
+            { "64K random", random_bytes(nbt::block_size) },
+            { "64K run", run_of(nbt::block_size, 3) },
+            { "64K + 1 run", run_of(nbt::block_size + 1, 7) },
+            { "200K repeating", run_of(200000, 4000) },
+        };
+        for (size_t period = 1; period <= 16; period++) {
+            // with data after the run too, near the end of the output the decoder copies more carefully
+            std::vector<u8> data = run_of(5000, period);
+            inputs.push_back({ "run, period " + std::to_string(period), data });
+            std::vector<u8> tail = random_bytes(100);
+            data.insert(data.end(), tail.begin(), tail.end());
+            inputs.push_back({ "run + tail, period " + std::to_string(period), data });
+        }
+
+        for (const auto& [name, raw] : inputs) {
+            // lz codec on one block's worth
+            if (raw.size() <= nbt::block_size) {
+                std::vector<u8> packed(raw.size() + raw.size() / 255 + 16);
+                size_t packed_size = nbt::lz::compress(raw.data(), raw.size(), packed.data(), packed.size());
+                check(packed_size > 0, name + ": compress");
+                packed.resize(packed_size);
+
+                std::vector<u8> unpacked(raw.size());
+                check(nbt::lz::decompress(packed.data(), packed.size(), unpacked.data(), unpacked.size()) && unpacked == raw,
+                    name + ": round trip");
+
+                // every truncation has to be caught, not just read past the end
+                for (size_t n = 0; n < packed.size() && !raw.empty(); n++) {
+                    if (nbt::lz::decompress(packed.data(), n, unpacked.data(), unpacked.size())) {
+                        check(false, name + ": truncated to " + std::to_string(n) + " bytes");
+                        break;
+                    }
+                }
+
+                // output that doesn't fit, or doesn't fill, the expected size
+                if (!raw.empty()) {
+                    check(!nbt::lz::decompress(packed.data(), packed.size(), unpacked.data(), unpacked.size() - 1), name + ": short output");
+                    unpacked.resize(raw.size() + 1);
+                    check(!nbt::lz::decompress(packed.data(), packed.size(), unpacked.data(), unpacked.size()), name + ": long output");
+                }
+            }
+
+            // blocks, through both readers
+            for (auto c : { nbt::compression::none, nbt::compression::lz }) {
+                std::ostringstream os;
+                nbt::write_blocks(os, raw.data(), raw.size(), c, endian::little);
+                std::string body = os.str();
+                const u8* p = reinterpret_cast<const u8*>(body.data());
+
+                std::vector<u8> from_memory, from_stream;
+                nbt::memory_istream is(p, body.size());
+                check(nbt::read_blocks(p, body.size(), endian::little, from_memory) && from_memory == raw, name + ": blocks from memory");
+                check(nbt::read_blocks(is, endian::little, from_stream) && from_stream == raw, name + ": blocks from stream");
+
+                for (size_t n = 0; n < body.size(); n += 1 + body.size() / 64) {
+                    nbt::memory_istream truncated(p, n);
+                    check(!nbt::read_blocks(p, n, endian::little, from_memory), name + ": blocks truncated in memory");
+                    check(!nbt::read_blocks(truncated, endian::little, from_stream), name + ": blocks truncated in stream");
+                }
+            }
+        }
+
+        // hand-made broken streams
+        std::vector<u8> out(64);
+        const u8 zero_offset[]   = { 0x10, 'a', 0x00, 0x00, 0x00 };
+        const u8 far_offset[]    = { 0x10, 'a', 0x02, 0x00, 0x00 };
+        const u8 long_literals[] = { 0xF0, 0x40, 'a', 'b' };
+        const u8 open_length[]   = { 0xF0, 0xFF, 0xFF };
+        check(!nbt::lz::decompress(zero_offset, sizeof(zero_offset), out.data(), 5), "offset of 0");
+        check(!nbt::lz::decompress(far_offset, sizeof(far_offset), out.data(), 5), "offset before the output");
+        check(!nbt::lz::decompress(long_literals, sizeof(long_literals), out.data(), out.size()), "literals past the input");
+        check(!nbt::lz::decompress(open_length, sizeof(open_length), out.data(), out.size()), "unterminated length");
+
+        // block headers: a total the input can't unpack to, a block over block_size, stored larger than raw
+        const std::vector<std::pair<std::string, std::vector<u8>>> bodies = {
+            { "huge total",   { 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 'a' } },
+            { "huge block",   { 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 'a' } },
+            { "stored > raw", { 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 'a', 'b' } },
+        };
+        for (const auto& [name, body] : bodies) {
+            nbt::memory_istream is(body.data(), body.size());
+            check(!nbt::read_blocks(body.data(), body.size(), endian::little, out), name + " in memory");
+            check(!nbt::read_blocks(is, endian::little, out), name + " in stream");
+        }
+
+        std::cout << "lz codec: " << failures << " failures" << std::endl;
+
+        system("pause");
+    }
 }
\ No newline at end of file
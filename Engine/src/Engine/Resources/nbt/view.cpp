@@ -0,0 +1,563 @@
+#include <enpch.hpp>
+#include "Engine/Resources/nbt/view.hpp"
+#include "Engine/Resources/nbt/compress.hpp"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace rh::nbt {
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * mapped_file * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    mapped_file::mapped_file(mapped_file&& rhs) noexcept {
+        *this = std::move(rhs);
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& rhs) noexcept {
+        if (this != &rhs) {
+            close();
+            std::swap(data_, rhs.data_);
+            std::swap(size_, rhs.size_);
+#ifdef _WIN32
+            std::swap(file_, rhs.file_);
+            std::swap(mapping_, rhs.mapping_);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool mapped_file::open(const std::string& filename) {
+        close();
+
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            return false;
+        }
+
+        const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        file_ = file;
+        mapping_ = mapping;
+        data_ = static_cast<const u8*>(data);
+        size_ = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    void mapped_file::close() {
+        if (data_)
+            UnmapViewOfFile(data_);
+        if (mapping_)
+            CloseHandle(mapping_);
+        if (file_)
+            CloseHandle(file_);
+
+        data_ = nullptr;
+        size_ = 0;
+        file_ = nullptr;
+        mapping_ = nullptr;
+    }
+#else
+    bool mapped_file::open(const std::string& filename) {
+        close();
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps its own reference to the file
+        if (data == MAP_FAILED)
+            return false;
+
+        data_ = static_cast<const u8*>(data);
+        size_ = (size_t)st.st_size;
+        return true;
+    }
+
+    void mapped_file::close() {
+        if (data_)
+            munmap(const_cast<u8*>(data_), size_);
+
+        data_ = nullptr;
+        size_ = 0;
+    }
+#endif
+
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * payload walking * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    namespace { //anonymous
+        const int max_depth = 512; // nesting limit when validating, keeps a bad file from blowing the stack
+
+        // size of payloads that don't depend on their contents, 0 for the rest
+        size_t fixed_payload_size(tag_type type) {
+            switch (type) {
+            case tag_type::Byte:    return 1;
+            case tag_type::Short:   return 2;
+            case tag_type::Int:     return 4;
+            case tag_type::Long:    return 8;
+            case tag_type::Float:   return 4;
+            case tag_type::Double:  return 8;
+            case tag_type::Vector2: return 2 * 4;
+            case tag_type::Vector3: return 3 * 4;
+            case tag_type::Vector4: return 4 * 4;
+            case tag_type::Matrix2: return 2 * 2 * 4;
+            case tag_type::Matrix3: return 3 * 3 * 4;
+            case tag_type::Matrix4: return 4 * 4 * 4;
+            default:                return 0;
+            }
+        }
+
+        size_t array_element_size(tag_type type) {
+            switch (type) {
+            case tag_type::Byte_Array: return 1;
+            case tag_type::Int_Array:  return 4;
+            case tag_type::Long_Array: return 8;
+            default:                   return 0;
+            }
+        }
+
+        bool is_valid_type(tag_type type) {
+            return type >= tag_type::Byte && type <= tag_type::Matrix4;
+        }
+
+        const u8* skip_string(const u8* p, endian::endian e) {
+            return p + 2 + endian::load<u16>(p, e);
+        }
+
+        // pointer just past the payload at p. only used on validated data
+        const u8* skip_payload(tag_type type, const u8* p, endian::endian e) {
+            size_t fixed = fixed_payload_size(type);
+            if (fixed)
+                return p + fixed;
+
+            switch (type) {
+            case tag_type::String:
+                return skip_string(p, e);
+
+            case tag_type::Byte_Array:
+            case tag_type::Int_Array:
+            case tag_type::Long_Array:
+                return p + 4 + (size_t)endian::load<nbt_int>(p, e) * array_element_size(type);
+
+            case tag_type::List: {
+                tag_type lt = (tag_type)p[0];
+                nbt_int length = endian::load<nbt_int>(p + 1, e);
+                p += 5;
+                if (lt == tag_type::End)
+                    return p;
+
+                size_t el_size = fixed_payload_size(lt);
+                if (el_size)
+                    return p + el_size * (size_t)length;
+
+                for (nbt_int i = 0; i < length; ++i)
+                    p = skip_payload(lt, p, e);
+                return p;
+            }
+
+            case tag_type::Compound: {
+                tag_type tt;
+                while ((tt = (tag_type)p[0]) != tag_type::End)
+                    p = skip_payload(tt, skip_string(p + 1, e), e);
+                return p + 1;
+            }
+
+            default:
+                return p;
+            }
+        }
+
+        // same as skip_payload, but checks every read against end.
+        // returns nullptr if the payload is malformed or runs past end
+        const u8* check_payload(tag_type type, const u8* p, const u8* end, endian::endian e, int depth) {
+            if (depth > max_depth)
+                return nullptr;
+
+            auto fits = [&p, end](size_t n) { return (size_t)(end - p) >= n; };
+
+            size_t fixed = fixed_payload_size(type);
+            if (fixed)
+                return fits(fixed) ? p + fixed : nullptr;
+
+            switch (type) {
+            case tag_type::String: {
+                if (!fits(2))
+                    return nullptr;
+                size_t len = endian::load<u16>(p, e);
+                p += 2;
+                return fits(len) ? p + len : nullptr;
+            }
+
+            case tag_type::Byte_Array:
+            case tag_type::Int_Array:
+            case tag_type::Long_Array: {
+                if (!fits(4))
+                    return nullptr;
+                nbt_int length = endian::load<nbt_int>(p, e);
+                p += 4;
+                if (length < 0)
+                    return nullptr;
+                size_t bytes = (size_t)length * array_element_size(type);
+                return fits(bytes) ? p + bytes : nullptr;
+            }
+
+            case tag_type::List: {
+                if (!fits(5))
+                    return nullptr;
+                tag_type lt = (tag_type)p[0];
+                nbt_int length = endian::load<nbt_int>(p + 1, e);
+                p += 5;
+                if (lt == tag_type::End)
+                    return p; // length is ignored, same as tag_list
+                if (!is_valid_type(lt) || length < 0)
+                    return nullptr;
+
+                size_t el_size = fixed_payload_size(lt);
+                if (el_size)
+                    return (size_t)(end - p) / el_size >= (size_t)length ? p + el_size * (size_t)length : nullptr;
+
+                for (nbt_int i = 0; i < length && p; ++i)
+                    p = check_payload(lt, p, end, e, depth + 1);
+                return p;
+            }
+
+            case tag_type::Compound: {
+                while (p) {
+                    if (!fits(1))
+                        return nullptr;
+                    tag_type tt = (tag_type)p[0];
+                    p += 1;
+                    if (tt == tag_type::End)
+                        return p;
+                    if (!is_valid_type(tt))
+                        return nullptr;
+
+                    p = check_payload(tag_type::String, p, end, e, depth);
+                    if (p)
+                        p = check_payload(tt, p, end, e, depth + 1);
+                }
+                return nullptr;
+            }
+
+            default:
+                return nullptr;
+            }
+        }
+
+        std::string_view read_name(const u8* p, endian::endian e) {
+            return std::string_view(reinterpret_cast<const char*>(p + 2), endian::load<u16>(p, e));
+        }
+
+        // primitives straight out of the mapping.
+        // matrices are stored row by row, same as endian::read
+        template<typename T>
+        void load_primitive(const u8* p, endian::endian e, T& x) {
+            x = endian::load<T>(p, e);
+        }
+
+        void load_primitive(const u8* p, endian::endian e, laml::Vec2& x) {
+            x.x = endian::load<f32>(p + 0, e);
+            x.y = endian::load<f32>(p + 4, e);
+        }
+
+        void load_primitive(const u8* p, endian::endian e, laml::Vec3& x) {
+            x.x = endian::load<f32>(p + 0, e);
+            x.y = endian::load<f32>(p + 4, e);
+            x.z = endian::load<f32>(p + 8, e);
+        }
+
+        void load_primitive(const u8* p, endian::endian e, laml::Vec4& x) {
+            x.x = endian::load<f32>(p + 0, e);
+            x.y = endian::load<f32>(p + 4, e);
+            x.z = endian::load<f32>(p + 8, e);
+            x.w = endian::load<f32>(p + 12, e);
+        }
+
+        template<int N, typename M>
+        void load_matrix(const u8* p, endian::endian e, M& x) {
+            for (int row = 0; row < N; row++) {
+                for (int col = 0; col < N; col++) {
+                    x[col][row] = endian::load<f32>(p + 4 * (row * N + col), e);
+                }
+            }
+        }
+
+        void load_primitive(const u8* p, endian::endian e, laml::Mat2& x) { load_matrix<2>(p, e, x); }
+        void load_primitive(const u8* p, endian::endian e, laml::Mat3& x) { load_matrix<3>(p, e, x); }
+        void load_primitive(const u8* p, endian::endian e, laml::Mat4& x) { load_matrix<4>(p, e, x); }
+    }
+
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * tag_view  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    template<typename T>
+    T tag_view::get() const {
+        ENGINE_LOG_ASSERT(type_ == utils::get_primitive_type<T>::value, "nbt tag is not of the requested type");
+        T x;
+        load_primitive(payload_, endian_, x);
+        return x;
+    }
+
+    template nbt_byte   tag_view::get<nbt_byte>() const;
+    template nbt_short  tag_view::get<nbt_short>() const;
+    template nbt_int    tag_view::get<nbt_int>() const;
+    template nbt_long   tag_view::get<nbt_long>() const;
+    template nbt_float  tag_view::get<nbt_float>() const;
+    template nbt_double tag_view::get<nbt_double>() const;
+    template laml::Vec2 tag_view::get<laml::Vec2>() const;
+    template laml::Vec3 tag_view::get<laml::Vec3>() const;
+    template laml::Vec4 tag_view::get<laml::Vec4>() const;
+    template laml::Mat2 tag_view::get<laml::Mat2>() const;
+    template laml::Mat3 tag_view::get<laml::Mat3>() const;
+    template laml::Mat4 tag_view::get<laml::Mat4>() const;
+
+    std::string_view tag_view::as_string() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::String, "nbt tag is not a string");
+        return read_name(payload_, endian_);
+    }
+
+    array_view<nbt_byte> tag_view::as_byte_array() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Byte_Array, "nbt tag is not a byte array");
+        return array_view<nbt_byte>(payload_ + 4, (size_t)endian::load<nbt_int>(payload_, endian_), endian_);
+    }
+
+    array_view<nbt_int> tag_view::as_int_array() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Int_Array, "nbt tag is not an int array");
+        return array_view<nbt_int>(payload_ + 4, (size_t)endian::load<nbt_int>(payload_, endian_), endian_);
+    }
+
+    array_view<nbt_long> tag_view::as_long_array() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Long_Array, "nbt tag is not a long array");
+        return array_view<nbt_long>(payload_ + 4, (size_t)endian::load<nbt_int>(payload_, endian_), endian_);
+    }
+
+    tag_view tag_view::at(std::string_view key) const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Compound, "nbt tag is not a compound");
+        for (const auto& entry : *this) {
+            if (entry.name == key)
+                return entry.value;
+        }
+        return tag_view();
+    }
+
+    bool tag_view::has_key(std::string_view key) const {
+        return (bool)at(key);
+    }
+
+    bool tag_view::has_key(std::string_view key, tag_type type) const {
+        return at(key).get_type() == type;
+    }
+
+    tag_type tag_view::el_type() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::List, "nbt tag is not a list");
+        return (tag_type)payload_[0];
+    }
+
+    size_t tag_view::size() const {
+        switch (type_) {
+        case tag_type::List:
+            if ((tag_type)payload_[0] == tag_type::End)
+                return 0;
+            return (size_t)endian::load<nbt_int>(payload_ + 1, endian_);
+        case tag_type::Byte_Array:
+        case tag_type::Int_Array:
+        case tag_type::Long_Array:
+            return (size_t)endian::load<nbt_int>(payload_, endian_);
+        default:
+            ENGINE_LOG_ASSERT(false, "nbt tag is not a list or array");
+            return 0;
+        }
+    }
+
+    tag_view tag_view::operator[](size_t i) const {
+        ENGINE_LOG_ASSERT(i < size(), "nbt list index out of range");
+        tag_type lt = el_type();
+        const u8* p = payload_ + 5;
+
+        size_t el_size = fixed_payload_size(lt);
+        if (el_size) {
+            p += el_size * i;
+        } else {
+            for (size_t n = 0; n < i; ++n)
+                p = skip_payload(lt, p, endian_);
+        }
+        return tag_view(lt, p, endian_);
+    }
+
+    const u8* tag_view::payload_end() const {
+        return skip_payload(type_, payload_, endian_);
+    }
+
+    tag_view::iterator tag_view::begin() const {
+        ENGINE_LOG_ASSERT(type_ == tag_type::Compound, "nbt tag is not a compound");
+        return iterator(payload_, endian_);
+    }
+
+    tag_view::iterator tag_view::end() const {
+        return iterator();
+    }
+
+    tag_view::iterator::iterator(const u8* pos, endian::endian e) : pos_(pos), endian_(e) {
+        parse();
+    }
+
+    tag_view::iterator& tag_view::iterator::operator++() {
+        pos_ = skip_payload(current_.value.get_type(), current_.value.payload(), endian_);
+        parse();
+        return *this;
+    }
+
+    void tag_view::iterator::parse() {
+        tag_type tt = (tag_type)pos_[0];
+        if (tt == tag_type::End) {
+            pos_ = nullptr;
+            current_ = entry();
+            return;
+        }
+
+        current_.name = read_name(pos_ + 1, endian_);
+        current_.value = tag_view(tt, skip_string(pos_ + 1, endian_), endian_);
+    }
+
+
+    /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * view  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+     * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+    bool view::open(const std::string& filename) {
+        close();
+
+        if (!file_.open(filename))
+            return false;
+
+        const u8* data = file_.data();
+        const u8* end = data + file_.size();
+
+        // same 32 byte header as read_from_file
+        if (file_.size() < 32 || strncmp(reinterpret_cast<const char*>(data), "1234", 4) != 0) {
+            std::cout << "Not an nbt file: " << filename << std::endl;
+            close();
+            return false;
+        }
+        major_ = data[4];
+        minor_ = data[5];
+        endian_ = (data[6] == 1 ? endian::big : endian::little);
+
+        if (major_ != 0 || (minor_ != 1 && minor_ != 2)) {
+            std::cout << "Reading version " << (int)major_ << "." << (int)minor_ << " not supported yet" << std::endl;
+            close();
+            return false;
+        }
+
+        // root compound: type, name, payload
+        const u8* p = data + 32;
+
+        // compressed body: unpack it and view the copy instead of the mapping
+        if (minor_ == 2) {
+            if (data[7] != (u8)compression::none && data[7] != (u8)compression::lz) {
+                std::cout << "Unknown nbt compression " << (int)data[7] << ": " << filename << std::endl;
+                close();
+                return false;
+            }
+            if (!read_blocks(p, end - p, endian_, unpacked_)) {
+                std::cout << "Malformed nbt file: " << filename << std::endl;
+                close();
+                return false;
+            }
+            file_.close();
+            p = unpacked_.data();
+            end = p + unpacked_.size();
+        }
+
+        if (p == end || (tag_type)p[0] != tag_type::Compound) {
+            close();
+            return false;
+        }
+        const u8* payload = check_payload(tag_type::String, p + 1, end, endian_, 0);
+        if (!payload || !check_payload(tag_type::Compound, payload, end, endian_, 0)) {
+            std::cout << "Malformed nbt file: " << filename << std::endl;
+            close();
+            return false;
+        }
+
+        name_ = read_name(p + 1, endian_);
+        root_ = tag_view(tag_type::Compound, payload, endian_);
+        return true;
+    }
+
+    void view::close() {
+        file_.close();
+        unpacked_.clear();
+        unpacked_.shrink_to_fit();
+        major_ = minor_ = 0;
+        name_ = std::string_view();
+        root_ = tag_view();
+    }
+
+    // Safe/Gauranteed accessors
+    std::string SafeGetString(const tag_view& comp, std::string_view key, const std::string& fallback) {
+        tag_view t = comp.at(key);
+        if (!t)
+            return fallback;
+
+        ENGINE_LOG_ASSERT(t.get_type() == tag_type::String, "Value at key must be a string");
+        return std::string(t.as_string());
+    }
+
+    laml::Vec3 SafeGetVec3(const tag_view& comp, std::string_view key, const laml::Vec3& fallback) {
+        tag_view t = comp.at(key);
+        if (!t)
+            return fallback;
+
+        ENGINE_LOG_ASSERT(t.get_type() == tag_type::Vector3, "Value at key must be a vec3");
+        return t.get<laml::Vec3>();
+    }
+
+    float SafeGetFloat(const tag_view& comp, std::string_view key, float fallback) {
+        tag_view t = comp.at(key);
+        if (!t)
+            return fallback;
+
+        ENGINE_LOG_ASSERT(t.get_type() == tag_type::Float, "Value at key must be a float");
+        return t.get<nbt_float>();
+    }
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Engine\Resources\nbt\data.hpp"
+#include "Engine\Resources\nbt\utils.hpp"
+#include "Engine\Resources\nbt\endian.hpp"
+
+namespace rh::nbt {
+
+    // read-only memory mapping of a whole file
+    class mapped_file {
+    public:
+        mapped_file() noexcept {}
+        ~mapped_file() { close(); }
+
+        mapped_file(mapped_file&& rhs) noexcept;
+        mapped_file& operator=(mapped_file&& rhs) noexcept;
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        // map the file, fails on missing or empty files
+        bool open(const std::string& filename);
+        void close();
+
+        const u8* data() const { return data_; }
+        size_t size() const { return size_; }
+        explicit operator bool() const { return data_ != nullptr; }
+
+    private:
+        const u8* data_ = nullptr;
+        size_t size_ = 0;
+#ifdef _WIN32
+        void* file_ = nullptr;      // HANDLE
+        void* mapping_ = nullptr;   // HANDLE
+#endif
+    };
+
+    // array payload left where it is in the file.
+    // elements are stored in the file's endianness and are not aligned,
+    // so they are read one at a time with [] or all at once with copy_to().
+    template<typename T>
+    class array_view {
+    public:
+        array_view() noexcept {}
+        array_view(const u8* data, size_t size, endian::endian e) noexcept : data_(data), size_(size), endian_(e) {}
+
+        size_t size() const { return size_; }
+        size_t size_bytes() const { return size_ * sizeof(T); }
+        bool empty() const { return size_ == 0; }
+
+        // raw bytes of the payload in the mapping
+        const u8* bytes() const { return data_; }
+        // true if bytes() can be used as T's without swapping
+        bool is_native() const { return sizeof(T) == 1 || endian_ == endian::native_endian; }
+
+        T operator[](size_t i) const { return endian::load<T>(data_ + i * sizeof(T), endian_); }
+
+        // copy all elements into dst (size() elements), swapping to the native endian
+        void copy_to(T* dst) const { endian::load_array(dst, data_, size_, endian_); }
+
+    private:
+        const u8* data_ = nullptr;
+        size_t size_ = 0;
+        endian::endian endian_ = endian::default_endian;
+    };
+
+    // one tag inside a mapped .nbt file. only holds pointers into the mapping,
+    // so it is cheap to copy and valid as long as the nbt::view it came from.
+    // the file is checked once on open, so accessors don't bounds check again.
+    class tag_view {
+    public:
+        struct entry;
+        class iterator;
+
+        tag_view() noexcept {}
+        tag_view(tag_type type, const u8* payload, endian::endian e) noexcept : type_(type), payload_(payload), endian_(e) {}
+
+        tag_type get_type() const { return type_; }
+        // false for missing keys
+        explicit operator bool() const { return type_ != tag_type::Null; }
+
+        // primitives, the tag has to be exactly of type T
+        template<typename T>
+        T get() const;
+
+        // string payload, points into the mapping
+        std::string_view as_string() const;
+
+        array_view<nbt_byte> as_byte_array() const;
+        array_view<nbt_int>  as_int_array() const;
+        array_view<nbt_long> as_long_array() const;
+
+        // access tag by name (compound only), returns a Null tag if there is no such key.
+        // linear search, iterate instead when every entry is needed
+        tag_view at(std::string_view key) const;
+        bool has_key(std::string_view key) const;
+        bool has_key(std::string_view key, tag_type type) const;
+
+        // element type (list only)
+        tag_type el_type() const;
+        // number of elements (list and arrays only)
+        size_t size() const;
+        // access tag by index (list only), O(1) for fixed-size element types
+        tag_view operator[](size_t i) const;
+
+        // iterate the entries of a compound
+        iterator begin() const;
+        iterator end() const;
+
+        const u8* payload() const { return payload_; }
+        // pointer just past the payload, the next list element starts here
+        const u8* payload_end() const;
+        endian::endian endianness() const { return endian_; }
+
+    private:
+        tag_type type_ = tag_type::Null;
+        const u8* payload_ = nullptr;
+        endian::endian endian_ = endian::default_endian;
+    };
+
+    // named tag inside a compound
+    struct tag_view::entry {
+        std::string_view name;
+        tag_view value;
+    };
+
+    class tag_view::iterator {
+    public:
+        iterator() noexcept {}
+        iterator(const u8* pos, endian::endian e);
+
+        const entry& operator*() const { return current_; }
+        const entry* operator->() const { return &current_; }
+        iterator& operator++();
+
+        bool operator==(const iterator& rhs) const { return pos_ == rhs.pos_; }
+        bool operator!=(const iterator& rhs) const { return pos_ != rhs.pos_; }
+
+    private:
+        void parse();
+
+        const u8* pos_ = nullptr; // type byte of the current entry, nullptr at the end
+        endian::endian endian_ = endian::default_endian;
+        entry current_;
+    };
+
+    // memory-mapped .nbt file, read in place without building a tag tree.
+    // names and strings come back as string_views and arrays as array_views into the file.
+    // a compressed (0.2) file is unpacked into one buffer on open and viewed there instead.
+    class view {
+    public:
+        view() noexcept {}
+
+        // map the file, check the header and walk the tree once to validate it
+        bool open(const std::string& filename);
+        void close();
+
+        nbt_byte version_major() const { return major_; }
+        nbt_byte version_minor() const { return minor_; }
+        endian::endian endianness() const { return endian_; }
+
+        // name and payload of the root compound
+        std::string_view name() const { return name_; }
+        const tag_view& root() const { return root_; }
+
+        // whole mapped file, already closed if the body was compressed
+        const mapped_file& file() const { return file_; }
+
+    private:
+        mapped_file file_;
+        std::vector<u8> unpacked_;
+        nbt_byte major_ = 0, minor_ = 0;
+        endian::endian endian_ = endian::default_endian;
+        std::string_view name_;
+        tag_view root_;
+    };
+
+    // Safe/guaranteed access of compounds
+    std::string SafeGetString(const tag_view& comp, std::string_view key, const std::string& fallback);
+    laml::Vec3 SafeGetVec3(const tag_view& comp, std::string_view key, const laml::Vec3& fallback);
+    float SafeGetFloat(const tag_view& comp, std::string_view key, float fallback);
+}
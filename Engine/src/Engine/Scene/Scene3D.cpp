@@ -126,6 +126,8 @@ namespace rh {
     void Scene3D::OnUpdate(double dt) {
         BENCHMARK_FUNCTION();
         if (m_Playing) {
+            m_cWorld.Update(dt);
+
             BENCHMARK_SCOPE("Update Scripts");
             // Update scripts
             auto script_view = m_Registry.view<NativeScriptComponent>();
@@ -139,13 +141,15 @@ namespace rh {
                 }
             }
 
-            // Loop through all animated meshes and update their animations
+            // Loop through all animated meshes and update their animations.
+            // Entities share meshes, the frame index makes each one advance only once
+            m_UpdateFrame++;
             auto mesh_view = m_Registry.view<MeshRendererComponent>();
             for (auto entity : mesh_view) {
                 auto &mesh = mesh_view.get<MeshRendererComponent>(entity);
 
                 if (mesh.MeshPtr) {
-                    mesh.MeshPtr->OnUpdate(dt);
+                    mesh.MeshPtr->OnUpdate((float)dt, m_UpdateFrame);
                 }
             }
         }
@@ -215,8 +219,6 @@ namespace rh {
             BENCHMARK_SCOPE("Render");
             Renderer::Begin3DScene(*mainCamera, *mainTransform, numPointLight, scenePointLights, numSpotLight, sceneSpotLights, sceneSun);
 
-            Renderer::BeginDeferredPrepass();
-
             auto group = m_Registry.group<MeshRendererComponent>(entt::get<TransformComponent>);
             for (auto entity : group) {
                 auto[trans, mesh] = group.get<TransformComponent, MeshRendererComponent>(entity);
@@ -226,23 +228,31 @@ namespace rh {
                 }
             }
 
+            Renderer::BeginDeferredPrepass();
             Renderer::EndDeferredPrepass();
 
+            // Nothing is outlined right now, but End3DScene mixes in the Sobel output
             Renderer::BeginSobelPass();
-            // Render collision hulls
+            Renderer::EndSobelPass();
+
+            // Render collision hulls, and the broadphase bounds of the moving ones
             if (m_showCollisionHulls) {
-                for (const auto& hull : m_cWorld.m_static) {
+                for (auto& hull : m_cWorld.m_static) {
                     laml::Mat4 transform;
                     laml::transform::create_transform(transform, hull.rotation, hull.position);
-                    Renderer::Submit(hull.wireframe, transform, laml::Vec3(1, .05, .1));
+                    const auto& faces = hull.shape->faces;
+                    Renderer::SubmitWireframe(hull.shape->vertices.data(), reinterpret_cast<const u16*>(faces.data()), (u32)faces.size(), transform, laml::Vec4(1, .05, .1, 1), true);
                 }
-                for (const auto& hull : m_cWorld.m_dynamic) {
+                for (auto& hull : m_cWorld.m_dynamic) {
                     laml::Mat4 transform;
                     laml::transform::create_transform(transform, hull.rotation, hull.position);
-                    Renderer::Submit(hull.wireframe, transform, laml::Vec3(.1, .05, 1));
+                    const auto& faces = hull.shape->faces;
+                    Renderer::SubmitWireframe(hull.shape->vertices.data(), reinterpret_cast<const u16*>(faces.data()), (u32)faces.size(), transform, laml::Vec4(.1, .05, 1, 1), true);
+
+                    const AABB& box = hull.GetWorldAABB();
+                    Renderer::SubmitAABB(box.lowerBound, box.upperBound, laml::Vec4(.1, .8, .3, 1));
                 }
             }
-            Renderer::EndSobelPass();
 
             Renderer::End3DScene();
 
@@ -250,6 +260,12 @@ namespace rh {
             if (m_showEntityLocations) { // TODO: rename this/come up with less bad solution for these things
                 TextRenderer::SubmitText("Showing entity locations", 5, 40, laml::Vec3(.7, .1, .5));
             }
+            if (m_showCollisionHulls) {
+                const auto& stats = m_cWorld.GetShapecastStats();
+                char text[64];
+                sprintf_s(text, 64, "TOI solves: %u, skipped: %u, substeps: %d", stats.toiSolves, stats.toiSkipped, m_cWorld.GetSubstepCount());
+                TextRenderer::SubmitText(text, 5, 60, laml::Vec3(.7, .1, .5));
+            }
 
             // draw coordinate frames
             Renderer::SubmitLine(laml::Vec3(), laml::Vec3(1, 0, 0), laml::Vec4(1, 0, 0, 1));
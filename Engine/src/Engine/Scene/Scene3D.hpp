@@ -41,6 +41,7 @@ namespace rh {
         entt::registry m_Registry;
         CollisionWorld m_cWorld;
         u32 m_ViewportWidth = 0, m_ViewportHeight = 0;
+        u64 m_UpdateFrame = 0;
 
         bool m_Playing = false;
         bool m_showEntityLocations = false;
@@ -28,15 +28,36 @@ namespace rh {
             hull_offset = laml::Vec3(0.0f, 0.5f, 0.0f);
             m_floorAngleLimit = 35;
 
+            if (BeingControlled)
+                AddToWorld();
+
             LOG_INFO("Player controller created on GameObject {0}!", GetGameObjectID());
         }
 
         void ToggleControl() {
             BeingControlled = !BeingControlled;
-            if (BeingControlled)
+            if (BeingControlled) {
+                AddToWorld();
                 LOG_INFO("PlayerController now in control");
-            else
+            }
+            else {
+                // the collision world stops stepping us until control comes back
+                cWorld->RemoveCharacter(colliderComponent->HullID);
                 LOG_INFO("PlayerController no longer in control");
+            }
+        }
+
+        void AddToWorld() {
+            CharacterMotion motion;
+            motion.hullID = colliderComponent->HullID;
+            motion.hullOffset = hull_offset;
+            motion.floorAngleLimit = m_floorAngleLimit;
+            motion.position = position;
+            motion.velocity = laml::Vec3(0.0f, 0.0f, 0.0f);
+            motion.grounded = grounded;
+            motion.floorUp = m_floorUp;
+            motion.floorID = m_floorID;
+            cWorld->AddCharacter(motion);
         }
 
         void RotateCharacter(double ts) {
@@ -94,114 +115,31 @@ namespace rh {
             if (BeingControlled) {
                 BENCHMARK_FUNCTION();
 
-                velocity = GenerateDesiredMovement();
-                RotateCharacter(ts);
+                // The collision world has already stepped us for this frame
+                CharacterMotion* motion = cWorld->GetCharacter(colliderComponent->HullID);
+                LOG_ASSERT(motion, "PlayerController is not registered with the Collision World");
 
-                auto collisionHullID = colliderComponent->HullID;
-                if (grounded) {
-                    // Raycast down to see if there is anything beneath us
-                    // TODO: Cache the currect collisionID of the ground and check against that.
-                    RaycastResult rc = cWorld->Raycast(position + hull_offset, Vec3(0.0f, -1.0f, 0.0f), .6);
-
-                    if (rc.colliderID == 0) {
-                        // no ground beneath me
-                        grounded = false;
-                        m_floorUp = Vec3(0.0f, 1.0f, 0.0f);
-                        m_floorID = 0;
-                    }
-                    else {
-                        m_floorID = rc.colliderID;
-                    }
-                }
-                else {
-                    velocity.y -= 9.8 * ts;
-                }
+                velocity = motion->velocity;
+                grounded = motion->grounded;
+                m_floorUp = motion->floorUp;
+                m_floorID = motion->floorID;
+                ghostPosition = motion->ghostPosition;
+                position = cWorld->GetInterpolatedPosition(colliderComponent->HullID);
 
-                int iterations = 0;
-                // Perform collision logic
-                if (collisionHullID > 0) {
-                    // it has collision info
-                    res = cWorld->Shapecast_multi(collisionHullID, velocity);
-
-                    if (res.numContacts) {
-                        Vec3 p_target = position + velocity * static_cast<float>(ts);
-                        Vec3 p = p_target;
-                        Vec3 p_start = position;
-                        ghostPosition = position + (velocity*res.planes[0].TOI);
-
-                        for (iterations = 0; iterations < 8; iterations++) {
-                            float errorAcc = 0;
-                            for (int n = 0; n < res.numContacts; n++) {
-                                auto plane = &res.planes[n];
-
-                                if (plane->TOI < ts) {
-                                    Vec3 contactPoint = plane->contact_point;
-                                    Vec3 contactNormal = plane->contact_normal;
-
-                                    Vec3 p_t;
-                                    if (n > 0) {
-                                        p_t = p_start + velocity * (plane->TOI - res.planes[n - 1].TOI);
-                                    }
-                                    else {
-                                        p_t = p_start + velocity * plane->TOI;
-                                    }
-                                    Vec3 body2contact = contactPoint - p_t;
-
-                                    Vec3 sv = ((p + body2contact) - contactPoint);
-                                    float s = dot((p + body2contact) - contactPoint, contactNormal);
-                                    if (s < 0) {
-                                        errorAcc -= s;
-
-                                        p = p - (s - 1.0e-3f)*contactNormal;
-
-                                        if (acos(dot(contactNormal, Vec3(0.0f, 1.0f, 0.0f))) < (m_floorAngleLimit * constants::deg2rad)) {
-                                            grounded = true;
-                                            velocity.y = 0;
-
-                                            // this isn't the normal of the surface, 
-                                            // so it might not be ideal for the floor normal
-                                            m_floorUp = plane->contact_normal;
-                                            m_floorID = plane->colliderID;
-                                            // play sound?
-                                            SoundEngine::CueSound("golem", position);
-                                        }
-                                    }
-                                }
-                            }
-                            float eps = 1e-9;
-                            if (errorAcc < eps) {
-                                // We went through en entire iteration without moving 
-                                // the object, we can stop iterating now.
-                                break;
-                            }
-                            p_start = p;
-                        }
-
-                        position = p;
-                    }
-                    else {
-                        position = position + velocity * static_cast<float>(ts);
-                        ghostPosition = position;
-                    }
-
-                    CollisionHull* hull = cWorld->getHullFromID(collisionHullID);
-                    hull->position = position + hull_offset;
-
-                    // TODO: Expand the ShapeCast function to allow for rotation
-                    //hull->rotation.toYawPitchRoll(YawPitchRoll.x, 0, 0);
-                }
-                else {
-                    // Just use normal movement.
-                    position = position + velocity * static_cast<float>(ts);
-                    ghostPosition = position;
+                if (motion->hitFloor) {
+                    // play sound?
+                    SoundEngine::CueSound("golem", position);
                 }
 
-                if (grounded) {
-                    velocity = Vec3(0.0f, 0.0f, 0.0f);
-                }
-                else {
-                    //velocity = vec3(0, velocity.y, 0);
-                }
+                velocity = GenerateDesiredMovement();
+                RotateCharacter(ts);
+
+                // picked up by the next fixed steps
+                // TODO: Expand the ShapeCast function to allow for rotation
+                //hull->rotation.toYawPitchRoll(YawPitchRoll.x, 0, 0);
+                motion->velocity = velocity;
+                motion->grounded = grounded;
+                motion->floorUp = m_floorUp;
 
                 auto& transform = transformComponent->Transform;
                 laml::transform::create_transform(transform, yaw, pitch, 0.0f, position, scale);
@@ -249,9 +187,6 @@ namespace rh {
         float jumpPower = 5.5f;
         float rotSpeed = 360.0f;
         float m_floorAngleLimit = 35;
-
-
-        ShapecastResult_multi res;
     };
 
 }
\ No newline at end of file
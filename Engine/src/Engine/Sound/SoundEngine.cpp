@@ -131,20 +131,25 @@ namespace rh {
         s_SoundData.stream->UpdateStream(dt);
     }
 
+    // no stream when Init was never called, e.g. a Scene3D run by RunNullRendererBenchmark
     void SoundEngine::StartStream() {
-        s_SoundData.stream->StartStream();
+        if (s_SoundData.stream)
+            s_SoundData.stream->StartStream();
     }
 
     void SoundEngine::StopStream() {
-        s_SoundData.stream->StopStream();
+        if (s_SoundData.stream)
+            s_SoundData.stream->StopStream();
     }
 
     void SoundEngine::PauseStream() {
-        s_SoundData.stream->PauseStream();
+        if (s_SoundData.stream)
+            s_SoundData.stream->PauseStream();
     }
 
     void SoundEngine::ResumeStream() {
-        s_SoundData.stream->ResumeStream();
+        if (s_SoundData.stream)
+            s_SoundData.stream->ResumeStream();
     }
 
     bool LoadSound(const std::string& filename) {
@@ -6,7 +6,13 @@ layout (location = 1) in vec2 a_TexCoord;
 out vec2 texcoord;
 out vec3 viewRay;
 
-uniform mat4 r_Projection;
+// per-frame camera, shared by every shader (CameraBlock in Renderer.cpp)
+layout (std140, binding = 0) uniform CameraData {
+    mat4 r_Projection;
+    mat4 r_View;
+    mat4 r_VP;
+    vec4 r_CamPos;
+};
 
 void main() {
     vec4 position = vec4(a_Position.xy, 1.0, 1.0);
@@ -24,21 +30,35 @@ layout (location = 1) out vec4 out_Specular;
 in vec2 texcoord;
 in vec3 viewRay;
 
+// std140: the padding keeps each vec3 on its own 16 bytes (LightBlockEntry in Renderer.cpp)
 struct Light {
 	vec3 Position;
+	float _pad0;
 	vec3 Direction;
+	float _pad1;
 	vec3 Color;
 	float Strength;
 	float Inner;
 	float Outer;
+	vec2 _pad2;
 };
 
 const int MAX_LIGHTS = 32;
-uniform Light r_pointLights[MAX_LIGHTS];
-uniform Light r_spotLights[MAX_LIGHTS];
-uniform Light r_sun;
+layout (std140, binding = 1) uniform LightData {
+	Light r_pointLights[MAX_LIGHTS];
+	Light r_spotLights[MAX_LIGHTS];
+	Light r_sun;
+	int r_NumPointLights;
+	int r_NumSpotLights;
+};
 
-uniform mat4 r_View;
+// per-frame camera, shared by every shader (CameraBlock in Renderer.cpp)
+layout (std140, binding = 0) uniform CameraData {
+    mat4 r_Projection;
+    mat4 r_View;
+    mat4 r_VP;
+    vec4 r_CamPos;
+};
 
 uniform sampler2D u_normal;
 uniform sampler2D u_distance;
@@ -238,12 +258,12 @@ void Lighting(vec3 F0) {
 	CalcSunDiffuse(F0);
 
 	// add up all point lights
-	for(int i = 0; i < MAX_LIGHTS; i++) {
+	for(int i = 0; i < r_NumPointLights; i++) {
 		CalcPointLightDiffuse(F0, r_pointLights[i]);
 	}
 	
 	// add up all spot lights
-	for(int i = 0; i < MAX_LIGHTS; i++) {
+	for(int i = 0; i < r_NumSpotLights; i++) {
 		CalcSpotLightDiffuse(F0, r_spotLights[i]);
 	}
 }
@@ -3,7 +3,14 @@
 
 layout (location = 0) in vec3 a_Position;
 
-uniform mat4 r_VP;
+// per-frame camera, shared by every shader (CameraBlock in Renderer.cpp)
+layout (std140, binding = 0) uniform CameraData {
+    mat4 r_Projection;
+    mat4 r_View;
+    mat4 r_VP;
+    vec4 r_CamPos;
+};
+
 uniform mat4 r_Transform;
 
 out VertexOutput {
@@ -28,12 +35,32 @@ in VertexOutput {
 	vec2 tex_coord;
 } vs_Input;
 
-uniform vec3 r_CamPos;
+// per-frame camera, shared by every shader (CameraBlock in Renderer.cpp)
+layout (std140, binding = 0) uniform CameraData {
+    mat4 r_Projection;
+    mat4 r_View;
+    mat4 r_VP;
+    vec4 r_CamPos;
+};
+
+// per-frame render settings (SettingsBlock in Renderer.cpp)
+layout (std140, binding = 2) uniform RenderSettings {
+    float r_AlbedoTexToggle;
+    float r_NormalTexToggle;
+    float r_MetalnessTexToggle;
+    float r_RoughnessTexToggle;
+    float r_AmbientTexToggle;
+    float r_EmissiveTexToggle;
+    float r_gammaCorrect;
+    float r_toneMap;
+    int r_outputSwitch;
+    float r_LineFadeStart;
+    float r_LineFadeEnd;
+    float r_LineFadeMaximum;
+    float r_LineFadeMinimum;
+};
+
 uniform vec3 r_LineColor;
-uniform float r_LineFadeStart;
-uniform float r_LineFadeEnd;
-uniform float r_LineFadeMaximum;
-uniform float r_LineFadeMinimum;
 
 //const mat4 ditherPattern = mat4(
 //    vec4( 0.0f, 0.5f, 0.125f, 0.625f),
@@ -44,7 +71,7 @@ uniform float r_LineFadeMinimum;
 void main()
 {
 	float start = r_LineFadeStart, end = r_LineFadeEnd;
-	float distance = length(r_CamPos - vs_Input.WorldPos);
+	float distance = length(r_CamPos.xyz - vs_Input.WorldPos);
 	float strength = min(max((end-distance)/(end-start), r_LineFadeMinimum), r_LineFadeMaximum);
 
 	//int screenX = int(vs_Input.tex_coord.x * 1280 * 4.0f);
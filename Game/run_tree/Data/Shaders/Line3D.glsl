@@ -1,22 +1,43 @@
 #type vertex
-#version 330 core
-layout (location = 0) in float a_Position;
+#version 430 core
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec4 a_Color;
 
-uniform vec3 r_verts[2];
+// per-frame camera, shared by every shader (CameraBlock in Renderer.cpp)
+layout (std140, binding = 0) uniform CameraData {
+    mat4 r_Projection;
+    mat4 r_View;
+    mat4 r_VP;
+    vec4 r_CamPos;
+};
 
-uniform mat4 r_View;
-uniform mat4 r_Projection;
+out vec4 pass_color;
+out vec3 pass_viewPos;
 
 void main() {
-    gl_Position = r_Projection * r_View * vec4(r_verts[gl_VertexID], 1.0);
+    vec4 viewPos = r_View * vec4(a_Position, 1.0);
+    pass_color = a_Color;
+    pass_viewPos = viewPos.xyz;
+    gl_Position = r_Projection * viewPos;
 }
 
 #type fragment
-#version 330 core
+#version 430 core
+in vec4 pass_color;
+in vec3 pass_viewPos;
+
 out vec4 FragColor;
 
-uniform vec4 r_Color;
+// view-space distance of the 3D scene, from the gBuffer
+uniform sampler2D u_distance;
+uniform int r_depthTest;
 
 void main() {
-    FragColor = r_Color;
-}
\ No newline at end of file
+    if (r_depthTest != 0) {
+        vec2 texcoord = gl_FragCoord.xy / vec2(textureSize(u_distance, 0));
+        if (length(pass_viewPos) > texture(u_distance, texcoord).r + 0.01)
+            discard;
+    }
+
+    FragColor = pass_color;
+}
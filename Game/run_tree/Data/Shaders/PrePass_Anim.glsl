@@ -9,14 +9,24 @@ layout (location = 4) in vec2 a_TexCoord;
 layout (location = 5) in ivec4 a_BoneIndices;
 layout (location = 6) in vec4 a_BoneWeights;
 
+// skinning palette of the mesh being drawn (BoneBlock in Renderer.cpp)
 const int MAX_BONES = 128;
-uniform mat4 r_Bones[MAX_BONES];
-
-// can combine these two into ModelView matrix
-uniform mat4 r_Transform;
-uniform mat4 r_View;
-
-uniform mat4 r_Projection;
+layout (std140, binding = 4) uniform BoneData {
+    mat4 r_Bones[MAX_BONES];
+};
+
+// model matrix of the current draw, a range of the per-object ring (ObjectBlock in Renderer.cpp)
+layout (std140, binding = 3) uniform ObjectData {
+    mat4 r_Transform;
+};
+
+// per-frame camera, shared by every shader (CameraBlock in Renderer.cpp)
+layout (std140, binding = 0) uniform CameraData {
+    mat4 r_Projection;
+    mat4 r_View;
+    mat4 r_VP;
+    vec4 r_CamPos;
+};
 
 out VertexOutput { // all in view-space
     vec3 Position;
@@ -76,14 +86,22 @@ uniform float u_Metalness;
 uniform float u_Roughness;
 uniform float u_TextureScale;
 
-// Toggles
-uniform float r_AlbedoTexToggle;
-uniform float r_NormalTexToggle;
-uniform float r_MetalnessTexToggle;
-uniform float r_RoughnessTexToggle;
-uniform float r_AmbientTexToggle;
-uniform float r_EmissiveTexToggle;
-uniform float r_gammaCorrect;
+// per-frame render settings (SettingsBlock in Renderer.cpp)
+layout (std140, binding = 2) uniform RenderSettings {
+    float r_AlbedoTexToggle;
+    float r_NormalTexToggle;
+    float r_MetalnessTexToggle;
+    float r_RoughnessTexToggle;
+    float r_AmbientTexToggle;
+    float r_EmissiveTexToggle;
+    float r_gammaCorrect;
+    float r_toneMap;
+    int r_outputSwitch;
+    float r_LineFadeStart;
+    float r_LineFadeEnd;
+    float r_LineFadeMaximum;
+    float r_LineFadeMinimum;
+};
 
 float linearize_depth(float d,float zNear,float zFar)
 {
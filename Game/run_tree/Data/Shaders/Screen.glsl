@@ -27,9 +27,22 @@ uniform sampler2D u_specular;
 uniform sampler2D u_emissive;
 uniform sampler2D u_ssao;
 
-uniform int r_outputSwitch;
-uniform float r_toneMap;
-uniform float r_gammaCorrect;
+// per-frame render settings (SettingsBlock in Renderer.cpp)
+layout (std140, binding = 2) uniform RenderSettings {
+    float r_AlbedoTexToggle;
+    float r_NormalTexToggle;
+    float r_MetalnessTexToggle;
+    float r_RoughnessTexToggle;
+    float r_AmbientTexToggle;
+    float r_EmissiveTexToggle;
+    float r_gammaCorrect;
+    float r_toneMap;
+    int r_outputSwitch;
+    float r_LineFadeStart;
+    float r_LineFadeEnd;
+    float r_LineFadeMaximum;
+    float r_LineFadeMinimum;
+};
 
 float makeDepthPretty(float d);
 vec3 ToneMap(vec3 colorIn);
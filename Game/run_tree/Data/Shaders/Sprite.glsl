@@ -1,23 +1,24 @@
 #type vertex
 #version 330 core
 layout (location = 0) in vec2 a_Position;
+layout (location = 1) in vec2 a_TexCoord;
+layout (location = 2) in vec4 a_Color;
+layout (location = 3) in float a_TexIndex;
 
 out vec2 pass_uv;
-
-uniform vec4 r_transform;
-uniform vec4 r_transformUV;
+out vec4 pass_color;
+flat out int pass_texIndex;
 
 uniform mat4 r_orthoProjection;
 
 void main() {
-
-    vec2 newPos = vec2(r_transform.x   * a_Position.x, r_transform.y   * a_Position.y) + r_transform.zw;
-    vec2 newUV  = vec2(r_transformUV.x * a_Position.x, r_transformUV.y * (1-a_Position.y)) + vec2(r_transformUV.z, r_transformUV.w);
-
-    vec4 pos = r_orthoProjection * vec4(newPos.x, newPos.y, -1.0, 1.0);
+    // quads are built in screen pixels on the CPU
+    vec4 pos = r_orthoProjection * vec4(a_Position.x, a_Position.y, -1.0, 1.0);
 
     gl_Position = pos;
-    pass_uv = newUV;
+    pass_uv = a_TexCoord;
+    pass_color = a_Color;
+    pass_texIndex = int(a_TexIndex);
 }
 
 #type fragment
@@ -25,12 +26,37 @@ void main() {
 out vec4 FragColor;
 
 in vec2 pass_uv;
-
-uniform sampler2D r_spriteTex;
-uniform vec3 r_textColor;
+in vec4 pass_color;
+flat in int pass_texIndex;
+
+// size has to match MAX_SPRITE_TEXTURE_SLOTS in SpriteRenderer.cpp
+uniform sampler2D r_spriteTex[16];
+
+// sampler arrays can only be indexed with constants here
+vec4 SampleSprite(int index, vec2 uv) {
+    switch (index) {
+        case 0: return texture(r_spriteTex[0], uv);
+        case 1: return texture(r_spriteTex[1], uv);
+        case 2: return texture(r_spriteTex[2], uv);
+        case 3: return texture(r_spriteTex[3], uv);
+        case 4: return texture(r_spriteTex[4], uv);
+        case 5: return texture(r_spriteTex[5], uv);
+        case 6: return texture(r_spriteTex[6], uv);
+        case 7: return texture(r_spriteTex[7], uv);
+        case 8: return texture(r_spriteTex[8], uv);
+        case 9: return texture(r_spriteTex[9], uv);
+        case 10: return texture(r_spriteTex[10], uv);
+        case 11: return texture(r_spriteTex[11], uv);
+        case 12: return texture(r_spriteTex[12], uv);
+        case 13: return texture(r_spriteTex[13], uv);
+        case 14: return texture(r_spriteTex[14], uv);
+        case 15: return texture(r_spriteTex[15], uv);
+    }
+    return vec4(1.0); // untextured (lines)
+}
 
 void main() {
-    vec4 frag = texture(r_spriteTex, pass_uv);
+    vec4 frag = SampleSprite(pass_texIndex, pass_uv);
 
-    FragColor = frag * vec4(r_textColor,1);
+    FragColor = frag * pass_color;
 }
\ No newline at end of file
@@ -80,11 +80,11 @@ void MainMenuScene::OnUpdate(rh::Timestep ts) {
         y += 32;
     }
 
-    // Draw other sprites
+    // Draw cursor on top of the menu text
     auto[mx, my] = rh::Input::GetMousePosition();
     src = { 0, 0, 1, 1 };
     dst = { mx, my, mx+16, my+16 };
-    rh::SpriteRenderer::SubmitSprite("Data/Images/frog.png", &dst, &src, rh::ALIGN_MID_MID);
+    rh::SpriteRenderer::SubmitSprite("Data/Images/frog.png", &dst, &src, rh::ALIGN_MID_MID, rh::SPRITE_LAYER_OVERLAY);
 }
 
 void MainMenuScene::OnEvent(rh::Event& event) {
@@ -1,5 +1,6 @@
 //#define RUN_TEST_CODE
 //#define RUN_MATERIAL_CODE
+//#define RUN_BENCHMARK_CODE
 
 #ifndef RUN_TEST_CODE
 #include <Engine.hpp>
@@ -41,7 +42,7 @@ rh::Application* rh::CreateApplication() {
 #endif
 
 #ifdef RUN_TEST_CODE
-#ifndef RUN_MATERIAL_CODE
+#if !defined(RUN_MATERIAL_CODE) && !defined(RUN_BENCHMARK_CODE)
 
 #include "Engine/Core/Base.hpp"
 #include "Engine.hpp"
@@ -82,6 +83,34 @@ int main(int argc, char** argv) {
 
 #endif
 
+#ifdef RUN_BENCHMARK_CODE
+#include "Engine/Core/Base.hpp"
+#include "Engine.hpp"
+#include "Engine/Collision/CollisionBenchmark.hpp"
+#include "Engine/Renderer/RenderQueueTest.hpp"
+#include "Engine/Renderer/RendererBenchmark.hpp"
+
+int main(int argc, char** argv) {
+    rh::Logger::Init();
+
+    rh::RunCollisionBenchmark();
+    rh::RunRayTriangleBenchmark();
+    rh::RunRaycastBatchBenchmark();
+    rh::RunSupportBenchmark();
+    rh::RunGJKCacheBenchmark();
+    rh::RunCharacterBenchmark();
+    rh::RunFixedStepBenchmark();
+    rh::RunSnapshotBenchmark();
+
+    rh::renderQueueTest::RunAll();
+    rh::RunNullRendererBenchmark();
+    rh::RunTextLayoutBenchmark();
+
+    //system("pause");
+    return 0;
+}
+#endif
+
 #ifdef RUN_MATERIAL_CODE
 #include <stdlib.h>
 #include "Engine/Sound/SoundEngine.hpp"
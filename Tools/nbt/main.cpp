@@ -8,6 +8,7 @@ namespace fs = std::experimental::filesystem;
 enum class operation : int {
     list = 0,
     merge,
+    compress,
     help
 };
 struct script_options {
@@ -19,6 +20,7 @@ struct script_options {
 script_options parseArguments(int argc, char** argv);
 void list(script_options& opts);
 void merge(script_options& opts);
+void compress(script_options& opts);
 
 int main(int argc, char** argv) {
     auto opts = parseArguments(argc, argv);
@@ -52,6 +54,7 @@ int main(int argc, char** argv) {
         std::cout << "operations:     -h              Show this help message." << std::endl;
         std::cout << "                -merge          Merge .nbt files together." << std::endl;
         std::cout << "                -l              List all .nbt files in specified directory." << std::endl;
+        std::cout << "                -compress       Rewrite .nbt files in place as compressed version 0.2." << std::endl;
         std::cout << std::endl;                       
         std::cout << "optional flags: -o <filename>   Set <filename> as the output file" << std::endl;
         std::cout << "                -p <path>       Set <path> as the search path" << std::endl;
@@ -63,6 +66,9 @@ int main(int argc, char** argv) {
     case operation::merge:
         merge(opts);
         break;
+    case operation::compress:
+        compress(opts);
+        break;
     }
 
     return 0;
@@ -114,6 +120,19 @@ script_options parseArguments(int argc, char** argv) {
             }
             continue;
         }
+        if (args[n].compare("-compress") == 0) {
+            opts.op = operation::compress;
+
+            int start = n;
+            for (int i = start + 1; i < argc; i++) {
+                if (args[i][0] == '-')
+                    break;
+
+                opts.nbt_inputs.push_back(args[i]);
+                n++;
+            }
+            continue;
+        }
         if (args[n].compare("-l") == 0) {
             opts.op = operation::list;
             continue;
@@ -204,6 +223,39 @@ void merge(script_options& opts) {
     nbt::write_to_file(opts.output, ddd, version_major, version_minor, endianness);
 }
 
+void compress(script_options& opts) {
+    if (opts.op != operation::compress)
+        return;
+
+    std::cout << "Compressing " << opts.nbt_inputs.size() << " file(s)!" << std::endl;
+    std::cout << "Path: " << opts.path << std::endl;
+    if (opts.nbt_inputs.size() == 0) return;
+    if (opts.path.size() == 0) return;
+
+    for (const auto& input : opts.nbt_inputs) {
+        fs::path p = fs::absolute(opts.path) / input;
+
+        nbt::file_data data;
+        nbt::nbt_byte version_major, version_minor;
+        endian::endian endianness;
+        if (!nbt::read_from_file(p.string(), data, version_major, version_minor, endianness)) {
+            std::cout << p.filename() << " could not be read!" << std::endl;
+            continue;
+        }
+        auto raw_size = fs::file_size(p);
+
+        // keep the endianness, only the version changes
+        if (!nbt::write_to_file(p.string(), data, 0, 2, endianness)) {
+            std::cout << p.filename() << " could not be written!" << std::endl;
+            continue;
+        }
+        auto packed_size = fs::file_size(p);
+
+        std::cout << p.filename() << ": version " << (int)version_major << "." << (int)version_minor << " -> 0.2, "
+            << raw_size << " -> " << packed_size << " bytes" << std::endl;
+    }
+}
+
 void list(script_options& opts) {
     std::string fullpath = fs::absolute(opts.path).string();
     std::cout << "Listing all files on path: <" << fullpath << ">:\n" << std::endl;